@@ -240,7 +240,7 @@ int main (int argc, char** argv)
     gsBucklingSolver<real_t> solver(K_L,K_NL);
     solver.setOptions(BucklingOptions);
 
-    gsStatus status = solver.computeSparse(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
+    gsStatus status = solver.compute(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
 
     GISMO_ENSURE(status == gsStatus::Success,"Buckling solver failed");
 
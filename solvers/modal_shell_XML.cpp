@@ -245,7 +245,7 @@ int main (int argc, char** argv)
     // buckling.options().setInt("ncvFac",2);
     // buckling.options().setInt("shift",0.1);
 
-    gsStatus status = solver.computeSparse(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
+    gsStatus status = solver.compute(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
 
     GISMO_ENSURE(status == gsStatus::Success,"Modal solver failed");
 
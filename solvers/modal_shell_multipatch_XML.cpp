@@ -70,6 +70,9 @@ int main (int argc, char** argv)
 
     index_t nmodes = 1;
 
+    index_t slices = 0;
+    real_t lower = 0, upper = 0;
+
     std::string wn("data.csv");
 
     gsCmdLine cmd("Shell modal solver for multi-patches.");
@@ -86,6 +89,9 @@ int main (int argc, char** argv)
     cmd.addString("o","outputDir", "Output directory", dirname);
 
     cmd.addInt( "N", "nmodes", "Number of modes",  nmodes );
+    cmd.addInt( "S", "slices", "Number of spectrum slices. If positive, all eigenvalues in [lower,upper] are computed",  slices );
+    cmd.addReal( "", "lower", "Lower bound of the eigenvalues for spectrum slicing",  lower );
+    cmd.addReal( "", "upper", "Upper bound of the eigenvalues for spectrum slicing",  upper );
 
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
@@ -286,7 +292,11 @@ int main (int argc, char** argv)
     // buckling.options().setInt("ncvFac",2);
     // buckling.options().setInt("shift",0.1);
 
-    gsStatus status = solver.computeSparse(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
+    gsStatus status;
+    if (slices > 0)
+        status = solver.computeSlicing(lower,upper,slices);
+    else
+        status = solver.compute(nmodes);//,2,Spectra::SortRule::LargestMagn,Spectra::SortRule::SmallestMagn);
 
     GISMO_ENSURE(status == gsStatus::Success,"Modal solver failed");
 
@@ -294,7 +304,7 @@ int main (int argc, char** argv)
     gsMatrix<> vectors = solver.vectors();
 
     gsInfo<< "First 10 eigenvalues:\n";
-    for (index_t k = 0; k<10; k++)
+    for (index_t k = 0; k<std::min<index_t>(10,values.rows()); k++)
         gsInfo<<"\t"<<std::setprecision(20)<<values.at(k)<<"\n";
     gsInfo<<"\n";
 
@@ -306,7 +316,7 @@ int main (int argc, char** argv)
 
         int N = 1;
         // if (!first)
-          N = nmodes;
+          N = std::min<index_t>(nmodes,vectors.cols());
         //    N = vectors.cols();
         for (index_t m=0; m<N; m++)
         {
@@ -24,6 +24,8 @@
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticComposite.h>
 
 #include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisUtils.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisCache.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSparsityPattern.h>
 
 #ifdef gsUnstructuredSplines_ENABLED
 #include <gsUnstructuredSplines/src/gsSmoothInterfaces.h>
@@ -313,39 +315,42 @@ int main (int argc, char** argv)
     assembler->assembleMass(true);
     gsVector<> M = assembler->rhs();
 
-    gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian;
-    gsStructuralAnalysisOps<real_t>::Residual_t Residual;
-    // Function for the Jacobian
-    Jacobian = [&assembler,&bb2,&geom](gsVector<real_t> const &x, gsSparseMatrix<real_t> & m)
+    // The deformed geometry is memoised, such that it is shared by the residual and the Jacobian on the same solution
+    struct Deformation
+    {
+      Deformation(const gsMappedBasis<2,real_t> & basis, const gsMatrix<real_t> & coefs, const gsMultiPatch<real_t> & geometry)
+      : mspline(basis,coefs), def(&geometry,&mspline) { }
+      gsMappedSpline<2,real_t> mspline;
+      gsFunctionSum<real_t> def;
+    };
+    gsStructuralAnalysisCache<real_t,Deformation> cache([&assembler,&bb2,&geom](gsVector<real_t> const &x)
     {
-      ThinShellAssemblerStatus status;
       gsMatrix<real_t> solFull = assembler->fullSolutionVector(x);
       size_t d = geom.targetDim();
       GISMO_ASSERT(solFull.rows() % d==0,"Rows of the solution vector does not match the number of control points");
       solFull.resize(solFull.rows()/d,d);
-      gsMappedSpline<2,real_t> mspline(bb2,solFull);
-      gsFunctionSum<real_t> def(&geom,&mspline);
-      assembler->assembleMatrix(def);
-      status = assembler->assembleMatrix(def);
-      m = assembler->matrix();
+      return memory::make_shared(new Deformation(bb2,solFull,geom));
+    });
+
+    gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian;
+    gsStructuralAnalysisOps<real_t>::Residual_t Residual;
+    // Function for the Jacobian
+    Jacobian = cache.jacobian([&assembler,&cache](gsVector<real_t> const &x, gsSparseMatrix<real_t> & m)
+    {
+      ThinShellAssemblerStatus status;
+      status = assembler->assembleMatrix(cache.state(x).def);
+      // Keeps the memory of m when its pattern does not change (option PatternStable of the solver)
+      gsSparsityPattern<real_t>::overwriteValues(assembler->matrix(),m);
       return status == ThinShellAssemblerStatus::Success;
-    };
+    });
     // Function for the Residual
-    Residual = [&assembler,&bb2,&geom](gsVector<real_t> const &x, gsVector<real_t> & result)
+    Residual = cache.residual([&assembler,&cache](gsVector<real_t> const &x, gsVector<real_t> & result)
     {
       ThinShellAssemblerStatus status;
-      gsMatrix<real_t> solFull = assembler->fullSolutionVector(x);
-      size_t d = geom.targetDim();
-      GISMO_ASSERT(solFull.rows() % d==0,"Rows of the solution vector does not match the number of control points");
-      solFull.resize(solFull.rows()/d,d);
-
-      gsMappedSpline<2,real_t> mspline(bb2,solFull);
-      gsFunctionSum<real_t> def(&geom,&mspline);
-
-      status = assembler->assembleVector(def);
+      status = assembler->assembleVector(cache.state(x).def);
       result = assembler->rhs(); // assembler rhs - force = Finternal
       return status == ThinShellAssemblerStatus::Success;
-    };
+    });
 
     gsStructuralAnalysisOutput<real_t> writer(dirname + sep + wn,refPoints);
     std::vector<std::string> pointheaders = {"x","y","z"};
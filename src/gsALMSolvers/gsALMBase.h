@@ -22,6 +22,10 @@
 #endif
 #include <gsIO/gsOptionList.h>
 #include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsRecyclingCG.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsParallelKernels.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSparsityPattern.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSymmetricStorage.h>
 
 namespace gismo
 {
@@ -41,6 +45,7 @@ protected:
     typedef typename gsStructuralAnalysisOps<T>::ALResidual_t    ALResidual_t;
     typedef typename gsStructuralAnalysisOps<T>::Jacobian_t      Jacobian_t;
     typedef typename gsStructuralAnalysisOps<T>::dJacobian_t     dJacobian_t;
+    typedef typename gsStructuralAnalysisOps<T>::ALResidualJacobian_t ALResidualJacobian_t;
 
 public:
 
@@ -54,13 +59,17 @@ public:
       m_forcing(Force)
     {
         m_jacobian  = Jacobian;
-        m_djacobian = [this](gsVector<T> const & x, gsVector<T> const & /*dx*/, gsSparseMatrix<T> & m) -> bool
-        {
-            return m_jacobian(x,m);
-        };
 
         // initialize variables
         m_numIterations = 0;
+        m_recycling = 0;
+        m_recyclerActive = false;
+        m_patternStable = false;
+        m_symmetric = false;
+        m_deflation = false;
+        m_speculative = false;
+        m_interrupt = nullptr;
+        m_fusedValid = false;
         this->defaultOptions();
         this->setLength(1e-2);
         m_converged = false;
@@ -83,6 +92,14 @@ public:
 
         // initialize variables
         m_numIterations = 0;
+        m_recycling = 0;
+        m_recyclerActive = false;
+        m_patternStable = false;
+        m_symmetric = false;
+        m_deflation = false;
+        m_speculative = false;
+        m_interrupt = nullptr;
+        m_fusedValid = false;
         this->defaultOptions();
         this->setLength(1e-2);
         m_converged = false;
@@ -106,6 +123,44 @@ public:
     /// Perform one arc-length step
     virtual gsStatus step();
 
+    /**
+     * @brief      Sets worker instances for speculative steps
+     *
+     * When the option 'Speculative' is enabled, \ref step performs the step
+     * with arc-lengths L, L/2, L/4, ... in parallel, where this object
+     * takes L and every worker takes one of the reduced lengths. The longest
+     * converged step is kept and the shorter trials are cancelled.
+     *
+     * The workers should be of the same type as this object and should have
+     * their own operators, since the trials call them concurrently. The
+     * options of this object are copied to the workers.
+     *
+     * @param[in]  workers  The workers
+     */
+    virtual void setWorkers(const std::vector<gsALMBase<T> *> & workers) { m_workers = workers; }
+
+    /// Returns the number of arc-lengths tried in one call of \ref step
+    virtual index_t numTrials() const { return (m_speculative && m_workers.size()!=0) ? m_workers.size() + 1 : 1; }
+
+    /// Sets a function that interrupts the iterations of a step when it returns true
+    virtual void setInterrupt(const std::function<bool()> & interrupt) { m_interrupt = interrupt; }
+
+    /**
+     * @brief      Sets an operator that computes the residual and the Jacobian in one call
+     *
+     * When set, and quasi-Newton iterations are not used, the residual is
+     * computed with this operator and the Jacobian is kept. When the Jacobian
+     * is needed on the same solution, update and load factor afterwards, the
+     * kept one is used instead of calling the Jacobian operator.
+     *
+     * @param[in]  residualJacobian  The residual and the Jacobian
+     */
+    virtual void setResidualJacobian(const ALResidualJacobian_t & residualJacobian)
+    {
+        m_residualJacobian = residualJacobian;
+        m_fusedValid = false;
+    }
+
     /// Initialize the arc-length method, computes the stability of the initial configuration if \a stability is true
     virtual void initialize(bool stability = true)
     {
@@ -279,7 +334,7 @@ protected:
      */
     virtual bool _testSingularPoint(bool jacobian=false);
 
-    /// Perform an extended system iteration
+    /// Perform an extended system iteration. The residual \a m_resVec and the factorized Jacobian \a m_jacMat should be computed on m_U+m_DeltaU
     virtual void _extendedSystemIteration();
 
     /// Returns the objective function for the bisection method given solution \a x
@@ -293,6 +348,24 @@ protected:
     /// Perform a bisection system solve to find a singular point
     virtual bool _bisectionSolve(const gsVector<T> & U, const T L, const T tol);
 
+    /// Perform a multisection solve to find a singular point, using this solver and the workers in parallel
+    virtual bool _multisectionSolve(const gsVector<T> & U, const T L, const T tol);
+
+    /// Updates the deflation vectors from the singular vector and the critical modes
+    virtual void _updateDeflation();
+
+    /// Stores the eigenvectors belonging to the \a eigenvalues with smallest magnitude as critical modes
+    virtual void _setCriticalModes(const gsVector<T> & eigenvalues, const gsMatrix<T> & eigenvectors);
+
+    /// Keeps the factorized matrix \a M if there are deflation vectors, and computes the deflation system
+    virtual void _setDeflationMatrix(const gsSparseMatrix<T> & M);
+
+    /// Computes K V and the factorization of V^T K V for the factorized matrix and the current deflation vectors
+    virtual void _computeDeflationSystem();
+
+    /// Corrects the solution \a x of the system with right-hand side \a F on the deflation vectors
+    virtual void _deflationCorrection(const gsVector<T> & F, gsVector<T> & x);
+
     /// Initialize the output for extended iterations
     virtual void _initOutputExtended();
 
@@ -306,6 +379,21 @@ protected:
     /// Implementation of step
     virtual void _step();
 
+    /// Performs \ref _step and returns the status
+    virtual gsStatus _stepStatus();
+
+    /// Returns the status belonging to the error code thrown in a step (1: not converged; 2: assembly error; 3: solver error; 4: interrupted)
+    static gsStatus _errorStatus(int errorCode);
+
+    /// Performs the step with different arc-lengths on this object and the workers in parallel
+    virtual gsStatus _speculativeStep();
+
+    /// Copies the state and the options of this object to \a worker
+    virtual void _syncWorker(gsALMBase<T> * worker);
+
+    /// Copies the state of a converged step from \a worker to this object
+    virtual void _adoptWorker(const gsALMBase<T> * worker);
+
     /// Set default options
     virtual void defaultOptions();
 
@@ -321,6 +409,24 @@ protected:
     /// Solve the system with right-hand side \a F
     virtual gsVector<T> solveSystem(const gsVector<T> & F);
 
+    /// Returns the product of the Jacobian \a K with \a x, where \a K is a stored triangle in symmetric storage
+    template<class Derived>
+    gsMatrix<T> _jacobianProduct(const gsSparseMatrix<T> & K, const gsEigen::MatrixBase<Derived> & x) const
+    {
+        if (m_symmetric)
+            return gsSymmetricStorage<T>::multiply(K,x);
+        gsMatrix<T> result = K * x;
+        return result;
+    }
+
+    /// Returns the Euclidean norm of \a x, see \ref gsParallelKernels
+    template<class Derived>
+    T _norm(const gsEigen::MatrixBase<Derived> & x) const { return m_kernels.norm(x); }
+
+    /// Returns the dot product of \a x and \a y, see \ref gsParallelKernels
+    template<class DerivedX, class DerivedY>
+    T _dot(const gsEigen::MatrixBase<DerivedX> & x, const gsEigen::MatrixBase<DerivedY> & y) const { return m_kernels.dot(x,y); }
+
     /// Compute the residual
     virtual gsVector<T> computeResidual(const gsVector<T> & U, const T & L);
     virtual void computeResidual();
@@ -328,11 +434,14 @@ protected:
     /// Compute the residual error norms
     virtual void computeResidualNorms();
 
-    /// Compute the jacobian matrix
+    /// Computes the Jacobian in \a m and factorizes it. If the pattern is stable, the operator overwrites \a m
+    virtual void _computeJacobian(const gsVector<T> & U, const gsVector<T> & dU, gsSparseMatrix<T> & m);
     virtual gsSparseMatrix<T> _computeJacobian(const gsVector<T> & U, const gsVector<T> & dU);
     virtual gsSparseMatrix<T> computeJacobian(const gsVector<T> & U, const gsVector<T> & dU);
     virtual gsSparseMatrix<T> computeJacobian(const gsVector<T> & U);
     virtual gsSparseMatrix<T> computeJacobian();
+    /// Computes the Jacobian on m_U+m_DeltaU in \a m, see \ref _computeJacobian
+    virtual void computeJacobian(gsSparseMatrix<T> & m);
 
     /// Compute the adaptive arc-length
     virtual void computeLength();
@@ -376,9 +485,54 @@ protected:
     dJacobian_t     m_djacobian;
     const ALResidual_t    m_residualFun;
     const gsVector<T>     m_forcing;
+    ALResidualJacobian_t  m_residualJacobian;
+
+    /// Jacobian computed together with the last residual, and the solution, update and load factor it belongs to
+    gsSparseMatrix<T> m_fusedJacobian;
+    gsVector<T>       m_fusedU;
+    gsVector<T>       m_fusedDeltaU;
+    T                 m_fusedL;
+    bool              m_fusedValid;
 
     mutable typename gsSparseSolver<T>::uPtr m_solver; // Cholesky by default
 
+    /// Recycling CG solver, used instead of m_solver when m_recycling > 0
+    mutable gsRecyclingCG<T> m_recycler;
+    /// Number of recycled vectors
+    index_t m_recycling;
+    /// Whether the last factorized Jacobian is solved with the recycling CG solver
+    bool m_recyclerActive;
+
+    /// Deterministic reductions for the norms and dot products
+    gsParallelKernels<T> m_kernels;
+
+    /// Whether the sparsity pattern of the Jacobian is stable, and the pattern of the last factorization
+    bool m_patternStable;
+    gsSparsityPattern<T> m_pattern;
+
+    /// Whether the Jacobian is in symmetric storage (see \ref gsSymmetricStorage), and the full matrix for solvers that do not read the stored triangle
+    bool m_symmetric;
+    gsSparseMatrix<T> m_symmetricFull;
+
+    /// Deflation of the critical modes
+    bool m_deflation;
+    index_t m_deflationModes;
+    index_t m_deflationIts;
+    /// Eigenvectors of the Jacobian with the smallest eigenvalues in magnitude
+    gsMatrix<T> m_criticalModes;
+    /// Orthonormal deflation vectors V and the product K V
+    gsMatrix<T> m_deflationVecs, m_deflationKV;
+    /// Copy of the factorized matrix, used for the correction. It is only kept when there are deflation vectors
+    gsSparseMatrix<T> m_deflationMat;
+    /// Factorization of V^T K V
+    gsEigen::LDLT<typename gsMatrix<T>::Base> m_deflationE;
+
+    /// Workers for speculative steps
+    std::vector<gsALMBase<T> *> m_workers;
+    bool m_speculative;
+    /// Interrupts the iterations of a step when it returns true
+    std::function<bool()> m_interrupt;
+
 public:
 
 
@@ -540,6 +694,7 @@ protected:
     // Singular point computation tolerances
     T m_SPCompTolE; // extended iterations
     T m_SPCompTolB; // bisection method
+    bool m_SPMultisection; // use multisection instead of bisection
 
     // Branch switch parameter
     T m_tau;
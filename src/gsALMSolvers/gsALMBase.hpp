@@ -14,6 +14,8 @@
 #pragma once
 
 #include <typeinfo>
+#include <atomic>
+#include <gsParallel/gsOpenMP.h>
 #include <gsStructuralAnalysis/src/gsALMSolvers/gsALMHelper.h>
 
 namespace gismo
@@ -44,8 +46,21 @@ void gsALMBase<T>::defaultOptions()
 
     m_options.addReal("SingularPointComputeTolE", "Tolerance for the extended iterations to compute a bifurcation point", 1e-10);
     m_options.addReal("SingularPointComputeTolB", "Tolerance for the bisection iterations to compute a bifurcation point. If tol = 0, no bi-section method is used.", 0);
+    m_options.addSwitch("SingularPointMultisection", "Use a parallel multisection method instead of the bisection method, using this solver and its workers (see setWorkers)", false);
 
     m_options.addString("Solver","Sparse linear solver", "SimplicialLDLT");
+    m_options.addSwitch("Deflation","Deflate the critical modes (the singular vector and the stability eigenvectors) when solving with the Jacobian",false);
+    m_options.addInt ("DeflationModes","Number of stability eigenvectors used for deflation",2);
+    m_options.addInt ("DeflationIterations","Number of correction iterations on the deflation vectors for the sparse linear solver",1);
+    m_options.addInt ("Recycling","Number of Ritz vectors recycled over subsequent solves by a deflated CG solver. If 0, the sparse linear solver from 'Solver' is used",0);
+    m_options.addReal("RecyclingTol","Relative tolerance on the residual of the recycling CG solver. If <=0, 1e-2*TolF is used",-1);
+    m_options.addInt ("RecyclingMaxIt","Maximum number of iterations of the recycling CG solver. If <=0, twice the number of degrees of freedom is used",-1);
+    m_options.addInt ("KernelThreads","Number of threads of the kernels of the recycling CG solver and the norms. If 0, the serial kernels of Eigen are used in the CG solver; if <0, the maximum number of threads is used. The results do not depend on the number of threads (>0)",0);
+    m_options.addInt ("BlockLayout","Format of the matrix products of the recycling CG solver: 0: scalar sparse; 1: 3x3 blocks, DoFs ordered per component, with the same number of DoFs per component; 2: 3x3 blocks, DoFs ordered per node. A matrix whose size is not a multiple of 3 is multiplied in the scalar format",0);
+    m_options.addSwitch("PatternStable","The sparsity pattern of the Jacobian does not change. The Jacobian operator overwrites the matrix of the previous iteration, and the symbolic factorization is reused",false);
+    m_options.addSwitch("SymmetricStorage","The Jacobian operator provides only the lower triangle (column-major) of the symmetric Jacobian, see gsSymmetricStorage",false);
+
+    m_options.addSwitch ("Speculative","Perform the steps with the lengths L, L/2, L/4, ... in parallel on this solver and its workers, and keep the longest converged step",false);
 
     m_options.addSwitch ("Verbose","Verbose output",false);
 
@@ -77,6 +92,31 @@ void gsALMBase<T>::getOptions()
         m_bifurcationMethod = bifmethod::Eigenvalue;
     }
 
+    m_recycling           = m_options.getInt ("Recycling");
+    m_recycler.setRecycleSize(m_recycling);
+    m_recycler.setTolerance(m_options.getReal("RecyclingTol") > 0 ? m_options.getReal("RecyclingTol") : 1e-2*m_toleranceF);
+    m_recycler.setMaxIterations(m_options.getInt("RecyclingMaxIt"));
+    m_recycler.setBlockLayout(m_options.getInt("BlockLayout"));
+    m_recycler.setNumThreads(m_options.getInt("KernelThreads"));
+    // The norms do not depend on the number of threads, hence also not on the option KernelThreads==0 (serial kernels of Eigen)
+    m_kernels.setNumThreads(m_options.getInt("KernelThreads")==0 ? 1 : m_options.getInt("KernelThreads"));
+
+    m_patternStable       = m_options.getSwitch("PatternStable");
+    // The solver is created again, hence its analysis cannot be reused
+    m_pattern.clear();
+    m_symmetric           = m_options.getSwitch("SymmetricStorage");
+    if  (m_recycling > 0 && m_bifurcationMethod==bifmethod::Determinant)
+    {
+        gsWarn<<"Determinant method cannot be used with the recycling solver. Bifurcation method will be set to 'Eigenvalue'.\n";
+        m_bifurcationMethod = bifmethod::Eigenvalue;
+    }
+
+    m_deflation           = m_options.getSwitch("Deflation");
+    m_deflationModes      = m_options.getInt ("DeflationModes");
+    m_deflationIts        = m_options.getInt ("DeflationIterations");
+
+    m_speculative         = m_options.getSwitch("Speculative");
+
     m_verbose             = m_options.getSwitch ("Verbose");
     m_relax               = m_options.getReal("Relaxation");
 
@@ -88,6 +128,7 @@ void gsALMBase<T>::getOptions()
 
     m_SPCompTolE = m_options.getReal("SingularPointComputeTolE");
     m_SPCompTolB = m_options.getReal("SingularPointComputeTolB");
+    m_SPMultisection = m_options.getSwitch("SingularPointMultisection");
 
 
 }
@@ -136,7 +177,18 @@ template <class T>
 gsVector<T> gsALMBase<T>::computeResidual(const gsVector<T> & U, const T & L)
 {
   gsVector<T> resVec;
-  if (!m_residualFun(U, L, resVec))
+  if (m_residualJacobian!=nullptr && !m_quasiNewton)
+  {
+    // Keep the Jacobian for the next call of _computeJacobian, with the state it belongs to
+    m_fusedValid = false;
+    if (!m_residualJacobian(U, L, resVec, m_fusedJacobian))
+      throw 2;
+    m_fusedU = U;
+    m_fusedDeltaU = m_deltaU;
+    m_fusedL = L;
+    m_fusedValid = true;
+  }
+  else if (!m_residualFun(U, L, resVec))
     throw 2;
   return resVec;
 }
@@ -153,20 +205,20 @@ void gsALMBase<T>::computeResidualNorms()
   if (m_numIterations ==0 ) // then define the residual
   {
     // m_basisResidualF = m_resVec.norm();
-    m_basisResidualF = ((m_L+m_DeltaL) * m_forcing).norm();
-    m_basisResidualU = m_DeltaU.norm();
+    m_basisResidualF = _norm((m_L+m_DeltaL) * m_forcing);
+    m_basisResidualU = _norm(m_DeltaU);
 
     // m_residueF = m_resVec.norm() / (((m_L+m_DeltaL) * m_forcing).norm());
-    m_residueF = m_resVec.norm() / (((m_L+m_DeltaL) * m_forcing).norm());
-    m_residueU = m_deltaU.norm()/m_DeltaU.norm();
+    m_residueF = _norm(m_resVec) / (_norm((m_L+m_DeltaL) * m_forcing));
+    m_residueU = _norm(m_deltaU)/_norm(m_DeltaU);
     // m_residueU = m_basisResidualU;
     m_residueL = m_DeltaL;
   }
   else
   {
     // m_residueF = m_resVec.norm() / (((m_L+m_DeltaL) * m_forcing).norm());
-    m_residueF = m_resVec.norm() / m_basisResidualF;
-    m_residueU = m_deltaU.norm() / m_basisResidualU;
+    m_residueF = _norm(m_resVec) / m_basisResidualF;
+    m_residueU = _norm(m_deltaU) / m_basisResidualU;
     m_residueL = m_deltaL / m_DeltaL;
   }
   // gsInfo<<"m_DeltaU = "<<m_DeltaU.norm()
@@ -185,7 +237,32 @@ void gsALMBase<T>::computeResidualNorms()
 template <class T>
 void gsALMBase<T>::factorizeMatrix(const gsSparseMatrix<T> & M)
 {
-  m_solver->compute(M);
+  m_recyclerActive = false;
+  if (m_recycling > 0)
+  {
+    if (m_symmetric)
+    {
+      gsSymmetricStorage<T>::full(M,m_symmetricFull);
+      m_recycler.compute(m_symmetricFull);
+    }
+    else
+      m_recycler.compute(M);
+    // CG requires a symmetric positive definite Jacobian, otherwise the sparse linear solver is used
+    if (m_recycler.info()==gsEigen::ComputationInfo::Success)
+    {
+      m_recyclerActive = true;
+      return;
+    }
+    if (m_verbose)
+      gsWarn<<"The Jacobian is not symmetric or has a non-positive diagonal. The sparse linear solver is used instead of the recycling CG solver.\n";
+  }
+
+  // In symmetric storage, the full matrix is only made for solvers that do not read the stored triangle
+  const gsSparseMatrix<T> & A = m_symmetric ? gsSymmetricStorage<T>::forSolver(*m_solver,M,m_symmetricFull) : M;
+  if (m_patternStable)
+    m_pattern.factorize(*m_solver,A);
+  else
+    m_solver->compute(A);
   if (m_solver->info()!=gsEigen::ComputationInfo::Success)
   {
     gsInfo<<"Solver error with code "<<m_solver->info()<<". See Eigen documentation on ComputationInfo \n"
@@ -195,6 +272,9 @@ void gsALMBase<T>::factorizeMatrix(const gsSparseMatrix<T> & M)
                                                                   <<gsEigen::ComputationInfo::InvalidInput<<": InvalidInput"<<"\n";
     throw 3;
   }
+
+  if (m_deflation)
+    this->_setDeflationMatrix(M);
 }
 
 template <class T>
@@ -202,7 +282,33 @@ gsVector<T> gsALMBase<T>::solveSystem(const gsVector<T> & F)
 {
   try
   {
-    return m_solver->solve(F);
+    if (m_recyclerActive)
+    {
+      gsVector<T> x = m_recycler.solve(F);
+      if (m_recycler.info()==gsEigen::ComputationInfo::Success)
+        return x;
+      if (m_recycler.info()==gsEigen::ComputationInfo::NoConvergence)
+      {
+        if (m_verbose)
+          gsWarn<<"Recycling CG did not converge in "<<m_recycler.iterations()<<" iterations, relative residual = "<<m_recycler.error()<<"\n";
+        throw 3;
+      }
+      // The Jacobian is indefinite, hence it is factorized with the sparse linear solver
+      if (m_verbose)
+        gsWarn<<"The Jacobian is not positive definite. The sparse linear solver is used instead of the recycling CG solver.\n";
+      m_recyclerActive = false;
+      // The full matrix has another pattern than the one analyzed before
+      m_pattern.clear();
+      m_solver->compute(m_recycler.matrix());
+      if (m_solver->info()!=gsEigen::ComputationInfo::Success)
+        throw 3;
+      if (m_deflation)
+        this->_setDeflationMatrix(m_recycler.matrix());
+    }
+    gsVector<T> x = m_solver->solve(F);
+    if (m_deflation && m_deflationVecs.cols()!=0 && m_deflationKV.cols()==m_deflationVecs.cols())
+      this->_deflationCorrection(F,x);
+    return x;
   }
   catch (...)
   {
@@ -211,14 +317,35 @@ gsVector<T> gsALMBase<T>::solveSystem(const gsVector<T> & F)
 }
 
 template <class T>
-gsSparseMatrix<T> gsALMBase<T>::_computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU)
+void gsALMBase<T>::_computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU, gsSparseMatrix<T> & m)
 {
   // Compute Jacobian
-  gsSparseMatrix<T> m;
   m_note += "J";
-  if (!m_djacobian(U,deltaU,m))
-    throw 2;
+  // The kept Jacobian is used on the same solution, update and load factor only
+  if (m_fusedValid && m_fusedU.rows()==U.rows() && m_fusedU==U && m_fusedDeltaU.rows()==deltaU.rows() && m_fusedDeltaU==deltaU
+      && m_fusedL==m_L+m_DeltaL)
+  {
+    // The matrix in m is passed to the next fused evaluation
+    m_fusedValid = false;
+    m.swap(m_fusedJacobian);
+  }
+  else
+  {
+    if (!m_patternStable)
+      m.resize(0,0);
+    if (m_djacobian!=nullptr ? !m_djacobian(U,deltaU,m) : !m_jacobian(U,m))
+      throw 2;
+    if (m_patternStable && !m.isCompressed())
+      m.makeCompressed();
+  }
   this->factorizeMatrix(m);
+}
+
+template <class T>
+gsSparseMatrix<T> gsALMBase<T>::_computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU)
+{
+  gsSparseMatrix<T> m;
+  this->_computeJacobian(U,deltaU,m);
   return m;
 }
 
@@ -236,6 +363,12 @@ gsSparseMatrix<T> gsALMBase<T>::computeJacobian(const gsVector<T> & U)
   return this->computeJacobian(U,DeltaU);
 }
 
+template <class T>
+void gsALMBase<T>::computeJacobian(gsSparseMatrix<T> & m)
+{
+  this->_computeJacobian(m_U + m_DeltaU, m_deltaU, m);
+}
+
 template <class T>
 gsSparseMatrix<T> gsALMBase<T>::computeJacobian()
 {
@@ -326,6 +459,15 @@ void gsALMBase<T>::computeUt()
 //
 template <class T>
 gsStatus gsALMBase<T>::step()
+{
+  if (m_speculative && m_workers.size()!=0)
+    return this->_speculativeStep();
+  else
+    return this->_stepStatus();
+}
+
+template <class T>
+gsStatus gsALMBase<T>::_stepStatus()
 {
   try
   {
@@ -334,14 +476,7 @@ gsStatus gsALMBase<T>::step()
   }
   catch (int errorCode)
   {
-    if      (errorCode==1)
-      m_status = gsStatus::NotConverged;
-    else if (errorCode==2)
-      m_status = gsStatus::AssemblyError;
-    else if (errorCode==3)
-      m_status = gsStatus::SolverError;
-    else
-      m_status = gsStatus::OtherError;
+    m_status = _errorStatus(errorCode);
   }
   catch (...)
   {
@@ -350,6 +485,21 @@ gsStatus gsALMBase<T>::step()
   return m_status;
 }
 
+template <class T>
+gsStatus gsALMBase<T>::_errorStatus(int errorCode)
+{
+  if      (errorCode==1)
+    return gsStatus::NotConverged;
+  else if (errorCode==2)
+    return gsStatus::AssemblyError;
+  else if (errorCode==3)
+    return gsStatus::SolverError;
+  else if (errorCode==4)
+    return gsStatus::Interrupted;
+  else
+    return gsStatus::OtherError;
+}
+
 template <class T>
 void gsALMBase<T>::_step()
 {
@@ -362,7 +512,7 @@ void gsALMBase<T>::_step()
   m_numIterations = 0;
   initiateStep();
 
-  if (m_Uguess.rows()!=0 && m_Uguess.cols()!=0 && (m_Uguess-m_U).norm()!=0 && (m_Lguess-m_L)!=0)
+  if (m_Uguess.rows()!=0 && m_Uguess.cols()!=0 && _norm(m_Uguess-m_U)!=0 && (m_Lguess-m_L)!=0)
     predictorGuess();
   else
     predictor();
@@ -381,6 +531,12 @@ void gsALMBase<T>::_step()
   m_stabilityPrev = m_stability;
   for (m_numIterations = 1; m_numIterations < m_maxIterations; ++m_numIterations)
   {
+    if (m_interrupt && m_interrupt())
+    {
+      if (m_verbose) gsInfo<<"Step interrupted\n";
+      throw 4;
+    }
+
     if ( (!m_quasiNewton) || ( ( m_quasiNewtonInterval>0 ) && ( m_numIterations % m_quasiNewtonInterval) < 1e-10 ) )
     {
       quasiNewtonIteration();
@@ -415,6 +571,143 @@ void gsALMBase<T>::_step()
   }
 }
 
+template <class T>
+gsStatus gsALMBase<T>::_speculativeStep()
+{
+  const index_t nTrials = m_workers.size() + 1;
+  std::vector<gsALMBase<T> *> trials(nTrials);
+  std::vector<gsStatus> status(nTrials);
+
+  // Trial k uses the length L/2^k
+  trials[0] = this;
+  for (index_t k = 1; k!=nTrials; k++)
+  {
+    trials[k] = m_workers[k-1];
+    this->_syncWorker(trials[k]);
+    trials[k]->m_arcLength = m_arcLength / math::pow((T)(2),(T)(k));
+  }
+
+  // Index of the longest converged trial. Shorter trials are interrupted as soon as a longer one converged
+  std::atomic<index_t> best(nTrials);
+  for (index_t k = 0; k!=nTrials; k++)
+    trials[k]->m_interrupt = [&best,k]() -> bool { return best.load() < k; };
+
+#pragma omp parallel for num_threads(nTrials) schedule(static,1)
+  for (index_t k = 0; k < nTrials; k++)
+  {
+    status[k] = trials[k]->_stepStatus();
+    if (status[k]==gsStatus::Success)
+    {
+      index_t current = best.load();
+      while (k < current && !best.compare_exchange_weak(current,k)) {}
+    }
+  }
+
+  for (index_t k = 0; k!=nTrials; k++)
+    trials[k]->m_interrupt = nullptr;
+
+  if (best.load()==nTrials)
+  {
+    // All trials failed; this object has the state of the failed step with the full length
+    m_status = status[0];
+    return m_status;
+  }
+
+  if (best.load()!=0)
+  {
+    if (m_verbose) gsInfo<<"Speculative step converged with arc-length "<<trials[best.load()]->m_arcLength<<"\n";
+    // If the Jacobian of the worker cannot be factorized, this object keeps the state of the failed step with the full length
+    try
+    {
+      this->_adoptWorker(trials[best.load()]);
+    }
+    catch (int errorCode)
+    {
+      m_status = _errorStatus(errorCode);
+      return m_status;
+    }
+    catch (...)
+    {
+      m_status = gsStatus::OtherError;
+      return m_status;
+    }
+  }
+  m_status = gsStatus::Success;
+  return m_status;
+}
+
+template <class T>
+void gsALMBase<T>::_syncWorker(gsALMBase<T> * worker)
+{
+  worker->m_options = m_options;
+  worker->getOptions();
+  worker->m_speculative = false;
+  if (!worker->m_initialized)
+    worker->initialize(false);
+
+  worker->m_arcLength         = m_arcLength;
+  worker->m_arcLength_prev    = m_arcLength_prev;
+  worker->m_arcLength_ori     = m_arcLength_ori;
+  worker->m_adaptiveLength    = m_adaptiveLength;
+  worker->m_desiredIterations = m_desiredIterations;
+
+  worker->m_U         = m_U;
+  worker->m_L         = m_L;
+  worker->m_Uprev     = m_Uprev;
+  worker->m_Lprev     = m_Lprev;
+  worker->m_DeltaUold = m_DeltaUold;
+  worker->m_DeltaLold = m_DeltaLold;
+  worker->m_Uguess    = m_Uguess;
+  worker->m_Lguess    = m_Lguess;
+
+  worker->m_stability     = m_stability;
+  worker->m_stabilityPrev = m_stabilityPrev;
+  worker->m_indicator     = m_indicator;
+  worker->m_negatives     = m_negatives;
+
+  // The Jacobian is re-used with quasi-Newton iterations
+  if (m_quasiNewton)
+    worker->m_jacMat = m_jacMat;
+}
+
+template <class T>
+void gsALMBase<T>::_adoptWorker(const gsALMBase<T> * worker)
+{
+  // The factorization of the worker is not copied. The Jacobian is factorized first, such that the state is unchanged if that fails
+  this->factorizeMatrix(worker->m_jacMat);
+
+  m_arcLength      = worker->m_arcLength;
+  m_arcLength_prev = worker->m_arcLength_prev;
+
+  m_U         = worker->m_U;
+  m_L         = worker->m_L;
+  m_Uprev     = worker->m_Uprev;
+  m_Lprev     = worker->m_Lprev;
+  m_DeltaU    = worker->m_DeltaU;
+  m_DeltaL    = worker->m_DeltaL;
+  m_deltaU    = worker->m_deltaU;
+  m_deltaL    = worker->m_deltaL;
+  m_deltaUt   = worker->m_deltaUt;
+  m_deltaUbar = worker->m_deltaUbar;
+  m_DeltaUold = worker->m_DeltaUold;
+  m_DeltaLold = worker->m_DeltaLold;
+  m_resVec    = worker->m_resVec;
+  m_jacMat    = worker->m_jacMat;
+
+  m_numIterations = worker->m_numIterations;
+  m_converged     = worker->m_converged;
+  m_residueF      = worker->m_residueF;
+  m_residueU      = worker->m_residueU;
+  m_residueL      = worker->m_residueL;
+  m_note          = worker->m_note;
+
+  m_stabilityVec  = worker->m_stabilityVec;
+  m_stability     = worker->m_stability;
+  m_stabilityPrev = worker->m_stabilityPrev;
+  m_indicator     = worker->m_indicator;
+  m_negatives     = worker->m_negatives;
+}
+
 // ------------------------------------------------------------------------------------------------------------
 // ---------------------------------------Singular point methods-----------------------------------------------
 // ------------------------------------------------------------------------------------------------------------
@@ -431,7 +724,12 @@ void gsALMBase<T>::_computeSingularPoint(const gsVector<T> & U, const T & L, boo
     bool converged = false;
     // First stage: bisection method
     if (m_SPCompTolB != 0)
-      this->_bisectionSolve(m_U,m_L,m_SPCompTolB);
+    {
+      if (m_SPMultisection && m_workers.size()!=0)
+        this->_multisectionSolve(m_U,m_L,m_SPCompTolB);
+      else
+        this->_bisectionSolve(m_U,m_L,m_SPCompTolB);
+    }
 
     converged = this->_extendedSystemSolve(m_U, m_L, m_SPCompTolE);
 
@@ -477,23 +775,23 @@ bool gsALMBase<T>::_testSingularPoint(bool jacobian)
   // First, approximate the eigenvector of the Jacobian by a few arc length iterations
   // Initiate m_V and m_DeltaVDET
 
+  // The Jacobian is factorized when it is computed
   if (jacobian)
-  {
-    m_jacMat = this->computeJacobian(m_U,m_deltaU);
+    this->_computeJacobian(m_U,m_deltaU,m_jacMat);
+  else
     this->factorizeMatrix(m_jacMat);
-  }
 
   m_V = gsVector<T>::Ones(m_numDof);
   m_V.normalize();
-  factorizeMatrix(m_jacMat);
 
   for (index_t k = 0; k<m_SPTestIt; k++)
   {
     m_V = this->solveSystem(m_V);
     m_V.normalize();
   }
+  this->_updateDeflation();
 
-  T dot = (abs(m_V.dot(m_forcing)));
+  T dot = (abs(_dot(m_V,m_forcing)));
   if ( (abs(dot) / m_SPTestTol > 1e-1) && (abs(dot) / m_SPTestTol < 10) )
   {
     gsInfo<<"Warning: the singular point test is close to its tolerance. dot/tol = "<<abs(dot)/m_SPTestTol<<" dot = "<<dot<<"\t tolerance = "<<m_SPTestTol<<"\n";
@@ -549,8 +847,7 @@ void gsALMBase<T>::_computeStability(const gsVector<T> & x, bool jacobian, T shi
   if (jacobian)
   {
     gsVector<T> dx = gsVector<T>::Zero(x.size());
-    m_jacMat = this->computeJacobian(x,dx);
-    this->factorizeMatrix(m_jacMat);
+    this->_computeJacobian(x,dx,m_jacMat);
   } // otherwise the jacobian is already computed (on m_U+m_DeltaU)
 
   // gsInfo<<"x = \n"<<x.transpose()<<"\n";
@@ -596,10 +893,14 @@ void gsALMBase<T>::_computeStability(const gsVector<T> & x, bool jacobian, T shi
     // if (es.info()==Spectra::CompInfo::NumericalIssue)
     // gsEigen::SelfAdjointEigenSolver< gsMatrix<T> > es(m_jacMat);
     m_stabilityVec = es.eigenvalues();
+    if (m_deflation)
+      this->_setCriticalModes(m_stabilityVec,es.eigenvectors());
     #else
     GISMO_UNUSED(shift);
     gsEigen::SelfAdjointEigenSolver<gsMatrix<T>> es2(m_jacMat);
     m_stabilityVec = es2.eigenvalues();
+    if (m_deflation)
+      this->_setCriticalModes(m_stabilityVec,es2.eigenvectors());
     #endif
   }
   else if (m_bifurcationMethod == bifmethod::Nothing)
@@ -632,12 +933,9 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
 {
   m_U = U;
   m_L = L;
-  gsInfo<<"Extended iterations --- Starting with U.norm = "<<m_U.norm()<<" and L = "<<m_L<<"\n";
-
-  m_jacMat = this->computeJacobian(m_U,m_deltaU); // Jacobian evaluated on m_U
-  this->factorizeMatrix(m_jacMat);
-  m_basisResidualKTPhi = (m_jacMat*m_V).norm();
+  gsInfo<<"Extended iterations --- Starting with U.norm = "<<_norm(m_U)<<" and L = "<<m_L<<"\n";
 
+  // The updates are reset first, since the Jacobian operator may depend on the update
   m_DeltaV = gsVector<T>::Zero(m_numDof);
   m_DeltaU.setZero();
   m_DeltaL = 0.0;
@@ -645,6 +943,10 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
   m_deltaV = gsVector<T>::Zero(m_numDof);
   m_deltaU.setZero();
   m_deltaL = 0.0;
+
+  this->_computeJacobian(m_U,m_deltaU,m_jacMat); // Jacobian evaluated on m_U, and factorized
+  m_resVec = this->computeResidual(m_U,m_L);
+  m_basisResidualKTPhi = _norm(this->_jacobianProduct(m_jacMat,m_V));
   if (m_verbose)
       _initOutputExtended();
   for (m_numIterations = 0; m_numIterations < m_maxIterations; ++m_numIterations)
@@ -658,10 +960,10 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
     // m_resVec = m_residualFun(m_U, m_L, m_forcing);
     // m_residue = m_resVec.norm() / ( m_L * m_forcing.norm() );
     // m_residue = (m_jacobian(m_U).toDense()*m_V).norm() / refError;
-    m_jacMat = this->computeJacobian(m_U+m_DeltaU,m_deltaU);
-    this->factorizeMatrix(m_jacMat);
-    m_residueKTPhi = (m_jacMat*(m_V+m_DeltaV)).norm(); // /m_basisResidualKTPhi;
+    // The residual and the factorized Jacobian are used in the next iteration
     m_resVec = this->computeResidual(m_U+m_DeltaU,m_L+m_DeltaL);
+    this->computeJacobian(m_jacMat);
+    m_residueKTPhi = _norm(this->_jacobianProduct(m_jacMat,m_V+m_DeltaV)); // /m_basisResidualKTPhi;
     computeResidualNorms();
     if (m_verbose)
       _stepOutputExtended();
@@ -672,7 +974,7 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
     {
       m_U += m_DeltaU;
       m_L += m_DeltaL;
-      gsInfo<<"Iterations finished. U.norm() = "<<m_U.norm()<<"\t L = "<<m_L<<"\n";
+      gsInfo<<"Iterations finished. U.norm() = "<<_norm(m_U)<<"\t L = "<<m_L<<"\n";
       break;
     }
     if (m_numIterations == m_maxIterations-1)
@@ -682,7 +984,7 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
       {
         m_U += m_DeltaU;
         m_L += m_DeltaL;
-        gsInfo<<"Iterations finished; continuing with last solution U.norm() = "<<m_U.norm()<<"\t L = "<<m_L<<"\n";
+        gsInfo<<"Iterations finished; continuing with last solution U.norm() = "<<_norm(m_U)<<"\t L = "<<m_L<<"\n";
       }
       else
       {
@@ -693,7 +995,7 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
         m_deltaV = gsVector<T>::Zero(m_numDof);
         m_deltaU.setZero();
         m_deltaL = 0.0;
-        gsInfo<<"Iterations finished. continuing with original solution U.norm() = "<<m_U.norm()<<"\t L = "<<m_L<<"\n";
+        gsInfo<<"Iterations finished. continuing with original solution U.norm() = "<<_norm(m_U)<<"\t L = "<<m_L<<"\n";
       }
       return false;
     }
@@ -705,27 +1007,22 @@ bool gsALMBase<T>::_extendedSystemSolve(const gsVector<T> & U, const T L, const
 template <class T>
 void gsALMBase<T>::_extendedSystemIteration()
 {
-  m_resVec = this->computeResidual(m_U+m_DeltaU, m_L+m_DeltaL);
-  m_jacMat = this->computeJacobian(m_U+m_DeltaU,m_deltaU);
-  this->factorizeMatrix(m_jacMat);
-
-  // m_jacMat = m_jacobian(m_U);
-
+  // m_resVec and m_jacMat are computed on m_U+m_DeltaU by _extendedSystemSolve
   m_deltaUt = this->solveSystem(m_forcing); // DeltaV1
   m_deltaUbar = this->solveSystem(-m_resVec); // DeltaV2
 
   real_t eps = 1e-8;
   gsSparseMatrix<T> jacMatEps = this->computeJacobian((m_U+m_DeltaU) + eps*(m_V+m_DeltaV));
   m_note += "J"; // mark jacobian computation
-  gsVector<T> h1 = 1/eps * ( jacMatEps * m_deltaUt ) - 1/eps * m_forcing;
-  gsVector<T> h2 = m_jacMat * (m_V+m_DeltaV) + 1/eps * ( jacMatEps * m_deltaUbar + m_resVec );
+  gsVector<T> h1 = 1/eps * this->_jacobianProduct(jacMatEps,m_deltaUt) - 1/eps * m_forcing;
+  gsVector<T> h2 = this->_jacobianProduct(m_jacMat,m_V+m_DeltaV) + 1/eps * ( this->_jacobianProduct(jacMatEps,m_deltaUbar) + m_resVec );
 
   this->factorizeMatrix(m_jacMat);
 
   m_deltaVt = this->solveSystem(-h1); // DeltaV1
   m_deltaVbar = this->solveSystem(-h2); // DeltaV2
 
-  m_deltaL = -( ( (m_V+m_DeltaV)/(m_V+m_DeltaV).norm() ).dot(m_deltaVbar)  + (m_V+m_DeltaV).norm() - 1) / ( (m_V+m_DeltaV)/(m_V+m_DeltaV).norm() ).dot( m_deltaVt );
+  m_deltaL = -( _dot( (m_V+m_DeltaV)/_norm(m_V+m_DeltaV), m_deltaVbar )  + _norm(m_V+m_DeltaV) - 1) / _dot( (m_V+m_DeltaV)/_norm(m_V+m_DeltaV), m_deltaVt );
 
   m_deltaU = m_deltaL * m_deltaUt + m_deltaUbar;
   // gsInfo<<"m_DeltaU = \n"<<m_DeltaU<<"\n";
@@ -766,7 +1063,7 @@ bool gsALMBase<T>::_bisectionSolve(const gsVector<T> & U, const T L, const T tol
 
   T referenceError = _bisectionTerminationFunction(m_U, true);
 
-  gsInfo<<"Bisection iterations --- Starting with U.norm = "<<m_U.norm()<<" and L = "<<m_L<<"; Reference error = "<<referenceError<<"\n";
+  gsInfo<<"Bisection iterations --- Starting with U.norm = "<<_norm(m_U)<<" and L = "<<m_L<<"; Reference error = "<<referenceError<<"\n";
 
   index_t fa, fb;
   fa = _bisectionObjectiveFunction(m_U, false); // jacobian is already computed in the termination function
@@ -783,10 +1080,10 @@ bool gsALMBase<T>::_bisectionSolve(const gsVector<T> & U, const T L, const T tol
     m_U = U_old;
     m_L = L_old;
 
-    gsInfo<<"From U.norm = "<<m_U.norm()<<" and L = "<<m_L<<"\n";
+    gsInfo<<"From U.norm = "<<_norm(m_U)<<" and L = "<<m_L<<"\n";
 
     // Make an arc length step; m_U and U_old and m_L and L_old are different
-    gsStatus status = step();
+    gsStatus status = this->_stepStatus();
 
     // Objective function on new point
     fb = _bisectionObjectiveFunction(m_U, true); // m_u is the new solution
@@ -829,21 +1126,167 @@ bool gsALMBase<T>::_bisectionSolve(const gsVector<T> & U, const T L, const T tol
 
     m_V = this->solveSystem(m_V);
     m_V.normalize();
-    if (  (m_V-Vold).norm() < m_tolerance )
+    if (  _norm(m_V-Vold) < m_tolerance )
     {
         converged = true;
         break;
     }
     Vold = m_V;
   }
+  this->_updateDeflation();
   return converged;
 }
 
+template <class T>
+bool gsALMBase<T>::_multisectionSolve(const gsVector<T> & U, const T L, const T tol)
+{
+  m_U = U;
+  m_L = L;
+
+  // Start of the bracket
+  gsVector<T> U_old = m_U, DeltaU_old = m_DeltaUold;
+  T L_old = m_L, DeltaL_old = m_DeltaLold;
+  // Store original arc length
+  T dL = m_arcLength;
+  bool adaptiveBool = m_adaptiveLength;
+  m_adaptiveLength = false;
+  bool converged = false, failed = false;
+
+  T referenceError = _bisectionTerminationFunction(m_U, true);
+  index_t fa = _bisectionObjectiveFunction(m_U, false); // jacobian is already computed in the termination function
+
+  // Every round, the bracket [0,h] is divided in k+1 sub-intervals, evaluated on this solver and the workers
+  const index_t k = m_workers.size() + 1;
+  std::vector<gsALMBase<T> *> trials(k);
+  std::vector<gsStatus> status(k);
+  std::vector<index_t> negatives(k);
+  std::vector<T> indicators(k);
+  trials[0] = this;
+  for (index_t j = 1; j!=k; j++)
+    trials[j] = m_workers[j-1];
+
+  gsInfo<<"Multisection iterations --- Starting with U.norm = "<<_norm(m_U)<<" and L = "<<m_L<<"; Reference error = "<<referenceError<<"; Subdivisions = "<<k+1<<"\n";
+
+  T h = m_arcLength;
+  gsVector<T> U_best = U_old;
+  T L_best = L_old;
+  for (index_t it = 1; it < m_maxIterations; ++it)
+  {
+    // Reset start point and synchronize the workers
+    m_U = U_old;
+    m_L = L_old;
+    m_DeltaUold = DeltaU_old;
+    m_DeltaLold = DeltaL_old;
+    for (index_t j = 1; j!=k; j++)
+    {
+      this->_syncWorker(trials[j]);
+      trials[j]->m_adaptiveLength = false;
+    }
+    for (index_t j = 0; j!=k; j++)
+      trials[j]->m_arcLength = (j+1) * h / (k+1);
+
+#pragma omp parallel for num_threads(k) schedule(static,1)
+    for (index_t j = 0; j < k; j++)
+    {
+      status[j] = trials[j]->_stepStatus();
+      if (status[j]==gsStatus::Success)
+      {
+        try
+        {
+          negatives[j]  = trials[j]->_bisectionObjectiveFunction(trials[j]->m_U, true);
+          indicators[j] = trials[j]->m_indicator;
+        }
+        catch (...)
+        {
+          status[j] = gsStatus::OtherError;
+        }
+      }
+    }
+
+    // The new bracket is bounded by converged points only: the first converged trial with a change of stability
+    // (or the end of the bracket, jc = k), and the last converged trial before it (or the start of the bracket, ja = -1).
+    // Failed trials inside the bracket are skipped
+    index_t jc = 0;
+    while (jc!=k && !(status[jc]==gsStatus::Success && negatives[jc]!=fa))
+      jc++;
+    index_t ja = -1;
+    for (index_t j = 0; j!=jc; j++)
+      if (status[j]==gsStatus::Success)
+        ja = j;
+
+    if (m_verbose)
+    {
+      gsInfo<<"\t multisection iteration "<<it<<"\t arc length = "<<h<<"; negatives = ";
+      for (index_t j = 0; j!=k; j++)
+        gsInfo<<(status[j]==gsStatus::Success ? std::to_string(negatives[j]) : "x")<<" ";
+      gsInfo<<"\n";
+    }
+
+    // All trials failed, hence the bracket cannot be reduced
+    if (ja==-1 && jc==k)
+    {
+      gsInfo<<"\t Multisection failed: no trial step converged with arc length "<<h/(k+1)<<"\n";
+      failed = true;
+      break;
+    }
+
+    if (ja!=-1)
+    {
+      U_old = trials[ja]->m_U;
+      L_old = trials[ja]->m_L;
+      DeltaU_old = trials[ja]->m_DeltaUold;
+      DeltaL_old = trials[ja]->m_DeltaLold;
+    }
+    h = (jc - ja) * h / (k+1);
+
+    // termination criteria on the point closest to the singular point
+    index_t jt = (jc!=k) ? jc : ja;
+    if (jt!=-1)
+    {
+      U_best = trials[jt]->m_U;
+      L_best = trials[jt]->m_L;
+      if (m_verbose) gsInfo<<"\t Finished. Relative error = "<< abs(indicators[jt]/referenceError)<<"\t"<<" obj.value = "<<indicators[jt]<<"\n";
+      if (abs(indicators[jt]/referenceError) < tol)
+      {
+        converged = true;
+        break;
+      }
+    }
+  }
+  // Reset arc length
+  m_arcLength = dL;
+  m_adaptiveLength = adaptiveBool;
+
+  m_U = U_best;
+  m_L = L_best;
+  this->_computeStability(m_U,true);
+
+  // Compute eigenvector
+  m_V = gsVector<T>::Ones(m_numDof);
+  m_V.normalize();
+  gsVector<T> Vold = gsVector<T>::Zero(m_numDof);
+  for (index_t j = 0; j<5; j++)
+  {
+    this->factorizeMatrix(m_jacMat);
+
+    m_V = this->solveSystem(m_V);
+    m_V.normalize();
+    if (  _norm(m_V-Vold) < m_tolerance )
+    {
+        converged = true;
+        break;
+    }
+    Vold = m_V;
+  }
+  this->_updateDeflation();
+  return converged && !failed;
+}
+
 template <class T>
 void gsALMBase<T>::switchBranch()
 {
   m_V.normalize();
-  real_t lenPhi = m_V.norm();
+  real_t lenPhi = _norm(m_V);
   real_t xi = lenPhi/m_tau;
   // gsInfo<<xi<<"\n";
   m_DeltaU = xi*m_V;
@@ -855,6 +1298,90 @@ void gsALMBase<T>::switchBranch()
   // m_DeltaUold = m_DeltaU;
 }
 
+template <class T>
+void gsALMBase<T>::_setCriticalModes(const gsVector<T> & eigenvalues, const gsMatrix<T> & eigenvectors)
+{
+  std::vector<index_t> order(eigenvalues.size());
+  for (size_t k = 0; k!=order.size(); k++) order[k] = k;
+  std::sort(order.begin(),order.end(),
+            [&eigenvalues](index_t a, index_t b) { return math::abs(eigenvalues[a]) < math::abs(eigenvalues[b]); });
+
+  index_t nModes = std::min<index_t>(m_deflationModes,order.size());
+  m_criticalModes.resize(eigenvectors.rows(),nModes);
+  for (index_t k = 0; k!=nModes; k++)
+    m_criticalModes.col(k) = eigenvectors.col(order[k]);
+  this->_updateDeflation();
+}
+
+template <class T>
+void gsALMBase<T>::_updateDeflation()
+{
+  if (!m_deflation)
+    return;
+
+  bool singularVector = (m_V.rows()==m_numDof && _norm(m_V)!=0);
+  index_t nModes = (m_criticalModes.rows()==m_numDof) ? m_criticalModes.cols() : 0;
+  gsMatrix<T> V(m_numDof, nModes + (singularVector ? 1 : 0));
+  if (singularVector)
+    V.col(0) = m_V;
+  if (nModes!=0)
+    V.rightCols(nModes) = m_criticalModes;
+
+  // The singular vector is often close to one of the modes, hence dependent vectors are removed
+  gsRecyclingCG<T>::orthonormalize(V,V.cols());
+  m_deflationVecs = V;
+
+  if (m_recycling > 0)
+    m_recycler.setDeflationVectors(m_deflationVecs);
+  // The coarse system of the current factorization is updated for the new vectors
+  if (!m_recyclerActive && m_deflationMat.rows()==m_numDof)
+    this->_computeDeflationSystem();
+}
+
+template <class T>
+void gsALMBase<T>::_setDeflationMatrix(const gsSparseMatrix<T> & M)
+{
+  // The matrix is only copied when there are deflation vectors. Vectors that are set later are used from the next factorization on
+  if (m_deflationVecs.cols()!=0)
+    m_deflationMat = M;
+  else
+    m_deflationMat = gsSparseMatrix<T>();
+  this->_computeDeflationSystem();
+}
+
+template <class T>
+void gsALMBase<T>::_computeDeflationSystem()
+{
+  if (m_deflationVecs.cols()==0 || m_deflationMat.rows()!=m_deflationVecs.rows())
+  {
+    m_deflationKV.resize(0,0);
+    return;
+  }
+  m_deflationKV = this->_jacobianProduct(m_deflationMat,m_deflationVecs);
+  m_deflationE.compute(m_deflationVecs.transpose() * m_deflationKV);
+}
+
+template <class T>
+void gsALMBase<T>::_deflationCorrection(const gsVector<T> & F, gsVector<T> & x)
+{
+  // Two-level correction: exact solve on span(V), followed by a solve with the factorized matrix.
+  // This restores the accuracy of the components along the near-null vectors of the Jacobian
+  gsVector<T> r = F - this->_jacobianProduct(m_deflationMat,x), y;
+  T res = _norm(r), resNew;
+  for (index_t k = 0; k!=m_deflationIts; k++)
+  {
+    y = x + m_deflationVecs * m_deflationE.solve(m_deflationVecs.transpose() * r);
+    r = F - this->_jacobianProduct(m_deflationMat,y);
+    y += m_solver->solve(r);
+    r = F - this->_jacobianProduct(m_deflationMat,y);
+    resNew = _norm(r);
+    if (!(resNew < res)) // no improvement, keep the current solution
+      break;
+    x = y;
+    res = resNew;
+  }
+}
+
 // ------------------------------------------------------------------------------------------------------------
 // ---------------------------------------Output functions-----------------------------------------------------
 // ------------------------------------------------------------------------------------------------------------
@@ -893,14 +1420,14 @@ void gsALMBase<T>::_stepOutputExtended()
   gsInfo<<std::setw(17)<<std::left<<m_residueU;
   gsInfo<<std::setw(17)<<std::left<<m_residueL;
   gsInfo<<std::setw(17)<<std::left<<m_residueKTPhi;
-  gsInfo<<std::setw(17)<<std::left<<(m_U).norm();
-  gsInfo<<std::setw(17)<<std::left<<(m_V).norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_U);
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_V);
   gsInfo<<std::setw(17)<<std::left<<(m_L);
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaV.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaV);
   gsInfo<<std::setw(17)<<std::left<<m_DeltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
-  gsInfo<<std::setw(17)<<std::left<<m_deltaV.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaV);
   gsInfo<<std::setw(17)<<std::left<<m_deltaL;
   gsInfo<<std::setw(17)<<std::left<<_bisectionTerminationFunction(m_U,false);
   gsInfo<<std::setw(17)<<std::left<<m_note;
@@ -53,6 +53,8 @@ protected:
     using Base::computeUbar;
     using Base::computeStability;
     using Base::computeLength;
+    using Base::_norm;
+    using Base::_dot;
 
 public:
 
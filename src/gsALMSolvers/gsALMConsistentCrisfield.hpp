@@ -54,8 +54,7 @@ void gsALMConsistentCrisfield<T>::initMethods()
 template <class T>
 void gsALMConsistentCrisfield<T>::quasiNewtonPredictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
   computeUbar(); // rhs contains residual and should be computed every time
 
@@ -65,8 +64,7 @@ void gsALMConsistentCrisfield<T>::quasiNewtonPredictor()
 template <class T>
 void gsALMConsistentCrisfield<T>::quasiNewtonIteration()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
 }
 
@@ -76,9 +74,9 @@ void gsALMConsistentCrisfield<T>::iteration() // see Carrera1994 eqs 20 and 21
 {
   computeUbar(); // rhs contains residual and should be computed every time
 
-  T cres = m_DeltaU.dot(m_DeltaU) + m_phi*m_phi*m_DeltaL*m_DeltaL * m_forcing.dot(m_forcing) - m_arcLength*m_arcLength;
-  T num = cres + (2*m_DeltaU).dot(m_deltaUbar);
-  T denum = (2*m_DeltaU).dot(m_deltaUt) + m_phi*m_phi*2*m_DeltaL*m_forcing.dot(m_forcing);
+  T cres = _dot(m_DeltaU,m_DeltaU) + m_phi*m_phi*m_DeltaL*m_DeltaL * _dot(m_forcing,m_forcing) - m_arcLength*m_arcLength;
+  T num = cres + _dot(2*m_DeltaU,m_deltaUbar);
+  T denum = _dot(2*m_DeltaU,m_deltaUt) + m_phi*m_phi*2*m_DeltaL*_dot(m_forcing,m_forcing);
   m_deltaL = - num / denum;
   m_deltaU = m_deltaL * m_deltaUt + m_deltaUbar;
 
@@ -101,23 +99,22 @@ void gsALMConsistentCrisfield<T>::initiateStep()
 template <class T>
 void gsALMConsistentCrisfield<T>::predictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   // Check if the solution on start and prev are similar.
   // Then compute predictor of the method
   T tol = 1e-10;
 
-  if ( ((m_U-m_Uprev).norm() < tol) && ((m_L - m_Lprev) * (m_L - m_Lprev) < tol ) )
+  if ( (_norm(m_U-m_Uprev) < tol) && ((m_L - m_Lprev) * (m_L - m_Lprev) < tol ) )
   {
     m_note+= "predictor\t";
     T DL = 1.;
     m_deltaUt = this->solveSystem(m_forcing);
-    m_deltaU = m_deltaUt / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
-    m_deltaL = DL / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
+    m_deltaU = m_deltaUt / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
+    m_deltaL = DL / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
 
     if (!m_phi_user)
-      m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+      m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
   }
   else
   {
@@ -125,7 +122,7 @@ void gsALMConsistentCrisfield<T>::predictor()
     m_deltaU = 1./m_arcLength_prev*(m_U - m_Uprev);
 
     if (!m_phi_user)
-      m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+      m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
   }
 
   // Update iterative step
@@ -140,23 +137,22 @@ void gsALMConsistentCrisfield<T>::predictor()
 template <class T>
 void gsALMConsistentCrisfield<T>::predictorGuess()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   // Check if the solution on start and prev are similar.
   // Then compute predictor of the method
   T tol = 1e-10;
 
-  if ( ((m_Uguess-m_U).norm() < tol) && ((m_Lguess - m_L) * (m_Lguess - m_L) < tol ) )
+  if ( (_norm(m_Uguess-m_U) < tol) && ((m_Lguess - m_L) * (m_Lguess - m_L) < tol ) )
   {
     m_note+= "predictor\t";
     T DL = 1.;
     m_deltaUt = this->solveSystem(m_forcing);
-    m_deltaU = m_deltaUt / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
-    m_deltaL = DL / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
+    m_deltaU = m_deltaUt / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
+    m_deltaL = DL / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
 
     if (!m_phi_user)
-      m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+      m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
   }
 
   else
@@ -165,7 +161,7 @@ void gsALMConsistentCrisfield<T>::predictorGuess()
     m_deltaU = 1./m_arcLength_prev*(m_Uguess - m_U);
 
     if (!m_phi_user)
-      m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+      m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
   }
 
   // Update iterative step
@@ -228,14 +224,14 @@ void gsALMConsistentCrisfield<T>::stepOutput()
   gsInfo<<std::setw(17)<<std::left<<m_residueF;
   gsInfo<<std::setw(17)<<std::left<<m_residueU;
   gsInfo<<std::setw(17)<<std::left<<m_residueL;
-  gsInfo<<std::setw(17)<<std::left<<(m_U+m_DeltaU).norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_U+m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<(m_L + m_DeltaL);
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<m_DeltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
   gsInfo<<std::setw(17)<<std::left<<m_deltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(m_DeltaU.norm(),2.0) + (1.0-m_phi) * math::pow(m_DeltaL,2.0);
-  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(m_DeltaU.norm(),2.0);
+  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(_norm(m_DeltaU),2.0) + (1.0-m_phi) * math::pow(m_DeltaL,2.0);
+  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(_norm(m_DeltaU),2.0);
   gsInfo<<std::setw(17)<<std::left<<(1-m_phi) * math::pow(m_DeltaL,2.0);
   gsInfo<<std::setw(17)<<std::left<<m_indicator;
   gsInfo<<std::setw(17)<<std::left<<m_note;
@@ -48,6 +48,8 @@ protected:
     using Base::computeUt;
     using Base::computeUbar;
     using Base::computeLength;
+    using Base::_norm;
+    using Base::_dot;
 
 public:
 
@@ -78,8 +80,8 @@ public:
 public:
     T distance(const gsVector<T>& DeltaU, const T DeltaL) const
     {
-        T A0 = math::pow(m_phi,2)*m_forcing.dot(m_forcing);
-        return math::pow(DeltaU.dot(DeltaU) + A0*math::pow(DeltaL,2.0),0.5);
+        T A0 = math::pow(m_phi,2)*_dot(m_forcing,m_forcing);
+        return math::pow(_dot(DeltaU,DeltaU) + A0*math::pow(DeltaL,2.0),0.5);
     }
 
 protected:
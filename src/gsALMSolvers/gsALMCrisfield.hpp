@@ -55,8 +55,7 @@ void gsALMCrisfield<T>::initMethods()
 template <class T>
 void gsALMCrisfield<T>::quasiNewtonPredictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
   computeUbar(); // rhs contains residual and should be computed every time
 
@@ -65,8 +64,7 @@ void gsALMCrisfield<T>::quasiNewtonPredictor()
 template <class T>
 void gsALMCrisfield<T>::quasiNewtonIteration()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
 }
 
@@ -110,19 +108,18 @@ void gsALMCrisfield<T>::initiateStep()
 template <class T>
 void gsALMCrisfield<T>::predictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   m_deltaUt = this->solveSystem(m_forcing);
 
   // Choose Solution
-  if (m_DeltaUold.dot(m_DeltaUold) == 0 && m_DeltaLold*m_DeltaLold == 0) // no information about previous step.
+  if (_dot(m_DeltaUold,m_DeltaUold) == 0 && m_DeltaLold*m_DeltaLold == 0) // no information about previous step.
   {
     // gsWarn<<"Different predictor!!!!!\n";
     m_note+= "predictor\t";
-    m_deltaL = m_arcLength / math::pow(2*( m_deltaUt.dot(m_deltaUt) ) , 0.5);
+    m_deltaL = m_arcLength / math::pow(2*( _dot(m_deltaUt,m_deltaUt) ) , 0.5);
     m_deltaU = m_deltaUbar + m_deltaL*m_deltaUt;
     if (!m_phi_user)
-      m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+      m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
     m_note += " phi=" + std::to_string(m_phi);
 
   }
@@ -147,7 +144,7 @@ void gsALMCrisfield<T>::predictor()
   else // previous point is not in the origin
   {
     if (!m_phi_user)
-      m_phi = math::pow(m_U.dot(m_U)/( math::pow(m_L,2) * m_forcing.dot(m_forcing) ),0.5);
+      m_phi = math::pow(_dot(m_U,m_U)/( math::pow(m_L,2) * _dot(m_forcing,m_forcing) ),0.5);
     m_note += " phi=" + std::to_string(m_phi);
     computeLambdaMU();
   }
@@ -168,11 +165,10 @@ void gsALMCrisfield<T>::predictorGuess()
 {
   GISMO_ASSERT(m_Uguess.rows()!=0 && m_Uguess.cols()!=0,"Guess is empty");
 
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   m_deltaUt = this->solveSystem(m_forcing);
   if (!m_phi_user)
-    m_phi = math::pow( m_deltaUt.dot(m_deltaUt) / m_forcing.dot(m_forcing),0.5);
+    m_phi = math::pow( _dot(m_deltaUt,m_deltaUt) / _dot(m_forcing,m_forcing),0.5);
   m_note += " phi=" + std::to_string(m_phi);
 
   //
@@ -212,14 +208,14 @@ void gsALMCrisfield<T>::iterationFinish()
 template <class T>
 void gsALMCrisfield<T>::computeLambdasSimple() //Ritto-Corrêa et al. 2008
 {
-  T A0 = math::pow(m_phi,2)* m_forcing.dot(m_forcing); // see Lam et al. 1991,
+  T A0 = math::pow(m_phi,2)* _dot(m_forcing,m_forcing); // see Lam et al. 1991,
 
-  m_a0 = m_deltaUt.dot(m_deltaUt) + A0;
-  m_b0 = 2*( m_deltaUt.dot(m_DeltaU) + m_DeltaL * A0 );
-  m_b1 = 2*( m_deltaUbar.dot(m_deltaUt) );
-  m_c0 = m_DeltaU.dot(m_DeltaU) + m_DeltaL*m_DeltaL * A0 - math::pow(m_arcLength,2);
-  m_c1 = 2*( m_DeltaU.dot(m_deltaUbar) );
-  m_c2 = m_deltaUbar.dot(m_deltaUbar);
+  m_a0 = _dot(m_deltaUt,m_deltaUt) + A0;
+  m_b0 = 2*( _dot(m_deltaUt,m_DeltaU) + m_DeltaL * A0 );
+  m_b1 = 2*( _dot(m_deltaUbar,m_deltaUt) );
+  m_c0 = _dot(m_DeltaU,m_DeltaU) + m_DeltaL*m_DeltaL * A0 - math::pow(m_arcLength,2);
+  m_c1 = 2*( _dot(m_DeltaU,m_deltaUbar) );
+  m_c2 = _dot(m_deltaUbar,m_deltaUbar);
 
   /// Calculate the coefficients of the polynomial
   m_alpha1 = m_a0;
@@ -307,17 +303,17 @@ void gsALMCrisfield<T>::computeLambdasModified()
 template <class T>
 void gsALMCrisfield<T>::computeLambdasComplex()
 {
-  T A0 = math::pow(m_phi,2)* m_forcing.dot(m_forcing); // see Lam et al. 1991
+  T A0 = math::pow(m_phi,2)* _dot(m_forcing,m_forcing); // see Lam et al. 1991
   gsVector<T> DeltaUcr = m_DeltaU + m_deltaUbar;
 
   // Compute internal loads from residual and
   // gsVector<T> R = m_residualFun(m_U + DeltaUcr, m_L + m_DeltaL , m_forcing);
   // gsVector<T> Fint = R + (m_L + m_DeltaL) * m_forcing;
-  gsVector<T> Fint = m_jacMat*(m_U+m_DeltaU);
-  T Lcr = Fint.dot(m_forcing)/m_forcing.dot(m_forcing);
+  gsVector<T> Fint = this->_jacobianProduct(m_jacMat,m_U+m_DeltaU);
+  T Lcr = _dot(Fint,m_forcing)/_dot(m_forcing,m_forcing);
   T DeltaLcr = Lcr - m_L;
 
-  T arcLength_cr = math::pow( DeltaUcr.dot(DeltaUcr) + A0 * math::pow(DeltaLcr, 2.0) ,0.5);
+  T arcLength_cr = math::pow( _dot(DeltaUcr,DeltaUcr) + A0 * math::pow(DeltaLcr, 2.0) ,0.5);
   T mu = m_arcLength/arcLength_cr;
 
   m_deltaL = mu*DeltaLcr - m_DeltaL;
@@ -383,9 +379,9 @@ void gsALMCrisfield<T>::computeLambdaDET()
 template <class T>
 void gsALMCrisfield<T>::computeLambdaMU()
 {
-    T A0 = math::pow(m_phi,2)* m_forcing.dot(m_forcing); // see Lam et al. 1991
-    index_t dir = sign(m_DeltaUold.dot(m_deltaUt) + A0*m_DeltaLold); // Feng et al. 1995 with H = \Psi^2
-    T denum = ( math::pow( m_deltaUt.dot(m_deltaUt) + A0 ,0.5) ); // Feng et al. 1995 with H = \Psi^2
+    T A0 = math::pow(m_phi,2)* _dot(m_forcing,m_forcing); // see Lam et al. 1991
+    index_t dir = sign(_dot(m_DeltaUold,m_deltaUt) + A0*m_DeltaLold); // Feng et al. 1995 with H = \Psi^2
+    T denum = ( math::pow( _dot(m_deltaUt,m_deltaUt) + A0 ,0.5) ); // Feng et al. 1995 with H = \Psi^2
 
     T mu;
     if (denum==0)
@@ -407,8 +403,8 @@ void gsALMCrisfield<T>::computeLambdaDOT()
     // ---------------------------------------------------------------------------------
     // Method by Ritto-Corea et al. 2008
     T DOT1,DOT2;
-    DOT1 = m_deltaLs[0]*(m_DeltaUold.dot(m_deltaUt) + math::pow(m_phi,2)*m_DeltaLold);
-    DOT2 = m_deltaLs[1]*(m_DeltaUold.dot(m_deltaUt) + math::pow(m_phi,2)*m_DeltaLold);
+    DOT1 = m_deltaLs[0]*(_dot(m_DeltaUold,m_deltaUt) + math::pow(m_phi,2)*m_DeltaLold);
+    DOT2 = m_deltaLs[1]*(_dot(m_DeltaUold,m_deltaUt) + math::pow(m_phi,2)*m_DeltaLold);
 
     if (DOT1 > DOT2)
     {
@@ -509,21 +505,21 @@ void gsALMCrisfield<T>::stepOutput()
   // else
   //   m_indicator = 0;
 
-  T A0 = math::pow(m_phi,2)*m_forcing.dot(m_forcing);
+  T A0 = math::pow(m_phi,2)*_dot(m_forcing,m_forcing);
 
   gsInfo<<"\t";
   gsInfo<<std::setw(4)<<std::left<<m_numIterations;
   gsInfo<<std::setw(17)<<std::left<<m_residueF;
   gsInfo<<std::setw(17)<<std::left<<m_residueU;
   gsInfo<<std::setw(17)<<std::left<<m_residueL;
-  gsInfo<<std::setw(17)<<std::left<<(m_U+m_DeltaU).norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_U+m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<(m_L + m_DeltaL);
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<m_DeltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
   gsInfo<<std::setw(17)<<std::left<<m_deltaL;
   gsInfo<<std::setw(17)<<std::left<<this->distance(m_DeltaU,m_DeltaL);//math::pow(m_DeltaU.dot(m_DeltaU) + A0*math::pow(m_DeltaL,2.0),0.5);
-  gsInfo<<std::setw(17)<<std::left<<math::pow(m_DeltaU.norm(),2.0);
+  gsInfo<<std::setw(17)<<std::left<<math::pow(_norm(m_DeltaU),2.0);
   gsInfo<<std::setw(17)<<std::left<<A0*math::pow(m_DeltaL,2.0);
   gsInfo<<std::setw(17)<<std::left<<m_indicator <<std::left << " (" <<std::left<< m_negatives<<std::left << ")";
   gsInfo<<std::setw(17)<<std::left<<m_note;
@@ -50,6 +50,7 @@ protected:
     using Base::computeUbar;
     using Base::computeStability;
     using Base::computeLength;
+    using Base::_norm;
 
 public:
 
@@ -22,8 +22,7 @@ namespace gismo
 template <class T>
 void gsALMLoadControl<T>::quasiNewtonPredictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUbar(); // rhs contains residual and should be computed every time
 
 }
@@ -31,8 +30,7 @@ void gsALMLoadControl<T>::quasiNewtonPredictor()
 template <class T>
 void gsALMLoadControl<T>::quasiNewtonIteration()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 }
 
 template <class T>
@@ -71,8 +69,7 @@ void gsALMLoadControl<T>::initiateStep()
 template <class T>
 void gsALMLoadControl<T>::predictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   m_DeltaL = m_deltaL = m_arcLength;
   m_deltaUt = this->solveSystem(m_forcing);
@@ -85,8 +82,7 @@ void gsALMLoadControl<T>::predictor()
 template <class T>
 void gsALMLoadControl<T>::predictorGuess()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   m_DeltaL = m_deltaL = m_Lguess - m_L;
   m_deltaUt = this->solveSystem(m_forcing);
@@ -139,11 +135,11 @@ void gsALMLoadControl<T>::stepOutput()
   gsInfo<<std::setw(4)<<std::left<<m_numIterations;
   gsInfo<<std::setw(17)<<std::left<<m_residueF;
   gsInfo<<std::setw(17)<<std::left<<m_residueU;
-  gsInfo<<std::setw(17)<<std::left<<(m_U+m_DeltaU).norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_U+m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<(m_L + m_DeltaL);
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<m_DeltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
   gsInfo<<std::setw(17)<<std::left<<m_deltaL;
   gsInfo<<std::setw(17)<<std::left<<m_indicator;
   gsInfo<<std::setw(17)<<std::left<<m_note;
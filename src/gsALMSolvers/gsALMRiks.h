@@ -50,6 +50,8 @@ protected:
     using Base::computeUbar;
     using Base::computeStability;
     using Base::computeLength;
+    using Base::_norm;
+    using Base::_dot;
 
 public:
 
@@ -80,7 +82,7 @@ public:
 public:
     T distance(const gsVector<T>& DeltaU, const T DeltaL) const
     {
-        return math::pow(m_phi * math::pow(DeltaU.norm(),2.0) + (1.0-m_phi) * math::pow(DeltaL,2.0),0.5);
+        return math::pow(m_phi * math::pow(_norm(DeltaU),2.0) + (1.0-m_phi) * math::pow(DeltaL,2.0),0.5);
     }
 
 protected:
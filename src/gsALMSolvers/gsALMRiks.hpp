@@ -37,8 +37,7 @@ void gsALMRiks<T>::initMethods()
 template <class T>
 void gsALMRiks<T>::quasiNewtonPredictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
   computeUbar(); // rhs contains residual and should be computed every time
 
@@ -47,8 +46,7 @@ void gsALMRiks<T>::quasiNewtonPredictor()
 template <class T>
 void gsALMRiks<T>::quasiNewtonIteration()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
   computeUt(); // rhs does not depend on solution
 }
 
@@ -74,9 +72,9 @@ void gsALMRiks<T>::iteration()
   //
   // Residual function
   // r = m_phi * m_DeltaU.dot(m_DeltaU)  + (1.0-m_phi) * m_DeltaL*m_DeltaL - m_arcLength*m_arcLength;
-  T r = m_phi*(m_U + m_DeltaU - m_U).dot(m_U + m_DeltaU - m_U) + (1-m_phi)*math::pow(m_L + m_DeltaL - m_L,2.0) - m_arcLength*m_arcLength;
+  T r = m_phi*_dot(m_U + m_DeltaU - m_U,m_U + m_DeltaU - m_U) + (1-m_phi)*math::pow(m_L + m_DeltaL - m_L,2.0) - m_arcLength*m_arcLength;
 
-  m_deltaL = - ( r + 2*m_phi*(m_DeltaU).dot(m_deltaUbar) ) / ( 2*(1-m_phi)*(m_DeltaL) + 2*m_phi*(m_DeltaU).dot(m_deltaUt) );
+  m_deltaL = - ( r + 2*m_phi*_dot(m_DeltaU,m_deltaUbar) ) / ( 2*(1-m_phi)*(m_DeltaL) + 2*m_phi*_dot(m_DeltaU,m_deltaUt) );
   m_deltaU = m_deltaUbar + m_deltaL*m_deltaUt;
 
   m_DeltaU += m_deltaU;
@@ -97,8 +95,7 @@ void gsALMRiks<T>::initiateStep()
 template <class T>
 void gsALMRiks<T>::predictor()
 {
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   // Define scaling
   if (m_numDof ==1)
@@ -110,13 +107,13 @@ void gsALMRiks<T>::predictor()
   // Then compute predictor of the method
   T tol = 1e-10;
 
-  if ( ((m_U-m_Uprev).norm() < tol) && ((m_L - m_Lprev) * (m_L - m_Lprev) < tol ) )
+  if ( (_norm(m_U-m_Uprev) < tol) && ((m_L - m_Lprev) * (m_L - m_Lprev) < tol ) )
   {
     m_note+= "predictor\t";
     T DL = 1.;
     m_deltaUt = this->solveSystem(m_forcing);
-    m_deltaU = m_deltaUt / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
-    m_deltaL = DL / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
+    m_deltaU = m_deltaUt / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
+    m_deltaL = DL / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
   }
   else
   {
@@ -138,20 +135,19 @@ void gsALMRiks<T>::predictorGuess()
 {
   GISMO_ASSERT(m_Uguess.rows()!=0 && m_Uguess.cols()!=0,"Guess is empty");
 
-  m_jacMat = computeJacobian();
-  this->factorizeMatrix(m_jacMat);
+  computeJacobian(m_jacMat);
 
   m_deltaUt = this->solveSystem(m_forcing);
 
   T tol = 1e-10;
 
-  if ( ((m_Uguess-m_U).norm() < tol) && ((m_Lguess - m_L) * (m_Lguess - m_L) < tol ) )
+  if ( (_norm(m_Uguess-m_U) < tol) && ((m_Lguess - m_L) * (m_Lguess - m_L) < tol ) )
   {
     m_note+= "predictor\t";
     T DL = 1.;
     m_deltaUt = this->solveSystem(m_forcing);
-    m_deltaU = m_deltaUt / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
-    m_deltaL = DL / math::sqrt( m_deltaUt.dot(m_deltaUt) + m_DeltaL*DL );
+    m_deltaU = m_deltaUt / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
+    m_deltaL = DL / math::sqrt( _dot(m_deltaUt,m_deltaUt) + m_DeltaL*DL );
   }
   else
   {
@@ -249,14 +245,14 @@ void gsALMRiks<T>::stepOutput()
   gsInfo<<std::setw(17)<<std::left<<m_residueF;
   gsInfo<<std::setw(17)<<std::left<<m_residueU;
   gsInfo<<std::setw(17)<<std::left<<m_residueL;
-  gsInfo<<std::setw(17)<<std::left<<(m_U+m_DeltaU).norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_U+m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<(m_L + m_DeltaL);
-  gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
   gsInfo<<std::setw(17)<<std::left<<m_DeltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
+  gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
   gsInfo<<std::setw(17)<<std::left<<m_deltaL;
-  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(m_DeltaU.norm(),2.0) + (1.0-m_phi) * math::pow(m_DeltaL,2.0);
-  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(m_DeltaU.norm(),2.0);
+  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(_norm(m_DeltaU),2.0) + (1.0-m_phi) * math::pow(m_DeltaL,2.0);
+  gsInfo<<std::setw(17)<<std::left<<m_phi * math::pow(_norm(m_DeltaU),2.0);
   gsInfo<<std::setw(17)<<std::left<<(1-m_phi) * math::pow(m_DeltaL,2.0);
   gsInfo<<std::setw(17)<<std::left<<m_indicator;
   gsInfo<<std::setw(17)<<std::left<<m_note;
@@ -973,7 +973,8 @@ void gsAPALM<T>::_initiation( const std::tuple<index_t, T     , solution_t, solu
     if (status==gsStatus::NotConverged || status==gsStatus::AssemblyError)
     {
       if (m_verbose) gsMPIInfo(m_rank)<<"Error: Loop terminated, arc length method did not converge.\n";
-      dL = dL / 2;
+      // With speculative steps, the lengths dL, dL/2, ... have been tried already
+      dL = dL / math::pow((T)(2),(T)(m_ALM->numTrials()));
       m_ALM->setLength(dL);
       m_ALM->setSolution(Uold,Lold);
       continue;
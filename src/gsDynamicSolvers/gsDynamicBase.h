@@ -19,6 +19,8 @@
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsIO/gsOptionList.h>
 #include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSymmetricStorage.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsParallelKernels.h>
 
 namespace gismo
 {
@@ -46,6 +48,24 @@ protected:
     typedef typename gsStructuralAnalysisOps<T>::Stiffness_t Stiffness_t;
     typedef typename gsStructuralAnalysisOps<T>::Jacobian_t  Jacobian_t;
     typedef typename gsStructuralAnalysisOps<T>::TJacobian_t TJacobian_t;
+    typedef typename gsStructuralAnalysisOps<T>::ResidualJacobian_t  ResidualJacobian_t;
+    typedef typename gsStructuralAnalysisOps<T>::TResidualJacobian_t TResidualJacobian_t;
+
+    /// Matrix prepared for repeated products in the explicit schemes, see \ref _prepareProduct
+    struct ProductMatrix
+    {
+        ProductMatrix() : format(0), triangle(false), rows(-1) { }
+
+        /// 0: the gsSparseMatrix is used; 1: block format; 2: row-major copy for the multithreaded kernels
+        index_t format;
+        /// Whether the gsSparseMatrix is a stored triangle
+        bool triangle;
+        /// Number of rows of the prepared matrix
+        index_t rows;
+
+        gsBlockSparseMatrix<T> block;
+        typename gsParallelKernels<T>::RowMatrix rowMajor;
+    };
 
 public:
 
@@ -64,11 +84,6 @@ public:
     m_stiffness(Stiffness),
     m_force(Force)
     {
-        m_Tmass       = [this](                           const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_mass(result);};
-        m_Tdamping    = [this](gsVector<T> const & x,     const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_damping(x,result);};
-        m_Tjacobian   = [this](gsVector<T> const & /*x*/, const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_stiffness(result);};
-        m_Tforce      = [this](                           const T /*time*/, gsVector<T>       & result)     -> bool {return m_force(result);};
-        m_Tresidual   = [    ](gsVector<T> const & /*x*/, const T /*time*/, gsVector<T>       & /*result*/) -> bool {GISMO_ERROR("time-dependent residual not available");};
         _init();
     }
 
@@ -85,10 +100,6 @@ public:
     m_stiffness(Stiffness),
     m_Tforce(TForce)
     {
-        m_Tmass       = [this](                           const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_mass(result);};
-        m_Tdamping    = [this](gsVector<T> const & x,     const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_damping(x,result);};
-        m_Tjacobian   = [this](gsVector<T> const & /*x*/, const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_stiffness(result);};
-        m_Tresidual   = [    ](gsVector<T> const & /*x*/, const T /*time*/, gsVector<T>       & /*result*/) -> bool {GISMO_ERROR("time-dependent residual not available");};
         _init();
     }
 
@@ -105,11 +116,6 @@ public:
     m_jacobian(Jacobian),
     m_residual(Residual)
     {
-        m_Tmass       = [this](                       const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_mass(result);};
-        m_Tdamping    = [this](gsVector<T> const & x, const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_damping(x,result);};
-        m_Tjacobian   = [this](gsVector<T> const & x, const T /*time*/, gsSparseMatrix<T> & result)     -> bool {return m_jacobian(x,result);};
-        m_Tforce      = [    ](                       const T /*time*/, gsVector<T>       & /*result*/) -> bool {GISMO_ERROR("time-dependent force not available");};
-        m_Tresidual   = [this](gsVector<T> const & x, const T /*time*/, gsVector<T>       & result)     -> bool {return m_residual(x,result);};
         _init();
     }
 
@@ -126,9 +132,6 @@ public:
     m_jacobian(Jacobian),
     m_Tresidual(TResidual)
     {
-        m_Tmass       = [this](                       const T /*time*/, gsSparseMatrix<T> & result) -> bool {return m_mass(result);};
-        m_Tjacobian   = [this](gsVector<T> const & x, const T /*time*/, gsSparseMatrix<T> & result) -> bool {return m_jacobian(x,result);};
-        m_Tdamping    = [this](gsVector<T> const & x, const T /*time*/, gsSparseMatrix<T> & result) -> bool {return m_damping(x,result);};
         _init();
     }
 
@@ -145,8 +148,6 @@ public:
     m_Tjacobian(TJacobian),
     m_Tresidual(TResidual)
     {
-        m_Tmass       = [this](                       const T /*time*/, gsSparseMatrix<T> & result) -> bool {return m_mass(result);};
-        m_Tdamping    = [this](gsVector<T> const & x, const T /*time*/, gsSparseMatrix<T> & result) -> bool {return m_damping(x,result);};
         _init();
     }
 
@@ -174,7 +175,9 @@ protected:
         m_time = 0;
         // initialize variables
         m_numIterations = -1;
+        m_fusedValid = false;
         defaultOptions();
+        _getOptions();
 
         m_status = gsStatus::NotStarted;
     }
@@ -193,6 +196,7 @@ public:
     /// Perform one arc-length step
     virtual gsStatus step(T dt)
     {
+        this->_getOptions();
         gsStatus status = this->_step(m_time,dt,m_U,m_V,m_A);
         m_time += dt;
         return status;
@@ -203,8 +207,17 @@ public:
         return this->step(m_options.getReal("DT"));
     }
 
+    /**
+     * @brief      Performs a step from time \a t with time step \a dt on the given state
+     *
+     * The method does not change the state of the solver, except for the
+     * stored factorization, mass inverse and the Jacobian kept by the fused
+     * operator (see \ref setResidualJacobian). Hence it is not thread-safe:
+     * concurrent steps need a solver object per thread.
+     */
     virtual gsStatus step(const T t, const T dt, gsVector<T> & U, gsVector<T> & V, gsVector<T> & A) const
     {
+        this->_getOptions();
         return _step(t,dt,U,V,A);
     }
 
@@ -214,6 +227,30 @@ public:
         m_options.setReal("DT",dt);
     }
 
+    /**
+     * @brief      Sets an operator that computes the residual and the Jacobian in one call
+     *
+     * When set, the implicit schemes compute the residual with this operator
+     * whenever the Jacobian is needed on the same solution next, and the
+     * kept Jacobian is used instead of calling the Jacobian operator.
+     *
+     * @param[in]  TResidualJacobian  The time-dependent residual and Jacobian
+     */
+    virtual void setResidualJacobian(const TResidualJacobian_t & TResidualJacobian)
+    {
+        m_residualJacobian = nullptr;
+        m_TresidualJacobian = TResidualJacobian;
+        m_fusedValid = false;
+    }
+
+    /// See \ref setResidualJacobian
+    virtual void setResidualJacobian(const ResidualJacobian_t & residualJacobian)
+    {
+        m_residualJacobian = residualJacobian;
+        m_TresidualJacobian = nullptr;
+        m_fusedValid = false;
+    }
+
     // Output
     /// True if the Arc Length method converged
     virtual bool converged() const {return m_status==gsStatus::Success;}
@@ -260,21 +297,40 @@ protected:
     /// Compute the residual
     virtual void _computeForce(const T time, gsVector<T> & F) const
     {
-        if (!m_Tforce(time,F))
+        GISMO_ENSURE(m_force!=nullptr || m_Tforce!=nullptr,"Force not available");
+        if (m_force!=nullptr ? !m_force(F) : !m_Tforce(time,F))
             throw 2;
     }
 
-    /// Compute the residual
-    virtual void _computeResidual(const gsVector<T> & U, const T time, gsVector<T> & R) const
+    /**
+     * @brief      Compute the residual
+     *
+     * @param[in]  U             The displacements
+     * @param[in]  time          The time
+     * @param      R             The residual
+     * @param[in]  keepJacobian  Whether the Jacobian is needed next on \a U and \a time. If so, and a fused operator is set, the Jacobian is computed along and kept
+     */
+    virtual void _computeResidual(const gsVector<T> & U, const T time, gsVector<T> & R, bool keepJacobian = false) const
     {
-        if (!m_Tresidual(U,time,R))
+        m_fusedValid = false;
+        if (keepJacobian && (m_residualJacobian!=nullptr || m_TresidualJacobian!=nullptr))
+        {
+            if (m_residualJacobian!=nullptr ? !m_residualJacobian(U,R,m_fusedJacobian) : !m_TresidualJacobian(U,time,R,m_fusedJacobian))
+                throw 2;
+            m_fusedU = U;
+            m_fusedTime = time;
+            m_fusedValid = true;
+            return;
+        }
+        GISMO_ENSURE(m_residual!=nullptr || m_Tresidual!=nullptr,"Residual not available");
+        if (m_residual!=nullptr ? !m_residual(U,R) : !m_Tresidual(U,time,R))
             throw 2;
     }
 
     /// Compute the mass matrix
     virtual void _computeMass(const T time, gsSparseMatrix<T> & M) const
     {
-        if (!m_Tmass(time,M))
+        if (m_mass!=nullptr ? !m_mass(M) : !m_Tmass(time,M))
             throw 2;
     }
 
@@ -285,7 +341,7 @@ protected:
         {
             gsSparseMatrix<T> eye(M.rows(), M.cols());
             eye.setIdentity();
-            gsSparseSolver<>::LU solver(M);
+            typename gsSparseSolver<T>::LU solver(this->_full(M));
             gsMatrix<T> MinvI = solver.solve(eye);
             m_massInv = Minv = MinvI.sparseView();
         }
@@ -296,17 +352,140 @@ protected:
     /// Compute the damping matrix
     virtual void _computeDamping(const gsVector<T> & U, const T time, gsSparseMatrix<T> & C) const
     {
-        if (!m_Tdamping(U,time,C))
+        if (m_damping!=nullptr ? !m_damping(U,C) : !m_Tdamping(U,time,C))
             throw 2;
     }
 
     /// Compute the Jacobian matrix
     virtual void _computeJacobian(const gsVector<T> & U, const T time, gsSparseMatrix<T> & K) const
     {
-        if (!m_Tjacobian(U,time,K))
+        if (m_fusedValid && time==m_fusedTime && m_fusedU.rows()==U.rows() && m_fusedU==U)
+        {
+            m_fusedValid = false;
+            K.swap(m_fusedJacobian);
+        }
+        else if (m_stiffness!=nullptr)
+        {
+            if (!m_stiffness(K))
+                throw 2;
+        }
+        else if (m_jacobian!=nullptr ? !m_jacobian(U,K) : !m_Tjacobian(U,time,K))
             throw 2;
     }
 
+    /// Reads the options of the products and norms, which are used in every step. The number of threads of the kernels is set here
+    void _getOptions() const
+    {
+        m_symmetric     = m_options.getSwitch("SymmetricStorage");
+        m_blockLayout   = m_options.getInt("BlockLayout");
+        m_kernelThreads = m_options.getInt("KernelThreads");
+        m_kernels.setNumThreads(m_kernelThreads==0 ? 1 : m_kernelThreads);
+    }
+
+    /// Returns the product of \a A with \a x, where \a A is a stored triangle if the option 'SymmetricStorage' is set
+    template<class Derived>
+    gsMatrix<T> _multiply(const gsSparseMatrix<T> & A, const gsEigen::MatrixBase<Derived> & x) const
+    {
+        if (m_symmetric)
+            return gsSymmetricStorage<T>::multiply(A,x);
+        gsMatrix<T> result = A * x;
+        return result;
+    }
+
+    /**
+     * @brief      Prepares \a A for the products in the explicit schemes
+     *
+     * If the option 'BlockLayout' is set and the size of \a A is a multiple of
+     * the block size, \a A is converted to the block format. Otherwise, if the
+     * option 'KernelThreads' is not zero, a row-major copy of \a A is made for
+     * the multithreaded products.
+     *
+     * @param[in]  A         The matrix
+     * @param      result    The prepared matrix. Its block pattern is reused if possible
+     * @param[in]  constant  Whether \a A is the same in every step; if so, an existing preparation is kept
+     * @param[in]  triangle  Whether \a A is a stored triangle (see the option 'SymmetricStorage')
+     */
+    void _prepareProduct(const gsSparseMatrix<T> & A, ProductMatrix & result, bool constant, bool triangle) const
+    {
+        const index_t layout  = m_blockLayout;
+        const index_t threads = m_kernelThreads;
+
+        index_t format = layout!=0 ? 1 : (threads!=0 ? 2 : 0);
+        // E.g. after the elimination of Dirichlet conditions, the degrees of freedom do not fit in blocks
+        if (format==1 && A.rows() % gsBlockSparseMatrix<T>::BlockSize != 0)
+        {
+            if (result.rows!=A.rows())
+                gsWarn<<"The matrix of size "<<A.rows()<<" does not fit in "<<gsBlockSparseMatrix<T>::BlockSize<<"x"<<gsBlockSparseMatrix<T>::BlockSize
+                      <<" blocks. The products are computed in the scalar format.\n";
+            format = threads!=0 ? 2 : 0;
+        }
+        if (constant && result.format==format && result.triangle==triangle && result.rows==A.rows() &&
+            (format!=1 || result.block.layout()==layout))
+            return;
+        result.format   = format;
+        result.triangle = triangle;
+        result.rows     = A.rows();
+        if (format==0)
+            return;
+
+        gsSparseMatrix<T> full;
+        if (triangle)
+            gsSymmetricStorage<T>::full(A,full);
+        const gsSparseMatrix<T> & source = triangle ? full : A;
+        if (format==1 && (result.block.layout()!=layout || !result.block.setValues(source)))
+            result.block.assign(source,layout==2);
+        else if (format==2)
+            gsParallelKernels<T>::toRowMajor(source,result.rowMajor);
+    }
+
+    /// Prepares the stiffness or damping matrix \a A, which is a stored triangle if the option 'SymmetricStorage' is set. See \ref _prepareProduct
+    void _prepareProduct(const gsSparseMatrix<T> & A, ProductMatrix & result, bool constant = false) const
+    {
+        this->_prepareProduct(A,result,constant,m_symmetric);
+    }
+
+    /// Returns the product of \a A with \a x, where \a prepared is prepared from \a A by \ref _prepareProduct
+    template<class Derived>
+    gsMatrix<T> _multiply(const gsSparseMatrix<T> & A, const ProductMatrix & prepared, const gsEigen::MatrixBase<Derived> & x) const
+    {
+        gsMatrix<T> result;
+        if (prepared.format==1)
+            m_kernels.multiply(prepared.block,x,result);
+        else if (prepared.format==2)
+            m_kernels.multiply(prepared.rowMajor,x,result);
+        else if (prepared.triangle)
+            result = gsSymmetricStorage<T>::multiply(A,x);
+        else
+            result = A * x;
+        return result;
+    }
+
+    /// Returns the Euclidean norm of \a x, see \ref gsParallelKernels. The number of threads is the option 'KernelThreads', where 0 is a single thread
+    template<class Derived>
+    T _norm(const gsEigen::MatrixBase<Derived> & x) const
+    {
+        return m_kernels.norm(x);
+    }
+
+    /// Returns the full matrix of \a A, where \a A is a stored triangle if the option 'SymmetricStorage' is set
+    gsSparseMatrix<T> _full(const gsSparseMatrix<T> & A) const
+    {
+        if (!m_symmetric)
+            return A;
+        gsSparseMatrix<T> result;
+        gsSymmetricStorage<T>::full(A,result);
+        return result;
+    }
+
+    /// Factorizes \a A with \a solver. A stored triangle is only made full if the solver does not read the triangle
+    void _factorize(gsSparseSolver<T> & solver, const gsSparseMatrix<T> & A) const
+    {
+        if (m_symmetric && !gsSymmetricStorage<T>::readsTriangle(solver))
+            solver.compute(this->_full(A));
+        else
+            solver.compute(A);
+    }
+
 // Purely virtual functions
 protected:
     /// Initialize the ALM
@@ -317,8 +496,17 @@ protected:
     // Number of degrees of freedom
     index_t m_numDofs;
 
+    // Operators. Only the operators given to the constructor are set; the
+    // time-independent ones are called directly, without a time-dependent wrapper
     Mass_t      m_mass;
     mutable gsSparseMatrix<T> m_massInv;
+
+    /// Stiffness, damping and inverse mass matrices prepared for the products of the explicit schemes, and the kernels of these products and of the norms
+    mutable ProductMatrix m_productK, m_productC, m_productMinv;
+    mutable gsParallelKernels<T> m_kernels;
+    /// Options 'SymmetricStorage', 'BlockLayout' and 'KernelThreads', read at the start of every step by \ref _getOptions
+    mutable bool    m_symmetric;
+    mutable index_t m_blockLayout, m_kernelThreads;
     TMass_t     m_Tmass;
 
     Damping_t   m_damping;
@@ -335,6 +523,16 @@ protected:
     Residual_t  m_residual;
     TResidual_t m_Tresidual;
 
+    ResidualJacobian_t  m_residualJacobian;
+    TResidualJacobian_t m_TresidualJacobian;
+
+    /// Jacobian computed together with the last residual, and the solution and time it belongs to.
+    /// Changed by the const steps, hence these are not thread-safe
+    mutable gsSparseMatrix<T> m_fusedJacobian;
+    mutable gsVector<T>       m_fusedU;
+    mutable T                 m_fusedTime;
+    mutable bool              m_fusedValid;
+
     mutable typename gsSparseSolver<T>::uPtr m_solver; // Cholesky by default
 
 protected:
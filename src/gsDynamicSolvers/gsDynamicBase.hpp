@@ -29,6 +29,9 @@ void gsDynamicBase<T>::defaultOptions()
     m_options.addInt ("QuasiIterations","Number of iterations for quasi newton method",1);
 
     m_options.addString("Solver","Sparse linear solver", "SimplicialLDLT");
+    m_options.addInt ("KernelThreads","Number of threads of the matrix-vector products in the explicit schemes and of the norms. If 0, the serial kernels of Eigen are used for the products; if <0, the maximum number of threads is used. The results do not depend on the number of threads (>0)",0);
+    m_options.addInt ("BlockLayout","Format of the matrix-vector products in the explicit schemes: 0: scalar sparse; 1: 3x3 blocks, DoFs ordered per component, with the same number of DoFs per component; 2: 3x3 blocks, DoFs ordered per node. A matrix whose size is not a multiple of 3 is multiplied in the scalar format",0);
+    m_options.addSwitch("SymmetricStorage","The mass, damping and Jacobian operators provide only the lower triangle (column-major) of the symmetric matrices, see gsSymmetricStorage",false);
 
     m_options.addSwitch ("Verbose","Verbose output",false);
 }
@@ -60,19 +60,19 @@ gsDynamicBathe<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVect
   T c3 = (2-gamma)/((1-gamma)*dt);
 
   gsSparseMatrix<T> lhs = K + c3*c3*M + c3*C;
-  gsMatrix<T> rhs = F - M*(c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep) - C*(c2*Ustep+c1*Uold);
+  gsMatrix<T> rhs = F - this->_multiply(M,c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep) - this->_multiply(C,c2*Ustep+c1*Uold);
 
   this->_stageOutput(2);
   this->_initOutput();
   typename gsSparseSolver<T>::uPtr solver;
   solver = gsSparseSolver<T>::get( m_options.getString("Solver") ); 
-  solver->compute(lhs);
+  this->_factorize(*solver,lhs);
   U = solver->solve(rhs);
   V = c1*Uold + c2*Ustep + c3*U;
   A = c1*Vold + c2*Vstep + c3*V;
   
-  this->_stepOutput(0,(F - K*U - M * A - C * V).norm(),U.norm());
-  if (math::isinf(U.norm()) || math::isnan(U.norm()))
+  this->_stepOutput(0,this->_norm(F - this->_multiply(K,U) - this->_multiply(M,A) - this->_multiply(C,V)),this->_norm(U));
+  if (math::isinf(this->_norm(U)) || math::isnan(this->_norm(U)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -119,12 +119,12 @@ gsDynamicBathe<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVect
   V = Vstep;
   A = Astep;
 
-  rhs = R - M*(c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep+c3*c3*U) - C*(c1*Uold+c2*Ustep+c3*U);
+  rhs = R - this->_multiply(M,c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep+c3*c3*U) - this->_multiply(C,c1*Uold+c2*Ustep+c3*U);
 
   T tolU = m_options.getReal("TolU");
   T tolF = m_options.getReal("TolF");
   T updateNorm   = 10.0*tolU;
-  T residualNorm  = rhs.norm();
+  T residualNorm  = this->_norm(rhs);
   T residualNorm0 = (residualNorm!=0) ? residualNorm : 1;
   this->_initOutput();
   T Unorm, dUnorm;
@@ -141,7 +141,7 @@ gsDynamicBathe<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVect
 
     typename gsSparseSolver<T>::uPtr solver;
     solver = gsSparseSolver<T>::get( m_options.getString("Solver") ); 
-    solver->compute(lhs);
+    this->_factorize(*solver,lhs);
     // U = solver->solve(rhs);
     // V = delta/( dt*alpha ) * (U-Uold) - Vold;
     // A = 1/( dt*dt*alpha ) * (U-Uold-Vold*dt) - Aold;
@@ -149,14 +149,14 @@ gsDynamicBathe<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVect
     dU = solver->solve(rhs);
     U += dU;
 
-    Unorm = U.norm();
-    dUnorm = dU.norm();
+    Unorm = this->_norm(U);
+    dUnorm = this->_norm(dU);
     updateNorm = (Unorm!=0) ? dUnorm/Unorm : dUnorm;
 
-    this->_computeResidual(U,t+dt,R);
-    rhs = R - M*(c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep+c3*c3*U) - C*(c1*Uold+c2*Ustep+c3*U);
-    residualNorm = rhs.norm() / residualNorm0;
-    updateNorm = dU.norm() / U.norm();
+    this->_computeResidual(U,t+dt,R,!m_options.getSwitch("Quasi") || ((numIterations+1) % m_options.getInt("QuasiIterations") == 0));
+    rhs = R - this->_multiply(M,c1*Vold+c2*Vstep+c1*c3*Uold+c3*c2*Ustep+c3*c3*U) - this->_multiply(C,c1*Uold+c2*Ustep+c3*U);
+    residualNorm = this->_norm(rhs) / residualNorm0;
+    updateNorm = this->_norm(dU) / this->_norm(U);
 
     this->_stepOutput(numIterations,residualNorm,updateNorm);
 
@@ -139,6 +139,12 @@ protected:
 
     using Base::m_solver;
 
+    using Base::m_mass;
+    using Base::m_stiffness;
+    using Base::m_productK;
+    using Base::m_productC;
+    using Base::m_productMinv;
+
     using Base::m_numIterations;
 
     using Base::m_options;
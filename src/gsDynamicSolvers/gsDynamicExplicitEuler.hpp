@@ -67,20 +67,24 @@ gsDynamicExplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   // Computed at t=t0
   this->_computeMass(t,M);
   this->_computeMassInverse(M,Minv);
+  // Constant matrices (the mass matrix, and the stiffness matrix of a linear problem) are prepared for the products once
+  this->_prepareProduct(Minv,m_productMinv,m_mass!=nullptr,false);
   this->_computeForce(t,F);
   this->_computeDamping(U,t,C);
   this->_computeJacobian(U,t,K);
+  this->_prepareProduct(K,m_productK,m_stiffness!=nullptr);
+  this->_prepareProduct(C,m_productC);
 
   this->_initOutput();
   sol.topRows(N) += dt * Vold;
-  sol.bottomRows(N) += dt * Minv * (F - K * Uold - C * Vold);
-  this->_stepOutput(0,sol.norm(),0.);
+  sol.bottomRows(N) += dt * this->_multiply(Minv,m_productMinv,F - this->_multiply(K,m_productK,Uold) - this->_multiply(C,m_productC,Vold));
+  this->_stepOutput(0,this->_norm(sol),0.);
   gsDebugVar(sol.transpose());
 
   U = sol.topRows(N);
   V = sol.bottomRows(N);
 
-  if (math::isinf(sol.norm()) || math::isnan(sol.norm()))
+  if (math::isinf(this->_norm(sol)) || math::isnan(this->_norm(sol)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -107,18 +111,21 @@ gsDynamicExplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   // Computed at t=t0
   this->_computeMass(t,M);
   this->_computeMassInverse(M,Minv);
+  // Constant matrices (the mass matrix, and the stiffness matrix of a linear problem) are prepared for the products once
+  this->_prepareProduct(Minv,m_productMinv,m_mass!=nullptr,false);
   this->_computeDamping(Uold,t,C);
   this->_computeResidual(Uold,t,R);
+  this->_prepareProduct(C,m_productC);
 
   this->_initOutput();
   sol.topRows(N) += dt * Vold;
-  sol.bottomRows(N) += dt * Minv * ( - R - C * Vold);
-  this->_stepOutput(0,sol.norm(),0.);
+  sol.bottomRows(N) += dt * this->_multiply(Minv,m_productMinv,- R - this->_multiply(C,m_productC,Vold));
+  this->_stepOutput(0,this->_norm(sol),0.);
 
   U = sol.topRows(N);
   V = sol.bottomRows(N);
 
-  if (math::isinf(sol.norm()) || math::isnan(sol.norm()))
+  if (math::isinf(this->_norm(sol)) || math::isnan(this->_norm(sol)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -34,9 +34,9 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   sol.topRows(N) = U;
   sol.bottomRows(N) = V;
 
-  typename gsBlockOp<>::Ptr Amat;
+  typename gsBlockOp<T>::Ptr Amat;
 
-  Amat=gsBlockOp<>::make(2,2);
+  Amat=gsBlockOp<T>::make(2,2);
   gsGMRes<T> gmres(Amat); 
 
   gsSparseMatrix<T> eye(N,N);
@@ -56,14 +56,14 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   Amat->addOperator(0,0,gsIdentityOp<T>::make(N) );
   // top-right
   Amat->addOperator(0,1,makeMatrixOp( -dt*eye  ) );
-  // bottom-left
-  Amat->addOperator(1,0,makeMatrixOp( dt*K ) );
+  // bottom-left; the matrix operators need the full matrices in symmetric storage
+  Amat->addOperator(1,0,makeMatrixOp( dt*this->_full(K) ) );
   // bottom-right
-  Amat->addOperator(1,1,makeMatrixOp( M + dt*C ) );
+  Amat->addOperator(1,1,makeMatrixOp( this->_full(M) + dt*this->_full(C) ) );
 
   gsVector<T> rhs(2*N);
   rhs.topRows(N) = U;
-  rhs.bottomRows(N) = dt*F + M*V;
+  rhs.bottomRows(N) = dt*F + this->_multiply(M,V);
 
   gsMatrix<T> tmpsol;
   gmres.solve(rhs,tmpsol);
@@ -71,7 +71,7 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   U = tmpsol.topRows(N);
   V = tmpsol.bottomRows(N);
   this->_initOutput();
-  this->_stepOutput(0,sol.norm(),0.);
+  this->_stepOutput(0,this->_norm(sol),0.);
 
   return gsStatus::Success;
 }
@@ -93,9 +93,9 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
 
   gsMatrix<T> dsol;
 
-  typename gsBlockOp<>::Ptr Amat;
+  typename gsBlockOp<T>::Ptr Amat;
 
-  Amat=gsBlockOp<>::make(2,2);
+  Amat=gsBlockOp<T>::make(2,2);
   gsGMRes<T> gmres(Amat);
 
   gsSparseMatrix<T> eye(N,N);
@@ -107,16 +107,16 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
   // Computed at t=t0+dt
   this->_computeMass(t+dt,M);
   this->_computeDamping(U,t+dt,C);
-  this->_computeResidual(U,t+dt,R);
+  this->_computeResidual(U,t+dt,R,true);
 
   gsVector<T> rhs(2*N);
   rhs.topRows(N) = - dt * V; // same as below, but U-Uold=0
-  rhs.bottomRows(N) = dt * C * V + dt*(-R); // same as below, but V-Vold=0
+  rhs.bottomRows(N) = dt * this->_multiply(C,V) + dt*(-R); // same as below, but V-Vold=0
 
   T tolU = m_options.getReal("TolU");
   T tolF = m_options.getReal("TolF");
   T updateNorm   = 10.0*tolU;
-  T residualNorm  = rhs.norm();
+  T residualNorm  = this->_norm(rhs);
   T residualNorm0 = (residualNorm!=0) ? residualNorm : 1;
   T solnorm, dsolnorm;
   this->_initOutput();
@@ -132,24 +132,24 @@ gsDynamicImplicitEuler<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U
       
     Amat->addOperator(0,0,gsIdentityOp<T>::make(N) );
     Amat->addOperator(0,1,makeMatrixOp(-dt*eye) );
-    Amat->addOperator(1,0,makeMatrixOp(dt*K) );
-    Amat->addOperator(1,1,makeMatrixOp(M + dt*C) );
+    Amat->addOperator(1,0,makeMatrixOp(dt*this->_full(K)) );
+    Amat->addOperator(1,1,makeMatrixOp(this->_full(M) + dt*this->_full(C)) );
 
     rhs.topRows(N) = U - Uold - dt * V;
-    rhs.bottomRows(N) = M*(V - Vold) + dt * C * V + dt*(-R);
+    rhs.bottomRows(N) = this->_multiply(M,V - Vold) + dt * this->_multiply(C,V) + dt*(-R);
 
     gmres.solve(-rhs,dsol);
     sol += dsol;
 
-    solnorm = sol.norm();
-    dsolnorm = dsol.norm();
+    solnorm = this->_norm(sol);
+    dsolnorm = this->_norm(dsol);
     updateNorm = (solnorm != 0) ? dsolnorm / solnorm : dsolnorm;
 
     U = sol.topRows(N);
     V = sol.bottomRows(N);
 
     this->_computeResidual(U,t,R);
-    residualNorm = rhs.norm() / residualNorm0;
+    residualNorm = this->_norm(rhs) / residualNorm0;
 
     this->_stepOutput(numIterations,residualNorm,updateNorm);
 
@@ -55,19 +55,19 @@ gsDynamicNewmark<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVe
 
   // lhs and rhs
   lhs = M + delta*dt*C + dt*dt*alpha*K;
-  rhs = F - K*U - C * V;
+  rhs = F - this->_multiply(K,U) - this->_multiply(C,V);
 
   this->_initOutput();
   typename gsSparseSolver<T>::uPtr solver;
   solver = gsSparseSolver<T>::get( m_options.getString("Solver") ); 
-  solver->compute(lhs);
+  this->_factorize(*solver,lhs);
 
   A = solver->solve(rhs);
   V += A*delta*dt;
   U += A*alpha*dt*dt;
   
-  this->_stepOutput(0,(F - K*U - M * A - C * V).norm(),U.norm());
-  if (math::isinf(U.norm()) || math::isnan(U.norm()))
+  this->_stepOutput(0,this->_norm(F - this->_multiply(K,U) - this->_multiply(M,A) - this->_multiply(C,V)),this->_norm(U));
+  if (math::isinf(this->_norm(U)) || math::isnan(this->_norm(U)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -97,14 +97,14 @@ gsDynamicNewmark<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVe
   // Computed at t=t0+dt
   this->_computeMass(t+dt,M);
   this->_computeDamping(U,t+dt,C);
-  this->_computeResidual(U,t+dt,R);
+  this->_computeResidual(U,t+dt,R,true);
 
-  gsMatrix<T> rhs = R - C * V - M*(A);
+  gsMatrix<T> rhs = R - this->_multiply(C,V) - this->_multiply(M,A);
 
   T tolU = m_options.getReal("TolU");
   T tolF = m_options.getReal("TolF");
   T updateNorm   = 10.0*tolU;
-  T residualNorm  = rhs.norm();
+  T residualNorm  = this->_norm(rhs);
   T residualNorm0 = (residualNorm!=0) ? residualNorm : 1;
   gsVector<T> dA;
   T Anorm, dAnorm;
@@ -122,20 +122,20 @@ gsDynamicNewmark<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVe
     lhs = M + delta*dt*C + dt*dt*alpha*K;
 
     solver = gsSparseSolver<T>::get( m_options.getString("Solver") ); 
-    solver->compute(lhs);
+    this->_factorize(*solver,lhs);
 
     dA = solver->solve(rhs);
     A += dA;
     V += dA*delta*dt;
     U += dA*alpha*dt*dt;
 
-    Anorm = A.norm();
-    dAnorm = dA.norm();
+    Anorm = this->_norm(A);
+    dAnorm = this->_norm(dA);
     updateNorm = (Anorm!=0) ? dAnorm/Anorm : dAnorm;
 
-    this->_computeResidual(U,t+dt,R);
-    rhs = R - C*V - M*A;
-    residualNorm = rhs.norm() / residualNorm0;
+    this->_computeResidual(U,t+dt,R,!m_options.getSwitch("Quasi") || ((numIterations+1) % m_options.getInt("QuasiIterations") == 0));
+    rhs = R - this->_multiply(C,V) - this->_multiply(M,A);
+    residualNorm = this->_norm(rhs) / residualNorm0;
 
     this->_stepOutput(numIterations,residualNorm,updateNorm);
 
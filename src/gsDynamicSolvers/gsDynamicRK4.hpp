@@ -37,9 +37,13 @@ gsDynamicRK4<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVector
   // Computed at t=t0
   this->_computeMass(t,M);
   this->_computeMassInverse(M,Minv);
+  // Constant matrices (the mass matrix, and the stiffness matrix of a linear problem) are prepared for the products once
+  this->_prepareProduct(Minv,m_productMinv,m_mass!=nullptr,false);
   // this->_computeForce(t,F);
   this->_computeDamping(U,t,C); //C is damping
   this->_computeJacobian(U,t,K);
+  this->_prepareProduct(K,m_productK,m_stiffness!=nullptr);
+  this->_prepareProduct(C,m_productC);
 
   // this->_initOutput();
   // Initialize parameters for RK4
@@ -48,40 +52,40 @@ gsDynamicRK4<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVector
 
   //Step1 (calculate k1)
   _computeForce(t, F);
-  R = F - K * Uold;
+  R = F - this->_multiply(K,m_productK,Uold);
   k1.topRows(N) = Vold;
-  k1.bottomRows(N) = Minv * (R - C * Vold);
+  k1.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vold));
 
   //Step2 (calculate k2)
   Utmp = Uold + dt/2. * k1.topRows(N);
   Vtmp = Vold + dt/2. * k1.bottomRows(N);
   _computeForce(t + dt/2.,F);
-  R = F - K * Utmp;
+  R = F - this->_multiply(K,m_productK,Utmp);
   k2.topRows(N) = Vtmp;
-  k2.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k2.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   //Step3 (calculate k3)
   Utmp = Uold + dt/2. * k2.topRows(N);
   Vtmp = Vold + dt/2. * k2.bottomRows(N);
   _computeForce(t + dt/2., F);
-  R =  F - K * Utmp;
+  R =  F - this->_multiply(K,m_productK,Utmp);
   k3.topRows(N) = Vtmp;
-  k3.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k3.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   //Step4 (calculate k4)
   Utmp = Uold + dt/2. * k3.topRows(N);
   Vtmp = Vold + dt/2. * k3.bottomRows(N);
   _computeForce(t + dt/2., F);
-  R = F - K * Utmp;
+  R = F - this->_multiply(K,m_productK,Utmp);
   k4.topRows(N) = Vtmp;
-  k4.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k4.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   sol += 1./6 * dt * (k1 + 2.*k2 + 2.*k3 + k4);
 
   U = std::move(sol.topRows(N)); //Use std move to update vectors to avoid unnecessary copying
   V = std::move(sol.bottomRows(N));
 
-  if (math::isinf(sol.norm()) || math::isnan(sol.norm()))
+  if (math::isinf(this->_norm(sol)) || math::isnan(this->_norm(sol)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -110,9 +114,12 @@ gsDynamicRK4<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVector
   // Computed at t=t0
   this->_computeMass(t,M);
   this->_computeMassInverse(M,Minv);
+  // Constant matrices (the mass matrix, and the stiffness matrix of a linear problem) are prepared for the products once
+  this->_prepareProduct(Minv,m_productMinv,m_mass!=nullptr,false);
   // this->_computeForce(t,F);
   this->_computeDamping(U,t,C); //C is damping
   this->_computeJacobian(U,t,K);
+  this->_prepareProduct(C,m_productC);
 
   // this->_initOutput();
   // Initialize parameters for RK4
@@ -122,35 +129,35 @@ gsDynamicRK4<T,_NL>::_step_impl(const T t, const T dt, gsVector<T> & U, gsVector
   //Step1 (calculate k1)
   _computeResidual(Uold, t, R);
   k1.topRows(N) = Vold;
-  k1.bottomRows(N) = Minv * (R - C * Vold);
+  k1.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vold));
 
   //Step2 (calculate k2)
   Utmp = Uold + dt/2. * k1.topRows(N);
   Vtmp = Vold + dt/2. * k1.bottomRows(N);
   _computeResidual(Utmp,t + dt/2.,R);
   k2.topRows(N) = Vtmp;
-  k2.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k2.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   //Step3 (calculate k3)
   Utmp = Uold + dt/2. * k2.topRows(N);
   Vtmp = Vold + dt/2. * k2.bottomRows(N);
   _computeResidual(Utmp,t + dt/2.,R);
   k3.topRows(N) = Vtmp;
-  k3.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k3.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   //Step4 (calculate k4)
   Utmp = Uold + dt/2. * k3.topRows(N);
   Vtmp = Vold + dt/2. * k3.bottomRows(N);
   _computeResidual(Utmp,t + dt/2.,R);
   k4.topRows(N) = Vtmp;
-  k4.bottomRows(N) = Minv * ( R - C * Vtmp);
+  k4.bottomRows(N) = this->_multiply(Minv,m_productMinv,R - this->_multiply(C,m_productC,Vtmp));
 
   sol += 1./6 * dt * (k1 + 2.*k2 + 2.*k3 + k4);
 
   U = std::move(sol.topRows(N)); //Use std move to update vectors to avoid unnecessary copying
   V = std::move(sol.bottomRows(N));
 
-  if (math::isinf(sol.norm()) || math::isnan(sol.norm()))
+  if (math::isinf(this->_norm(sol)) || math::isnan(this->_norm(sol)))
     return gsStatus::NotConverged;
   else
     return gsStatus::Success;
@@ -53,4 +53,15 @@ namespace gismo
 	CLASS_TEMPLATE_INST gsDynamicBathe<real_t,false>;
 	CLASS_TEMPLATE_INST gsDynamicBathe<real_t,true>;
 
+	// The other precision for the explicit schemes, which are bound by the memory bandwidth: single precision, or double precision if real_t is float
+	typedef std::conditional<std::is_same<real_t,float>::value,double,float>::type other_t;
+
+	CLASS_TEMPLATE_INST gsDynamicBase<other_t>;
+
+	CLASS_TEMPLATE_INST gsDynamicExplicitEuler<other_t,false>;
+	CLASS_TEMPLATE_INST gsDynamicExplicitEuler<other_t,true>;
+
+	CLASS_TEMPLATE_INST gsDynamicRK4<other_t,false>;
+	CLASS_TEMPLATE_INST gsDynamicRK4<other_t,true>;
+
 }
@@ -43,6 +43,10 @@ public:
     /**
      * @brief      Constructor
      *
+     * The pre-stress state is computed upon the first computation, such that
+     * the option 'Solver', \ref setPrestress and \ref setLinearSolver can be
+     * used before.
+     *
      * @param      linear     The linear stiffness matrix
      * @param      rhs        The external force vector for linearization
      * @param      nonlinear  The Jacobian
@@ -61,10 +65,7 @@ public:
         {
             return m_nonlinear(x,m);
         };
-
-        m_solver = gsSparseSolver<T>::get( "SimplicialLDLT" );
-
-        m_status = this->initializeMatrix();
+        this->_init();
     }
 
   /**
@@ -84,10 +85,7 @@ public:
     m_scaling(scaling)
     {
         m_A = linear;
-
-        m_solver = gsSparseSolver<T>::get( "SimplicialLDLT" );
-
-        m_status = this->initializeMatrix();
+        this->_init();
     }
 
 
@@ -99,19 +97,22 @@ public:
     */
     gsBucklingSolver(     gsSparseMatrix<T> &linear,
                         gsSparseMatrix<T> &nonlinear )
+    :
+    m_dnonlinear(nullptr),
+    m_scaling(1.0)
     {
         m_A = linear;
         m_B = nonlinear-m_A;
+        this->_init();
+        m_initialized = true;
     }
 
-  // todo: add solver option
-  // gsOptionList defaultOptions()
-  // {
-  //   gsOptionList options;
-  //   options = Base::defaultOptions()
-  //   options.addString("Solver","Specify the sparse solver","SimplicialLDLT");
-  //   return options;
-  // }
+    gsOptionList defaultOptions() override
+    {
+        gsOptionList options = Base::defaultOptions();
+        options.addString("Solver","Sparse solver for the linear pre-stress solution","SimplicialLDLT");
+        return options;
+    }
 
     gsStatus computeSparse(const index_t number = 10)
     {
@@ -121,27 +122,287 @@ public:
         return Base::computeSparse(number);
     }
 
+    /**
+     * @brief      Sets the linear pre-stress solution, such that it is not computed from the load
+     *
+     * @param[in]  solVec  The solution of the linear problem
+     */
+    void setPrestress(const gsVector<T> & solVec)
+    {
+        m_solVec = solVec;
+        m_hasPrestress = true;
+        m_initialized = false;
+    }
+
+    /// Returns the linear pre-stress solution
+    const gsVector<T> & prestress() const { return m_solVec; }
+
+    /**
+     * @brief      Sets the solver for the linear pre-stress solution, e.g. to share a factorization of the linear stiffness matrix between solvers
+     *
+     * @param[in]  solver      The solver
+     * @param[in]  factorized  Whether \a solver contains the factorization of the linear stiffness matrix already
+     */
+    void setLinearSolver(const typename gsSparseSolver<T>::Ptr & solver, bool factorized = true)
+    {
+        m_solver = solver;
+        m_factorized = factorized;
+        m_initialized = false;
+    }
+
+    /// Returns the solver for the linear pre-stress solution
+    const typename gsSparseSolver<T>::Ptr & linearSolver() const { return m_solver; }
+
+    /**
+     * @brief      Computes the buckling modes for several load vectors with one factorization of the linear stiffness matrix
+     *
+     * The pre-stress solutions of all loads are computed in one block solve.
+     * Thereafter, the eigenvalue problem of every load is solved with
+     * compute(number). The object holds the pre-stress state and the modes of
+     * the last load afterwards.
+     *
+     * @param[in]  loads    The load vectors, stored column-wise (scaled by the scaling factor)
+     * @param[in]  number   The number of modes per load
+     * @param      values   The eigenvalues per load
+     * @param      vectors  The eigenvectors per load
+     *
+     * @return     The status of the first failing computation, or gsStatus::Success
+     */
+    gsStatus computeBatch(const gsMatrix<T> & loads, index_t number,
+                          std::vector<gsMatrix<T>> & values,
+                          std::vector<gsMatrix<T>> & vectors)
+    {
+        GISMO_ENSURE(m_dnonlinear,"The batched computation requires the Jacobian as a function");
+        GISMO_ENSURE(loads.rows()==m_A.rows(),"The loads have "<<loads.rows()<<" rows, but the system has "<<m_A.rows()<<" degrees of freedom");
+        values.clear();
+        vectors.clear();
+
+        if (!this->_factorizeLinear())
+            return m_status;
+        const gsMatrix<T> U = m_solver->solve(m_scaling*loads);
+
+        gsStatus status = gsStatus::Success;
+        for (index_t k = 0; k!=loads.cols(); k++)
+        {
+            m_solVec = U.col(k);
+            m_hasPrestress = true;
+            m_status = this->_assembleNonlinear();
+            m_initialized = (m_status==gsStatus::Success);
+            this->_resetFactorization();
+            if (m_status==gsStatus::Success)
+                this->compute(number);
+            if (m_status!=gsStatus::Success && status==gsStatus::Success)
+                status = m_status;
+            values.push_back(m_values);
+            vectors.push_back(m_vectors);
+        }
+        return status;
+    }
+
+    /**
+     * @brief      Computes linearized buckling estimates at a sequence of pre-loaded states, e.g. from a path-following analysis
+     *
+     * At state k, with displacement U_k and load factor L_k, the eigenvalue problem
+     *
+     *     K_T(U_k) phi = mu (K_T(U_{k-1}) - K_T(U_k)) / (L_k - L_{k-1}) phi
+     *
+     * is solved, with K_T the Jacobian and U_{-1} = 0, L_{-1} = 0 (i.e. the
+     * linear stiffness matrix). The eigenvalues L_k + mu are estimates of the
+     * critical load factors. The symbolic analysis of the factorizations is
+     * reused over the states, and the eigenvectors of a state are the initial
+     * subspace of the next one. The sequence stops at the first state where
+     * the Jacobian is not positive definite anymore (its lowest eigenvalue
+     * crossed zero), which follows from the inertia of its LDLT factorization.
+     * The eigenvalue problems are always solved with the sparse solvers of
+     * compute(number), also for small systems; use solver 3 (Buckling) or the
+     * native solvers.
+     *
+     * @param[in]  states  The displacements U_k
+     * @param[in]  loads   The load factors L_k, non-zero and strictly monotone (together with L_{-1} = 0)
+     * @param[in]  number  The number of modes per state
+     *
+     * @return     The status of the last computed state, or gsStatus::OtherError if the load factors are not valid
+     */
+    gsStatus computeSequence(const std::vector<gsVector<T>> & states, const std::vector<T> & loads, index_t number)
+    {
+        GISMO_ENSURE(m_dnonlinear,"The sequence computation requires the Jacobian as a function");
+        GISMO_ENSURE(states.size()==loads.size(),"The number of states ("<<states.size()<<") and load factors ("<<loads.size()<<") differ");
+        m_sequenceValues.clear();
+        m_sequenceVectors.clear();
+        m_criticalStep = -1;
+        m_criticalLoad = std::numeric_limits<T>::quiet_NaN();
+
+        // B divides by the load increments, which should not vanish nor change sign
+        const T direction = (loads.size()!=0 && loads[0] < 0) ? T(-1) : T(1);
+        for (size_t k = 0; k!=loads.size(); k++)
+            if (!(direction * (loads[k] - (k==0 ? T(0) : loads[k-1])) > 0))
+            {
+                gsWarn<<"The load factors should be non-zero and strictly monotone, but load factor "<<k<<" is "<<loads[k]<<"\n";
+                m_status = gsStatus::OtherError;
+                return m_status;
+            }
+
+        const T shift = m_options.getReal("shift");
+        const gsMatrix<T> initial = this->initialSubspace();
+        gsSparseMatrix<T> K, Kprev = m_linear;
+        T Lprev = 0;
+        m_initialized = true;
+        m_status = gsStatus::Success;
+        this->_resetFactorization();
+        for (size_t k = 0; k!=states.size(); k++)
+        {
+            try
+            {
+                if (!m_dnonlinear(states[k],gsVector<T>::Zero(states[k].rows()),K))
+                    m_status = gsStatus::AssemblyError;
+            }
+            catch (...)
+            {
+                m_status = gsStatus::AssemblyError;
+            }
+            if (m_status!=gsStatus::Success)
+                break;
+
+            m_A = K;
+            m_B = (Kprev - K) / (loads[k] - Lprev);
+            if (k==0)
+                this->_resetFactorization();
+            else
+                this->_refreshFactorization();
+
+            // Stability of the state from the inertia of the Jacobian
+            if (shift==0)
+            {
+                const Factorization_t & factor = this->_factorize(0);
+                if (factor.info()==gsEigen::ComputationInfo::Success && (factor.vectorD().array() < 0).any())
+                {
+                    m_criticalStep = k;
+                    // The estimate of the previous state, bounded by the load factors of both states
+                    if (k!=0 && m_sequenceValues.back().rows()!=0)
+                        m_criticalLoad = math::min(math::max(m_sequenceValues.back()(0,0),Lprev),loads[k]);
+                    else
+                        m_criticalLoad = loads[k];
+                    break;
+                }
+            }
+
+            // The sparse solvers use the stored factorizations and start from the modes of the previous state
+            this->_computeIterative(number);
+            if (m_status!=gsStatus::Success)
+                break;
+
+            m_values.array() += loads[k];
+            m_sequenceValues.push_back(m_values);
+            m_sequenceVectors.push_back(m_vectors);
+            this->setInitialSubspace(m_vectors);
+
+            Kprev.swap(K);
+            Lprev = loads[k];
+        }
+
+        // Restore the linear problem
+        this->setInitialSubspace(initial);
+        m_A = m_linear;
+        m_initialized = false;
+        this->_resetFactorization();
+        return m_status;
+    }
+
+    /// Returns the estimates of the critical load factors per state of the last call to \ref computeSequence
+    const std::vector<gsMatrix<T>> & sequenceValues() const { return m_sequenceValues; }
+
+    /// Returns the modes per state of the last call to \ref computeSequence
+    const std::vector<gsMatrix<T>> & sequenceVectors() const { return m_sequenceVectors; }
+
+    /// Returns the index of the first state of the last call to \ref computeSequence that is not stable, or -1
+    index_t criticalStep() const { return m_criticalStep; }
+
+    /// Returns the estimate of the critical load factor when the last call to \ref computeSequence passed a critical point, or NaN
+    T criticalLoad() const { return m_criticalLoad; }
 
 protected:
 
-    gsStatus initializeMatrix()
+    typedef typename Base::Factorization_t Factorization_t;
+
+    void _init()
+    {
+        m_linear = m_A;
+        m_criticalStep = -1;
+        m_criticalLoad = std::numeric_limits<T>::quiet_NaN();
+        m_options = this->defaultOptions();
+        m_hasPrestress = false;
+        m_factorized = false;
+        m_initialized = false;
+        m_status = gsStatus::NotStarted;
+    }
+
+    /// Computes the pre-stress state and the matrix B upon the first computation. A failed initialization is repeated by the next computation
+    gsStatus _initialize() override
+    {
+        if (!m_initialized)
+        {
+            const gsStatus status = this->initializeMatrix();
+            if (status!=gsStatus::Success)
+                return status;
+            m_initialized = true;
+            this->_resetFactorization();
+        }
+        return gsStatus::Success;
+    }
+
+    /// Factorizes the linear stiffness matrix, if not done yet
+    bool _factorizeLinear()
+    {
+        if (!m_solver)
+        {
+            m_solver = gsSparseSolver<T>::get( m_options.getString("Solver") );
+            m_factorized = false;
+        }
+        if (!m_factorized)
+        {
+            m_solver->compute(m_linear);
+            if (m_solver->info()!=gsEigen::ComputationInfo::Success)
+            {
+                gsWarn<<"Factorization of the linear stiffness matrix failed.\n";
+                m_status = gsStatus::SolverError;
+                return false;
+            }
+            m_factorized = true;
+        }
+        return true;
+    }
+
+    /// Computes B = K_NL(u) - K_L for the pre-stress state u
+    gsStatus _assembleNonlinear()
     {
-        bool verbose = m_options.getSwitch("verbose");
-        if (verbose) { gsInfo<<"Computing matrices" ; }
-        m_solver->compute(m_A);
-        if (verbose) { gsInfo<<"." ; }
-        m_solVec = m_solver->solve(m_scaling*m_rhs);
-        if (verbose) { gsInfo<<"." ; }
         try
         {
-            m_dnonlinear(m_solVec,gsVector<T>::Zero(m_solVec.rows()),m_B);
+            if (!m_dnonlinear(m_solVec,gsVector<T>::Zero(m_solVec.rows()),m_B))
+                return gsStatus::AssemblyError;
         }
         catch (...)
         {
-            m_status = gsStatus::AssemblyError;
-            return m_status;
+            return gsStatus::AssemblyError;
+        }
+        m_B -= m_linear;
+        return gsStatus::Success;
+    }
+
+    gsStatus initializeMatrix()
+    {
+        bool verbose = m_options.getSwitch("verbose");
+        if (verbose) { gsInfo<<"Computing matrices" ; }
+        if (!m_hasPrestress)
+        {
+            if (!this->_factorizeLinear())
+                return m_status;
+            if (verbose) { gsInfo<<"." ; }
+            m_solVec = m_solver->solve(m_scaling*m_rhs);
         }
-        m_B -= m_A;
+        if (verbose) { gsInfo<<"." ; }
+        m_status = this->_assembleNonlinear();
+        if (m_status!=gsStatus::Success)
+            return m_status;
         if (verbose) { gsInfo<<"." ; }
         if (verbose) { gsInfo<<"Finished\n" ; }
 
@@ -157,10 +418,23 @@ protected:
     T m_scaling;
     using Base::m_B;
 
+    using Base::m_values;
+    using Base::m_vectors;
 
     /// Linear solver employed
-    mutable typename gsSparseSolver<T>::uPtr m_solver;
-    gsVector<> m_solVec;
+    typename gsSparseSolver<T>::Ptr m_solver;
+    gsVector<T> m_solVec;
+
+    /// Copy of the linear stiffness matrix, since A changes in \ref computeSequence
+    gsSparseMatrix<T> m_linear;
+
+    /// Results of \ref computeSequence
+    std::vector<gsMatrix<T>> m_sequenceValues, m_sequenceVectors;
+    index_t m_criticalStep;
+    T m_criticalLoad;
+
+    /// Whether the pre-stress solution is given, whether m_solver contains the factorization of m_A and whether B is computed
+    bool m_hasPrestress, m_factorized, m_initialized;
 
     using Base::m_options;
 
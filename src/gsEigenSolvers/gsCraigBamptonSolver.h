@@ -0,0 +1,130 @@
+ /** @file gsCraigBamptonSolver.h
+
+    @brief Performs modal analysis by component mode synthesis (Craig-Bampton)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsStructuralAnalysis/src/gsEigenSolvers/gsModalSolver.h>
+
+#pragma once
+
+
+namespace gismo
+{
+
+/**
+    @brief Performs modal analysis by component mode synthesis (Craig-Bampton)
+
+    The degrees of freedom are partitioned into the interior degrees of
+    freedom of a number of substructures (e.g. the patches of a multipatch)
+    and the interface degrees of freedom. The interior degrees of freedom of
+    different substructures should not be coupled in the stiffness and mass
+    matrices, see \ref partition.
+
+    Per substructure, the lowest fixed-interface modes and the constraint
+    modes (the static response of the interior to unit interface
+    displacements) are computed in parallel (OpenMP). The reduced system,
+    with the modal coordinates of all substructures and the interface
+    degrees of freedom as unknowns, is solved with a dense solver. The
+    eigenvectors are recovered on all degrees of freedom if the option
+    'Recover' is set, and given in the reduced coordinates otherwise.
+
+    \tparam T           coefficient type
+
+    \ingroup gsModalSolver
+*/
+template <class T>
+class gsCraigBamptonSolver : public gsEigenProblemBase<T>
+{
+protected:
+
+    typedef gsEigenProblemBase<T> Base;
+
+public:
+
+    /**
+     * @brief      Constructor
+     *
+     * @param      stiffness  The stiffness matrix
+     * @param      mass       The mass matrix
+     * @param[in]  partition  The substructure (>=0) of every degree of freedom, or -1 for interface degrees of freedom
+     */
+    gsCraigBamptonSolver(   const gsSparseMatrix<T> &stiffness,
+                            const gsSparseMatrix<T> &mass,
+                            const std::vector<index_t> & partition)
+    :
+    m_partition(partition)
+    {
+        GISMO_ENSURE((index_t)(partition.size())==stiffness.rows(),"The partition has "<<partition.size()<<" entries, but the system has "<<stiffness.rows()<<" degrees of freedom");
+        m_A = stiffness;
+        m_B = mass;
+        m_options = this->defaultOptions();
+    }
+
+    gsOptionList defaultOptions() override
+    {
+        gsOptionList options = Base::defaultOptions();
+        options.addInt("InteriorModes","Number of fixed-interface modes per substructure",10);
+        options.addSwitch("Recover","Recover the eigenvectors on all degrees of freedom",true);
+        return options;
+    }
+
+    using Base::compute;
+
+    /// Computes \a number eigenpairs of the reduced system
+    gsStatus compute(const index_t number) override;
+
+    /// Returns the reduced stiffness matrix of the last computation
+    const gsMatrix<T> & reducedStiffness() const { return m_Kr; }
+
+    /// Returns the reduced mass matrix of the last computation
+    const gsMatrix<T> & reducedMass() const { return m_Mr; }
+
+    /**
+     * @brief      Makes a partition from the substructure that owns every degree of freedom
+     *
+     * Of every pair of degrees of freedom of different substructures that are
+     * coupled in \a matrix, the one of the substructure with the highest
+     * index is marked as interface degree of freedom.
+     *
+     * @param[in]  matrix  The stiffness (or mass) matrix
+     * @param[in]  owner   The substructure of every degree of freedom
+     *
+     * @return     The partition, with -1 for the interface degrees of freedom
+     */
+    static std::vector<index_t> partition(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & owner);
+
+protected:
+
+    /// Returns the sparse matrix selecting the entries \a indices from a vector of size \a n
+    static gsSparseMatrix<T> _selector(const std::vector<index_t> & indices, index_t n);
+
+protected:
+
+    using Base::m_A;
+    using Base::m_B;
+    using Base::m_options;
+    using Base::m_values;
+    using Base::m_vectors;
+    using Base::m_status;
+
+    std::vector<index_t> m_partition;
+
+    /// Reduced stiffness and mass matrices
+    gsMatrix<T> m_Kr, m_Mr;
+};
+
+
+} // namespace gismo
+
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsCraigBamptonSolver.hpp)
+#endif
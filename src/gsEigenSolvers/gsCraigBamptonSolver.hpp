@@ -0,0 +1,198 @@
+ /** @file gsCraigBamptonSolver.hpp
+
+    @brief Performs modal analysis by component mode synthesis (Craig-Bampton)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsParallel/gsOpenMP.h>
+#pragma once
+
+namespace gismo
+{
+
+template <class T>
+gsStatus gsCraigBamptonSolver<T>::compute(const index_t number)
+{
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
+        return m_status;
+
+    bool verbose = m_options.getSwitch("verbose");
+    const index_t n = m_A.rows();
+
+    // Index sets of the substructures and the interface
+    index_t numSub = 0;
+    for (size_t i = 0; i!=m_partition.size(); i++)
+        numSub = std::max(numSub,m_partition[i]+1);
+    std::vector<std::vector<index_t>> interior(numSub);
+    std::vector<index_t> interface;
+    for (index_t i = 0; i!=n; i++)
+    {
+        if (m_partition[i] < 0)
+            interface.push_back(i);
+        else
+            interior[m_partition[i]].push_back(i);
+    }
+    const index_t nb = interface.size();
+    const gsSparseMatrix<T> Pb = _selector(interface,n);
+
+    if (verbose) { gsInfo<<"Computing the modes of "<<numSub<<" substructures with "<<nb<<" interface degrees of freedom\n"; }
+
+    std::vector<gsMatrix<T>> Phi(numSub), Psi(numSub), Mcoup(numSub), Kbb(numSub), Mbb(numSub);
+    std::vector<gsVector<T>> lambda(numSub);
+    std::vector<gsStatus> status(numSub,gsStatus::Success);
+
+#pragma omp parallel for schedule(dynamic,1)
+    for (index_t s = 0; s < numSub; s++)
+    {
+        const index_t ns = interior[s].size();
+        const index_t ks = std::min(m_options.getInt("InteriorModes"),ns);
+        if (ns==0)
+            continue;
+
+        const gsSparseMatrix<T> Ps = _selector(interior[s],n);
+        const gsSparseMatrix<T> Kii = Ps * m_A * Ps.transpose();
+        const gsSparseMatrix<T> Mii = Ps * m_B * Ps.transpose();
+        const gsSparseMatrix<T> Kib = Ps * m_A * Pb.transpose();
+        const gsSparseMatrix<T> Mib = Ps * m_B * Pb.transpose();
+
+        // Constraint modes, Psi = -Kii^-1 Kib
+        typename gsSparseSolver<T>::SimplicialLDLT solver;
+        solver.compute(Kii);
+        if (solver.info()!=gsEigen::ComputationInfo::Success)
+        {
+            status[s] = gsStatus::SolverError;
+            continue;
+        }
+        const gsMatrix<T> KibDense = Kib.toDense();
+        const gsMatrix<T> MibDense = Mib.toDense();
+        Psi[s] = -solver.solve(KibDense);
+
+        // Fixed-interface modes, mass-normalized
+        if (ks > 0)
+        {
+            gsModalSolver<T> modal(Kii,Mii);
+            modal.options().setSwitch("verbose",false);
+            status[s] = modal.compute(ks);
+            if (status[s]!=gsStatus::Success)
+                continue;
+            Phi[s] = modal.vectors().leftCols(ks);
+            lambda[s] = modal.values().topRows(ks);
+            for (index_t k = 0; k!=ks; k++)
+                Phi[s].col(k) /= math::sqrt(Phi[s].col(k).dot(Mii * Phi[s].col(k)));
+        }
+        else
+        {
+            Phi[s].resize(ns,0);
+            lambda[s].resize(0);
+        }
+
+        // Contributions to the reduced system. The stiffness coupling between the modes and the interface vanishes, since Kii Psi + Kib = 0
+        const gsMatrix<T> MiiPsi = Mii * Psi[s];
+        Mcoup[s] = Phi[s].transpose() * (MiiPsi + MibDense);
+        Kbb[s]   = KibDense.transpose() * Psi[s];
+        Mbb[s]   = Psi[s].transpose() * (MiiPsi + MibDense);
+        Mbb[s]  += (Psi[s].transpose() * MibDense).transpose();
+    }
+
+    for (index_t s = 0; s!=numSub; s++)
+        if (status[s]!=gsStatus::Success)
+        {
+            gsWarn<<"The modes of substructure "<<s<<" could not be computed.\n";
+            m_status = status[s];
+            return m_status;
+        }
+
+    // Assemble the reduced system
+    std::vector<index_t> offset(numSub+1,0);
+    for (index_t s = 0; s!=numSub; s++)
+        offset[s+1] = offset[s] + lambda[s].rows();
+    const index_t nm = offset[numSub];
+    const index_t nr = nm + nb;
+
+    m_Kr.setZero(nr,nr);
+    m_Mr.setZero(nr,nr);
+    const gsSparseMatrix<T> Kbb0 = Pb * m_A * Pb.transpose();
+    const gsSparseMatrix<T> Mbb0 = Pb * m_B * Pb.transpose();
+    m_Kr.bottomRightCorner(nb,nb) = Kbb0.toDense();
+    m_Mr.bottomRightCorner(nb,nb) = Mbb0.toDense();
+    for (index_t s = 0; s!=numSub; s++)
+    {
+        const index_t ks = lambda[s].rows();
+        if (interior[s].size()==0)
+            continue;
+        m_Kr.block(offset[s],offset[s],ks,ks) = lambda[s].asDiagonal();
+        m_Mr.block(offset[s],offset[s],ks,ks).setIdentity();
+        m_Mr.block(offset[s],nm,ks,nb) = Mcoup[s];
+        m_Mr.block(nm,offset[s],nb,ks) = Mcoup[s].transpose();
+        m_Kr.bottomRightCorner(nb,nb) += Kbb[s];
+        m_Mr.bottomRightCorner(nb,nb) += Mbb[s];
+    }
+    m_Kr = ((m_Kr + m_Kr.transpose()) / 2).eval();
+    m_Mr = ((m_Mr + m_Mr.transpose()) / 2).eval();
+
+    if (verbose) { gsInfo<<"Solving the reduced eigenvalue problem of size "<<nr<<"\n"; }
+    GISMO_ENSURE(number <= nr,"The number of requested eigenvalues ("<<number<<") is larger than the size of the reduced problem ("<<nr<<")");
+    gsEigen::GeneralizedSelfAdjointEigenSolver<typename gsMatrix<T>::Base> es(m_Kr,m_Mr);
+    if (es.info()!=gsEigen::ComputationInfo::Success)
+    {
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+    m_values = es.eigenvalues().head(number);
+    const gsMatrix<T> q = es.eigenvectors().leftCols(number);
+
+    if (!m_options.getSwitch("Recover"))
+        m_vectors = q;
+    else
+    {
+        // Full field recovery, u_i = Phi q_s + Psi u_b
+        m_vectors.resize(n,number);
+        const gsMatrix<T> ub = q.bottomRows(nb);
+        for (index_t k = 0; k!=nb; k++)
+            m_vectors.row(interface[k]) = ub.row(k);
+        for (index_t s = 0; s!=numSub; s++)
+        {
+            if (interior[s].size()==0)
+                continue;
+            const gsMatrix<T> ui = Phi[s] * q.middleRows(offset[s],lambda[s].rows()) + Psi[s] * ub;
+            for (size_t k = 0; k!=interior[s].size(); k++)
+                m_vectors.row(interior[s][k]) = ui.row(k);
+        }
+    }
+
+    m_status = gsStatus::Success;
+    return m_status;
+}
+
+template <class T>
+std::vector<index_t> gsCraigBamptonSolver<T>::partition(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & owner)
+{
+    GISMO_ENSURE((index_t)(owner.size())==matrix.rows(),"The owners have "<<owner.size()<<" entries, but the matrix has "<<matrix.rows()<<" rows");
+    std::vector<index_t> result = owner;
+    for (index_t j = 0; j!=matrix.outerSize(); j++)
+        for (typename gsSparseMatrix<T>::InnerIterator it(matrix,j); it; ++it)
+            if (owner[it.row()]!=owner[it.col()])
+                result[owner[it.row()] > owner[it.col()] ? it.row() : it.col()] = -1;
+    return result;
+}
+
+template <class T>
+gsSparseMatrix<T> gsCraigBamptonSolver<T>::_selector(const std::vector<index_t> & indices, index_t n)
+{
+    gsSparseMatrix<T> P(indices.size(),n);
+    P.reserve(gsVector<index_t>::Ones(n));
+    for (size_t k = 0; k!=indices.size(); k++)
+        P.insert(k,indices[k]) = 1;
+    P.makeCompressed();
+    return P;
+}
+
+} // namespace gismo
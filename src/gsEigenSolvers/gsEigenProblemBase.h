@@ -12,6 +12,9 @@
 */
 
 #include <typeinfo>
+#include <map>
+#include <deque>
+#include <functional>
 
 #include <gsCore/gsLinearAlgebra.h>
 #ifdef gsSpectra_ENABLED
@@ -58,7 +61,8 @@ public:
                                     "1: RegularInverse"
                                     "2: ShiftInvert"
                                     "3: Buckling"
-                                    "4: Cayley",0);
+                                    "4: Cayley"
+                                    "5: LOBPCG (native, does not require Spectra)",0);
 
         options.addInt("selectionRule","Selection rule to be used (see Spectra documentation):"
                                         "0: LargestMagn"
@@ -83,8 +87,17 @@ public:
                                         "8: BothEnds",4);
 
         options.addInt("ncvFac","Factor for Spectra's ncv number. Ncv = ncvFac * numEigenvalues",3);
+        options.addInt("spectraMaxIt","Maximum number of iterations for Spectra",1000);
+        options.addInt("maxAttempts","Maximum number of attempts of computeSparse. After a failure, the Krylov subspace is enlarged, the shift is moved or the mode is switched",3);
 	    options.addReal("tolerance","Tolerance for spectra and the power method",1e-10);
         options.addReal("shift","Shift for the eigenvalue solver",0.0);
+        options.addInt("maxIt","Maximum number of iterations for the power and subspace iterations",100);
+        options.addInt("denseThreshold","Maximum system size for which compute(number) uses the dense solver",2000);
+        options.addInt("positiveB","Whether B is positive definite, for the LOBPCG solver: -1: unknown, tested on the Gram matrices of the Rayleigh-Ritz steps; 0: no; 1: yes",-1);
+        options.addString("preconditioner","Preconditioner for the LOBPCG solver: None, Jacobi, IncompleteCholesky, or the name of a gsSparseSolver used as approximate inverse of A - shift*B","Jacobi");
+        options.addSwitch("trackModes","Reorder the computed modes to match the initial subspace (see setInitialSubspace) by the modal assurance criterion",false);
+        options.addInt("factorizationCache","Maximum number of factorizations of A - shift*B that are stored for repeated solves with the same shift",2);
+        options.addReal("memoryLimit","Memory limit in MB for the eigenvalue solvers. The solvers refuse to start when their estimated memory exceeds the limit. If negative, no limit is applied",-1);
         return options;
     }
 
@@ -94,12 +107,123 @@ public:
     /// Set the options from \a options
     virtual void setOptions(gsOptionList & options) {m_options.update(options,gsOptionList::addIfUnknown); }
 
+    /// Computes all eigenpairs with a dense solver
     virtual gsStatus compute();
 
+    /**
+     * @brief      Computes \a number eigenpairs
+     *
+     * For systems up to the size given by the option 'denseThreshold', the
+     * dense solver is used and the eigenpairs of smallest magnitude are kept,
+     * provided that the shift is zero and the options 'solver' and
+     * 'selectionRule' have their defaults. Otherwise, and for larger systems,
+     * the sparse solvers are used: \ref computeLOBPCG (option 'solver'
+     * 5), \ref computeSparse (with Spectra) or \ref computeSubspace. The
+     * solver refuses to start with gsStatus::MemoryError when the estimated
+     * memory exceeds the option 'memoryLimit'.
+     *
+     * @param[in]  number  The number of eigenpairs
+     */
+    virtual gsStatus compute(const index_t number);
+
+    /**
+     * @brief      Computes \a number eigenpairs with Spectra
+     *
+     * When Spectra does not converge, the computation is repeated with a
+     * larger Krylov subspace, and with the shift moved towards the converged
+     * Ritz values if the shift is zero. On numerical issues, the computation
+     * is repeated in the shift-invert or Cayley mode. The number of attempts
+     * is limited by the option 'maxAttempts', see also \ref attemptTimes.
+     *
+     * @param[in]  number  The number of eigenpairs
+     */
     virtual gsStatus computeSparse(const index_t number = 10);
 
+    /// Returns the wall-clock times (in seconds) of the attempts of the last call to \ref computeSparse
+    const std::vector<double> & attemptTimes() const { return m_attemptTimes; }
+
+    /// Returns the number of attempts of the last call to \ref computeSparse
+    index_t attempts() const { return m_attemptTimes.size(); }
+
+    /// Computes the eigenpair closest to the shift by inverse iteration with a sparse factorization of A - shift*B
     virtual gsStatus computePower();
 
+    /// Computes \a number eigenpairs closest to the shift by block subspace iteration with Rayleigh-Ritz projection
+    virtual gsStatus computeSubspace(const index_t number = 10);
+
+    /**
+     * @brief      Computes all eigenpairs with eigenvalues in [lower, upper] by spectrum slicing
+     *
+     * The interval is split into \a slices slices of equal width. The number
+     * of eigenvalues in every slice follows from the inertia of the LDLT
+     * factorizations of A - sigma*B at the slice edges, which requires B to be
+     * positive definite. The slices are solved in parallel (OpenMP) by
+     * shift-invert subspace iteration around their centers. Pairs found twice
+     * at an edge are removed. The eigenvalues are sorted in ascending order.
+     *
+     * @param[in]  lower   The lower bound of the interval
+     * @param[in]  upper   The upper bound of the interval
+     * @param[in]  slices  The number of slices
+     */
+    virtual gsStatus computeSlicing(T lower, T upper, index_t slices);
+
+    /**
+     * @brief      Computes the \a number smallest eigenpairs of (A - shift*B, B) with the
+     *             locally optimal block preconditioned conjugate gradient method (LOBPCG)
+     *
+     * The method does not factorize any matrix, except in the preconditioner
+     * if the option 'preconditioner' asks for it. Converged pairs are softly
+     * locked: they stay in the Rayleigh-Ritz basis but do not get new search
+     * directions. When B is not positive definite (e.g. buckling), the method
+     * is applied to (-B, A - shift*B), which gives the smallest positive
+     * eigenvalues first. Whether B is positive definite is given by the
+     * option 'positiveB'. By default, it is tested on the Gram matrices of
+     * the blocks of the Rayleigh-Ritz steps: when one of them is indefinite,
+     * the method restarts on (-B, A - shift*B). The preconditioner is set by
+     * the option 'preconditioner' or by \ref setPreconditioner.
+     *
+     * @param[in]  number  The number of eigenpairs
+     */
+    virtual gsStatus computeLOBPCG(const index_t number = 10);
+
+    /// Preconditioner for LOBPCG, computing W = T R for a block of residuals R, with T approximating (A - shift*B)^-1
+    typedef std::function<void(const gsMatrix<T> & R, gsMatrix<T> & W)> Preconditioner_t;
+
+    /// Sets a preconditioner for LOBPCG, which overrides the option 'preconditioner'. An empty function removes it
+    void setPreconditioner(const Preconditioner_t & preconditioner) { m_preconditioner = preconditioner; }
+
+    /**
+     * @brief      Sets the initial subspace of the next solves, e.g. the eigenvectors of a
+     *             previous, nearby problem in a design or parameter sweep
+     *
+     * The subspace is used as initial block of \ref computeSubspace and
+     * \ref computeLOBPCG, and its sum as initial vector of \ref computeSparse.
+     * When the option 'trackModes' is set, the computed modes are reordered
+     * such that mode i matches column i of the subspace best, see \ref MAC.
+     *
+     * @param[in]  vectors  The vectors, stored column-wise. An empty matrix removes the subspace
+     */
+    void setInitialSubspace(const gsMatrix<T> & vectors) { m_initial = vectors; }
+
+    /// Returns the initial subspace
+    const gsMatrix<T> & initialSubspace() const { return m_initial; }
+
+    /**
+     * @brief      Computes the modal assurance criterion (MAC) between the computed modes and \a reference
+     *
+     * MAC(i,j) = (r_i . v_j)^2 / ((r_i . r_i) (v_j . v_j)), with r_i the columns
+     * of \a reference and v_j the computed modes. A value of 1 means that the
+     * modes are parallel, a value of 0 that they are orthogonal.
+     *
+     * @param[in]  reference  The reference modes, stored column-wise
+     *
+     * @return     The MAC matrix, with a row per reference mode and a column per computed mode
+     */
+    gsMatrix<T> MAC(const gsMatrix<T> & reference) const;
+
+    /// Returns the MAC of every computed mode with the mode of the initial subspace it is matched to (0 if unmatched), when the option 'trackModes' is set
+    const gsVector<T> & trackedMAC() const { return m_trackedMAC; }
+
     virtual const gsMatrix<T> & values() const { return m_values; };
     virtual T value(int k) const { return m_values.at(k); };
 
@@ -112,7 +236,105 @@ protected:
 
     virtual std::vector<std::pair<T,gsMatrix<T>> > makeMode(int k) const;
 
+    /// Computes all eigenpairs with the dense solver, without the checks of \ref compute and without tracking the modes
+    gsStatus _computeDense();
+
+    /// Computes \a number eigenpairs with the sparse solvers of \ref compute(number), which use the initial subspace and the stored factorizations
+    gsStatus _computeIterative(const index_t number);
+
+    /// Prepares the matrices A and B before a computation, e.g. by assembly in derived classes. Returns the status of the preparation; the computations stop if it is not gsStatus::Success
+    virtual gsStatus _initialize() { return gsStatus::Success; }
+
+    typedef typename gsSparseSolver<T>::SimplicialLDLT Factorization_t;
+
+    /// Returns the factorization of A - shift*B. Factorizations are stored per shift, see the option 'factorizationCache'
+    memory::shared_ptr<Factorization_t> _factorization(T shift);
+
+    /// Returns the factorization of A - shift*B, see \ref _factorization
+    const Factorization_t & _factorize(T shift) { return *_factorization(shift); }
+
+    /// Returns the estimated memory (in MB) of the dense solver
+    T _denseMemory() const;
+
+    /// Returns the estimated memory (in MB) of the sparse solvers for \a number eigenpairs
+    T _sparseMemory(index_t number) const;
+
+    /**
+     * @brief      Shift-invert subspace iteration with a given factorization. The function does not modify the object
+     *
+     * @param[in]  solver  The factorization of A - shift*B
+     * @param[in]  shift   The shift
+     * @param[in]  number  The number of pairs (closest to the shift) that should converge
+     * @param      X       The initial block, and the Ritz vectors sorted by the distance of their value to the shift
+     * @param      values  The Ritz values, in the same order
+     */
+    gsStatus _subspaceIteration(const Factorization_t & solver, T shift, index_t number,
+                                gsMatrix<T> & X, gsVector<T> & values) const;
+
+    /// Fills the columns of \a X with the initial subspace, completed by random vectors
+    void _initialBlock(gsMatrix<T> & X) const;
+
+    /// Reorders the computed modes such that they match the initial subspace, if the option 'trackModes' is set
+    void _trackModes();
+
+    /// Constructs the preconditioner for \a K from the option 'preconditioner'. Returns an empty function when its construction fails
+    Preconditioner_t _preconditioner(const gsSparseMatrix<T> & K) const;
+
+    /// Removes the stored factorizations, to be called when A or B change
+    void _resetFactorization() { m_factors.clear(); m_factorShifts.clear(); m_outdatedFactors.clear(); }
+
+    /// Marks the stored factorizations as outdated, to be called when A or B change without changing their sparsity pattern. The symbolic analysis is reused
+    void _refreshFactorization()
+    {
+        m_outdatedFactors.insert(m_factors.begin(),m_factors.end());
+        m_factors.clear();
+        m_factorShifts.clear();
+    }
+
 private:
+    #ifdef gsSpectra_ENABLED
+    /// Computes \a number eigenpairs with Spectra in the mode given by the option 'solver'
+    gsStatus _computeSparse(const index_t number);
+    #endif
+
+    #ifdef gsSpectra_ENABLED
+    /**
+        @brief Spectra operator y = (A - shift*B)^-1 x, using the factorizations stored in the eigenvalue problem
+
+        Spectra calls \ref set_shift upon construction of the solver. The
+        factorization is only computed when no factorization for the shift is
+        stored, hence repeated solves at the same shift skip the factorization.
+    */
+    class ShiftInvertOp
+    {
+    public:
+        typedef T Scalar;
+
+        ShiftInvertOp(gsEigenProblemBase<T> * problem) : m_problem(problem) { }
+
+        index_t rows() const { return m_problem->m_A.rows(); }
+        index_t cols() const { return m_problem->m_A.cols(); }
+
+        void set_shift(const Scalar & sigma)
+        {
+            m_factor = m_problem->_factorization(sigma);
+            if (m_factor->info()!=gsEigen::ComputationInfo::Success)
+                throw std::invalid_argument("gsEigenProblemBase: factorization of A - shift*B failed");
+        }
+
+        void perform_op(const Scalar * x_in, Scalar * y_out) const
+        {
+            gsEigen::Map<const typename gsVector<T>::Base> x(x_in, this->rows());
+            gsEigen::Map<typename gsVector<T>::Base> y(y_out, this->rows());
+            y.noalias() = m_factor->solve(x);
+        }
+
+    private:
+        gsEigenProblemBase<T> * m_problem;
+        memory::shared_ptr<Factorization_t> m_factor;
+    };
+    #endif
+
     #ifdef gsSpectra_ENABLED
     template<Spectra::GEigsMode _GEigsMode>
     typename std::enable_if<_GEigsMode==Spectra::GEigsMode::Cholesky ||
@@ -143,6 +365,22 @@ protected:
 
     index_t m_num;
 
+    /// Factorizations of A - shift*B per shift, and the shifts in order of computation
+    std::map<T,memory::shared_ptr<Factorization_t>> m_factors;
+    std::deque<T> m_factorShifts;
+    /// Outdated factorizations per shift, of which the symbolic analysis can be reused
+    std::map<T,memory::shared_ptr<Factorization_t>> m_outdatedFactors;
+
+    /// Initial subspace and the MAC of the tracked modes
+    gsMatrix<T> m_initial;
+    gsVector<T> m_trackedMAC;
+
+    /// Wall-clock times of the attempts of computeSparse
+    std::vector<double> m_attemptTimes;
+
+    /// User-defined preconditioner for LOBPCG
+    Preconditioner_t m_preconditioner;
+
     gsStatus m_status;
 };
 
@@ -12,6 +12,8 @@
 */
 
 #include <typeinfo>
+#include <gsParallel/gsOpenMP.h>
+#include <gsUtils/gsStopwatch.h>
 #pragma once
 
 namespace gismo
@@ -20,25 +22,67 @@ namespace gismo
 template <class T>
 gsStatus gsEigenProblemBase<T>::compute()
 {
-    if (m_status==gsStatus::AssemblyError)
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
         return m_status;
 
+    T memoryLimit = m_options.getReal("memoryLimit");
+    if (memoryLimit >= 0 && _denseMemory() > memoryLimit)
+    {
+        gsWarn<<"The dense eigenvalue solver requires approximately "<<_denseMemory()<<" MB, which exceeds the memory limit of "<<memoryLimit<<" MB. Use compute(number), computeSparse or computeSubspace instead.\n";
+        m_status = gsStatus::MemoryError;
+        return m_status;
+    }
+
+    if (this->_computeDense()==gsStatus::Success)
+        this->_trackModes();
+    return m_status;
+};
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::_computeDense()
+{
     bool verbose = m_options.getSwitch("verbose");
     if (verbose) { gsInfo<<"Solving eigenvalue problem" ; }
     try
     {
         T shift = m_options.getReal("shift");
-        if (shift!=0.0)
-            m_eigSolver.compute(m_A-shift*m_B,m_B);
-        else
-            m_eigSolver.compute(m_A,m_B);
+        // B is only tested for positive definiteness, hence its sparse factorization suffices
+        typename gsSparseSolver<T>::SimplicialLLT llt(m_B);
+        if (llt.info()==gsEigen::ComputationInfo::Success)
+        {
+            if (shift!=0.0)
+                m_eigSolver.compute(m_A-shift*m_B,m_B);
+            else
+                m_eigSolver.compute(m_A,m_B);
 
-        if (verbose) { gsInfo<<"." ; }
-        m_values  = m_eigSolver.eigenvalues();
-        m_values.array() += shift;
-        if (verbose) { gsInfo<<"." ; }
-        m_vectors = m_eigSolver.eigenvectors();
-        if (verbose) { gsInfo<<"." ; }
+            if (verbose) { gsInfo<<"." ; }
+            m_values  = m_eigSolver.eigenvalues();
+            m_values.array() += shift;
+            if (verbose) { gsInfo<<"." ; }
+            m_vectors = m_eigSolver.eigenvectors();
+            if (verbose) { gsInfo<<"." ; }
+        }
+        else
+        {
+            // B is not positive definite (e.g. buckling): solve B x = mu (A - shift*B) x, with lambda = shift + 1/mu.
+            // The eigenpairs are sorted by their distance to the shift
+            m_eigSolver.compute(m_B,m_A-shift*m_B);
+            if (verbose) { gsInfo<<"." ; }
+            gsVector<T> mu = m_eigSolver.eigenvalues();
+            std::vector<index_t> order(mu.size());
+            for (size_t k = 0; k!=order.size(); k++) order[k] = k;
+            std::sort(order.begin(),order.end(),
+                      [&mu](index_t a, index_t b) { return math::abs(mu[a]) > math::abs(mu[b]); });
+            m_values.resize(mu.size(),1);
+            m_vectors.resize(m_A.rows(),mu.size());
+            for (size_t k = 0; k!=order.size(); k++)
+            {
+                m_values(k,0) = shift + 1 / mu[order[k]];
+                m_vectors.col(k) = m_eigSolver.eigenvectors().col(order[k]);
+            }
+            if (verbose) { gsInfo<<"." ; }
+        }
         if (verbose) { gsInfo<<"Finished\n" ; }
         m_status = gsStatus::Success;
     }
@@ -47,32 +91,136 @@ gsStatus gsEigenProblemBase<T>::compute()
         m_status = gsStatus::SolverError;
     }
     return m_status;
-};
+}
+
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::compute(const index_t number)
+{
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
+        return m_status;
+
+    const index_t n = m_A.cols();
+    bool verbose = m_options.getSwitch("verbose");
+    T memoryLimit = m_options.getReal("memoryLimit");
+
+    // The dense solver computes the eigenvalues of smallest magnitude, hence it is not used when a shift or another mode or selection rule is requested
+    const bool defaultMode = m_options.getReal("shift")==0 && m_options.getInt("solver")==0 && m_options.getInt("selectionRule")==4;
+    if (defaultMode && n <= m_options.getInt("denseThreshold") && (memoryLimit < 0 || _denseMemory() <= memoryLimit))
+    {
+        // A dense solve takes approximately 10 n^3 flops
+        if (verbose) { gsInfo<<"Dense solver selected; estimated memory "<<_denseMemory()<<" MB and "<<10.*math::pow((T)(n),3)<<" flops\n"; }
+        if (this->_computeDense()!=gsStatus::Success)
+            return m_status;
+        if (number < m_values.rows())
+        {
+            // Keep the eigenpairs of smallest magnitude, in their order
+            std::vector<index_t> order(m_values.rows());
+            for (size_t k = 0; k!=order.size(); k++) order[k] = k;
+            std::stable_sort(order.begin(),order.end(),
+                             [this](index_t a, index_t b) { return math::abs(m_values(a,0)) < math::abs(m_values(b,0)); });
+            std::sort(order.begin(),order.begin() + number);
+            gsMatrix<T> values(number,1), vectors(m_vectors.rows(),number);
+            for (index_t k = 0; k!=number; k++)
+            {
+                values(k,0) = m_values(order[k],0);
+                vectors.col(k) = m_vectors.col(order[k]);
+            }
+            m_values.swap(values);
+            m_vectors.swap(vectors);
+        }
+        // The modes are tracked after the truncation, such that the MAC values belong to the kept modes
+        this->_trackModes();
+        return m_status;
+    }
+
+    if (memoryLimit >= 0 && _sparseMemory(number) > memoryLimit)
+    {
+        gsWarn<<"The sparse eigenvalue solver requires approximately "<<_sparseMemory(number)<<" MB for "<<number<<" eigenpairs, which exceeds the memory limit of "<<memoryLimit<<" MB.\n";
+        m_status = gsStatus::MemoryError;
+        return m_status;
+    }
 
+    if (verbose) { gsInfo<<"Sparse solver selected; estimated memory "<<_sparseMemory(number)<<" MB\n"; }
+    return this->_computeIterative(number);
+}
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::_computeIterative(const index_t number)
+{
+    if (m_options.getInt("solver")==5)
+        return this->computeLOBPCG(number);
+#ifdef gsSpectra_ENABLED
+    this->computeSparse(number);
+    if (m_status==gsStatus::Success)
+        return m_status;
+    gsWarn<<"Spectra failed, falling back to subspace iteration.\n";
+#endif
+    return this->computeSubspace(number);
+}
 
 template <class T>
 gsStatus gsEigenProblemBase<T>::computeSparse(const index_t number)
 {
-    if (m_status==gsStatus::AssemblyError)
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
         return m_status;
-    
+
+    if (m_options.getInt("solver")==5)
+        return computeLOBPCG(number);
+
     #ifdef gsSpectra_ENABLED
-        if (m_options.getInt("solver")==0)
-            return computeSparse_impl<Spectra::GEigsMode::Cholesky>(number);
-        else if (m_options.getInt("solver")==1)
-            return computeSparse_impl<Spectra::GEigsMode::RegularInverse>(number);
-        else if (m_options.getInt("solver")==2)
-            return computeSparse_impl<Spectra::GEigsMode::ShiftInvert>(number);
-        else if (m_options.getInt("solver")==3)
-            return computeSparse_impl<Spectra::GEigsMode::Buckling>(number);
-        else if (m_options.getInt("solver")==4)
-            return computeSparse_impl<Spectra::GEigsMode::Cayley>(number);
-        else 
+        const index_t maxAttempts = std::max(m_options.getInt("maxAttempts"),(index_t)(1));
+        const index_t solver0    = m_options.getInt("solver");
+        const index_t ncvFac0    = m_options.getInt("ncvFac");
+        const index_t selection0 = m_options.getInt("selectionRule");
+        const T       shift0     = m_options.getReal("shift");
+
+        gsStopwatch clock;
+        m_attemptTimes.clear();
+        for (index_t attempt = 0; attempt!=maxAttempts; attempt++)
         {
-            gsWarn<<"Solver index "<<m_options.getInt("solver")<<" unknown.\n";
-            m_status=gsStatus::NotStarted;
-            return m_status;
+            clock.restart();
+            this->_computeSparse(number);
+            clock.stop();
+            m_attemptTimes.push_back(clock.elapsed());
+            if (m_status==gsStatus::Success || m_status==gsStatus::NotStarted || attempt==maxAttempts-1)
+                break;
+
+            const index_t solver = m_options.getInt("solver");
+            const T shift = m_options.getReal("shift");
+            if (m_status==gsStatus::NotConverged || (solver==2 && shift==0))
+            {
+                // A larger Krylov subspace
+                m_options.setInt("ncvFac",2*m_options.getInt("ncvFac"));
+                // Move the shift towards the converged Ritz values, which are stored in m_values
+                if (m_status==gsStatus::NotConverged && shift==0 && m_values.size()!=0)
+                {
+                    index_t i;
+                    m_values.col(0).cwiseAbs().minCoeff(&i);
+                    m_options.setReal("shift",m_values(i,0)/2);
+                }
+            }
+            else
+            {
+                // Switch to a shift-invert mode on numerical issues. Buckling and Cayley modes require a non-zero shift
+                if (solver==2)
+                    m_options.setInt("solver",4);
+                else
+                    m_options.setInt("solver",2);
+                if (selection0==4 || selection0==7)
+                    m_options.setInt("selectionRule",0);
+            }
+            gsWarn<<"Attempt "<<attempt+1<<" of "<<maxAttempts<<" failed after "<<m_attemptTimes.back()<<" s. Retrying with solver "<<m_options.getInt("solver")
+                  <<", ncvFac "<<m_options.getInt("ncvFac")<<" and shift "<<m_options.getReal("shift")<<"\n";
         }
+
+        m_options.setInt("solver",solver0);
+        m_options.setInt("ncvFac",ncvFac0);
+        m_options.setInt("selectionRule",selection0);
+        m_options.setReal("shift",shift0);
+        return m_status;
     #else
         GISMO_UNUSED(number);
         gsWarn<<"Sparse solver is not implemented without gsSpectra. Please compile gismo with Spectra.\n";
@@ -81,6 +229,29 @@ gsStatus gsEigenProblemBase<T>::computeSparse(const index_t number)
     #endif
 };
 
+#ifdef gsSpectra_ENABLED
+template <class T>
+gsStatus gsEigenProblemBase<T>::_computeSparse(const index_t number)
+{
+    if (m_options.getInt("solver")==0)
+        return computeSparse_impl<Spectra::GEigsMode::Cholesky>(number);
+    else if (m_options.getInt("solver")==1)
+        return computeSparse_impl<Spectra::GEigsMode::RegularInverse>(number);
+    else if (m_options.getInt("solver")==2)
+        return computeSparse_impl<Spectra::GEigsMode::ShiftInvert>(number);
+    else if (m_options.getInt("solver")==3)
+        return computeSparse_impl<Spectra::GEigsMode::Buckling>(number);
+    else if (m_options.getInt("solver")==4)
+        return computeSparse_impl<Spectra::GEigsMode::Cayley>(number);
+    else
+    {
+        gsWarn<<"Solver index "<<m_options.getInt("solver")<<" unknown.\n";
+        m_status=gsStatus::NotStarted;
+        return m_status;
+    }
+}
+#endif
+
 #ifdef gsSpectra_ENABLED
 template <class T>
 template< Spectra::GEigsMode _GEigsMode>
@@ -106,12 +277,18 @@ gsEigenProblemBase<T>::computeSparse_impl(index_t number)
     else
         Atmp = m_A;
 
-    gsSpectraGenSymSolver<gsSparseMatrix<T>,_GEigsMode> solver(Atmp,m_B,number,ncvFac*number);
+    gsSpectraGenSymSolver<gsSparseMatrix<T>,_GEigsMode> solver(Atmp,m_B,number,std::min<index_t>(ncvFac*number,m_A.rows()));
 
     if (verbose) { gsInfo<<"." ; }
-    solver.init();
+    if (m_initial.rows()==m_A.rows() && m_initial.cols()!=0)
+    {
+        gsVector<T> v0 = m_initial.rowwise().sum();
+        solver.init(v0.data());
+    }
+    else
+        solver.init();
     if (verbose) { gsInfo<<"." ; }
-    solver.compute(selectionRule,1000,tol,sortRule);
+    solver.compute(selectionRule,m_options.getInt("spectraMaxIt"),tol,sortRule);
 
     if      (solver.info()==Spectra::CompInfo::Successful)
     {
@@ -124,10 +301,14 @@ gsEigenProblemBase<T>::computeSparse_impl(index_t number)
         if (verbose) { gsInfo<<"Finished\n" ; }
 
         m_status = gsStatus::Success;
+        this->_trackModes();
     }
     else if (solver.info()==Spectra::CompInfo::NotConverging) 
     {
         gsWarn<<"Spectra did not converge! Error code: NotConverging\n";
+        // Store the converged Ritz values, used to restart
+        m_values  = solver.eigenvalues();
+        m_values.array() += shift;
         m_status = gsStatus::NotConverged;
     }
     else if (solver.info()==Spectra::CompInfo::NumericalIssue)
@@ -173,11 +354,34 @@ gsEigenProblemBase<T>::computeSparse_impl(index_t number)
     index_t ncvFac = m_options.getInt("ncvFac");
     T tol = m_options.getReal("tolerance");
     if (verbose) { gsInfo<<"Solving eigenvalue problem" ; }
-    gsSpectraGenSymShiftSolver<gsSparseMatrix<T>,_GEigsMode> solver(m_A,m_B,number,ncvFac*number,shift);
+
+    // The operator uses the stored factorization of A - shift*B. The B-operator is A in buckling mode and B otherwise
+    typedef Spectra::SparseSymMatProd<T,gsEigen::Lower,gsEigen::ColMajor,index_t> BOp_t;
+    ShiftInvertOp op(this);
+    BOp_t Bop(_GEigsMode==Spectra::GEigsMode::Buckling ? m_A : m_B);
+    memory::unique_ptr<Spectra::SymGEigsShiftSolver<ShiftInvertOp,BOp_t,_GEigsMode>> solverPtr;
+    try
+    {
+        solverPtr.reset(new Spectra::SymGEigsShiftSolver<ShiftInvertOp,BOp_t,_GEigsMode>(op,Bop,number,std::min<index_t>(ncvFac*number,m_A.rows()),shift));
+    }
+    catch (std::invalid_argument & e)
+    {
+        gsWarn<<e.what()<<"\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+    Spectra::SymGEigsShiftSolver<ShiftInvertOp,BOp_t,_GEigsMode> & solver = *solverPtr;
+
     if (verbose) { gsInfo<<"." ; }
-    solver.init();
+    if (m_initial.rows()==m_A.rows() && m_initial.cols()!=0)
+    {
+        gsVector<T> v0 = m_initial.rowwise().sum();
+        solver.init(v0.data());
+    }
+    else
+        solver.init();
     if (verbose) { gsInfo<<"." ; }
-    solver.compute(selectionRule,1000,tol,sortRule);
+    solver.compute(selectionRule,m_options.getInt("spectraMaxIt"),tol,sortRule);
 
     if      (solver.info()==Spectra::CompInfo::Successful)
     {
@@ -190,10 +394,13 @@ gsEigenProblemBase<T>::computeSparse_impl(index_t number)
         if (verbose) { gsInfo<<"Finished\n" ; }
 
         m_status = gsStatus::Success;
+        this->_trackModes();
     }
     else if (solver.info()==Spectra::CompInfo::NotConverging) 
     {
         gsWarn<<"Spectra did not converge! Error code: NotConverging\n";
+        // Store the converged Ritz values, used to restart
+        m_values  = solver.eigenvalues();
         m_status = gsStatus::NotConverged;
     }
     else if (solver.info()==Spectra::CompInfo::NumericalIssue)
@@ -215,48 +422,672 @@ gsEigenProblemBase<T>::computeSparse_impl(index_t number)
 };
 #endif
 
+template <class T>
+memory::shared_ptr<typename gsEigenProblemBase<T>::Factorization_t> gsEigenProblemBase<T>::_factorization(T shift)
+{
+    typename std::map<T,memory::shared_ptr<Factorization_t>>::const_iterator it = m_factors.find(shift);
+    if (it!=m_factors.end())
+        return it->second;
+
+    // An outdated factorization with the same shift has the same sparsity pattern, hence its symbolic analysis is reused
+    memory::shared_ptr<Factorization_t> factor;
+    typename std::map<T,memory::shared_ptr<Factorization_t>>::iterator old = m_outdatedFactors.find(shift);
+    if (old!=m_outdatedFactors.end())
+    {
+        factor = old->second;
+        m_outdatedFactors.erase(old);
+        if (shift!=0.0)
+            factor->factorize(m_A-shift*m_B);
+        else
+            factor->factorize(m_A);
+    }
+    else
+    {
+        factor = memory::make_shared(new Factorization_t());
+        if (shift!=0.0)
+            factor->compute(m_A-shift*m_B);
+        else
+            factor->compute(m_A);
+    }
+
+    // Remove the oldest factorizations when the cache is full
+    const index_t cacheSize = std::max(m_options.getInt("factorizationCache"),(index_t)(1));
+    while ((index_t)(m_factorShifts.size()) >= cacheSize)
+    {
+        m_factors.erase(m_factorShifts.front());
+        m_factorShifts.pop_front();
+    }
+    m_factors[shift] = factor;
+    m_factorShifts.push_back(shift);
+    return factor;
+}
+
+template <class T>
+T gsEigenProblemBase<T>::_denseMemory() const
+{
+    // Dense copies of A and B, the eigenvectors and the workspace of the solver
+    const T n = m_A.cols();
+    return 4 * n * n * sizeof(T) / 1048576.;
+}
+
+template <class T>
+T gsEigenProblemBase<T>::_sparseMemory(index_t number) const
+{
+    // The Krylov (or subspace) basis, A - shift*B, and its factor assuming a fill-in of a factor 10
+    const T n = m_A.cols();
+    const T ncv = std::max(m_options.getInt("ncvFac")*number, std::max(2*number,number+8));
+    const T nnz = m_A.nonZeros() + m_B.nonZeros();
+    return (ncv * n * sizeof(T) + 11 * nnz * (sizeof(T) + sizeof(index_t))) / 1048576.;
+}
+
 template <class T>
 gsStatus gsEigenProblemBase<T>::computePower()
 {
-    if (m_status==gsStatus::AssemblyError)
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
         return m_status;
 
     bool verbose = m_options.getSwitch("verbose");
     if (verbose) { gsInfo<<"Solving eigenvalue problem" ; }
-    gsMatrix<T> D = m_A.toDense().inverse() * (m_B);
 
-    gsVector<T> v(D.cols());
+    T shift = m_options.getReal("shift");
+    const Factorization_t & solver = this->_factorize(shift);
+    if (solver.info()!=gsEigen::ComputationInfo::Success)
+    {
+        gsWarn<<"Factorization of A - shift*B failed.\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+
+    gsVector<T> v(m_A.cols());
     v.setOnes();
-    gsVector<T> v_old(D.cols());
+    v.normalize();
+    gsVector<T> v_old(m_A.cols());
     v_old.setZero();
 
-    index_t kmax = 100;
-    real_t error,tol = m_options.getReal("tolerance");
+    index_t kmax = m_options.getInt("maxIt");
+    T error,tol = m_options.getReal("tolerance");
+    m_status = gsStatus::NotConverged;
     for (index_t k=0; k!=kmax; k++)
     {
-        v = D*v;
+        v = solver.solve(m_B*v);
         v.normalize();
 
-        error = (v-v_old).norm();
+        // The sign of v alternates for eigenvalues below the shift
+        error = math::min((v-v_old).norm(),(v+v_old).norm());
 
         if ( error < tol )
         {
             m_status = gsStatus::Success;
-            break;        
+            break;
         }
-        else if (k==kmax-1)
-            m_status = gsStatus::NotConverged;
 
         v_old = v;
     }
 
     m_vectors = v;
-    m_values =  (v.transpose() * v) / (v.transpose() * D * v);
+    m_values.resize(1,1);
+    m_values(0,0) = v.dot(m_A*v) / v.dot(m_B*v);
+
+    if (verbose) { gsInfo<<"Finished\n" ; }
+    return m_status;
+};
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::computeSubspace(const index_t number)
+{
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
+        return m_status;
+
+    bool verbose = m_options.getSwitch("verbose");
+    if (verbose) { gsInfo<<"Solving eigenvalue problem" ; }
+
+    T shift = m_options.getReal("shift");
+    const Factorization_t & solver = this->_factorize(shift);
+    if (solver.info()!=gsEigen::ComputationInfo::Success)
+    {
+        gsWarn<<"Factorization of A - shift*B failed.\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+
+    const index_t n = m_A.cols();
+    GISMO_ENSURE(number <= n,"The number of requested eigenvalues ("<<number<<") is larger than the size of the problem ("<<n<<")");
+    // Block size, a few guard vectors improve the convergence of the last requested pair
+    const index_t q = std::min(std::max(2*number,number+8),n);
+
+    gsMatrix<T> X(n,q);
+    gsVector<T> theta;
+    this->_initialBlock(X);
+    m_status = this->_subspaceIteration(solver,shift,number,X,theta);
+
+    m_vectors = X.leftCols(number);
+    m_values = theta.head(number);
+    if (m_status==gsStatus::Success)
+        this->_trackModes();
+
+    if (verbose) { gsInfo<<"Finished\n" ; }
+    return m_status;
+};
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::_subspaceIteration(const Factorization_t & solver, T shift, index_t number,
+                                                   gsMatrix<T> & X, gsVector<T> & values) const
+{
+    const index_t q = X.cols();
+    index_t kmax = m_options.getInt("maxIt");
+    T tol = m_options.getReal("tolerance");
+
+    typedef typename gsMatrix<T>::Base DenseMatrix;
+    gsMatrix<T> Y, BX;
+    DenseMatrix Ar, Br;
+    gsVector<T> theta(q), thetaSorted(q), theta_old(q);
+    theta_old.setZero();
+    std::vector<index_t> order(q);
+
+    gsStatus status = gsStatus::NotConverged;
+    for (index_t k=0; k!=kmax; k++)
+    {
+        // Y = (A - shift*B)^-1 B X
+        BX = m_B*X;
+        Y = solver.solve(BX);
+
+        // Rayleigh-Ritz of the operator (A - shift*B)^-1 B on span(X), in the B-inner product. Its Ritz values
+        // 1/(lambda - shift) are extremal for the pairs closest to the shift, hence a mixture of pairs on both
+        // sides of the shift does not give a spurious Ritz value close to the shift. The Ritz vectors are
+        // advanced by Y, which costs no additional solve
+        Ar = BX.transpose() * Y;
+        Ar = ((Ar + Ar.transpose()) / 2).eval();
+        Br = X.transpose() * BX;
+        Br = ((Br + Br.transpose()) / 2).eval();
+
+        gsMatrix<T> Z;
+        gsEigen::LLT<DenseMatrix> llt(Br);
+        if (llt.info()==gsEigen::ComputationInfo::Success)
+        {
+            gsEigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix> es(Ar,Br);
+            theta = es.eigenvalues().cwiseInverse();
+            Z = es.eigenvectors();
+        }
+        else // B is indefinite (e.g. buckling); A - shift*B should be definite
+        {
+            gsEigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix> es(Br,Ar);
+            theta = es.eigenvalues();
+            Z = es.eigenvectors();
+        }
+
+        // Sort the Ritz values by their distance to the shift
+        for (index_t i = 0; i!=q; i++) order[i] = i;
+        std::sort(order.begin(),order.end(),
+                  [&theta](index_t a, index_t b) { return math::abs(theta[a]) < math::abs(theta[b]); });
+        for (index_t i = 0; i!=q; i++)
+        {
+            X.col(i) = Y * Z.col(order[i]);
+            X.col(i).normalize();
+            thetaSorted[i] = theta[order[i]];
+        }
+
+        // The requested pairs converged when the eigenvalues do not change anymore
+        if (k!=0 && ((thetaSorted-theta_old).head(number).cwiseAbs().array() <= tol * (thetaSorted.head(number).array() + shift).abs()).all())
+        {
+            theta_old = thetaSorted;
+            status = gsStatus::Success;
+            break;
+        }
+        theta_old = thetaSorted;
+    }
+
+    values = theta_old;
+    values.array() += shift;
+    return status;
+}
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::computeSlicing(T lower, T upper, index_t slices)
+{
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
+        return m_status;
+
+    GISMO_ENSURE(lower < upper,"The lower bound ("<<lower<<") should be smaller than the upper bound ("<<upper<<")");
+    GISMO_ENSURE(slices > 0,"The number of slices should be positive");
+
+    bool verbose = m_options.getSwitch("verbose");
+    if (verbose) { gsInfo<<"Solving eigenvalue problem with "<<slices<<" slices\n" ; }
+
+    const index_t n = m_A.cols();
+    gsVector<T> sigma(slices+1);
+    for (index_t i = 0; i!=slices+1; i++)
+        sigma[i] = lower + (upper - lower) * i / slices;
+
+    // Number of eigenvalues below every slice edge, from the inertia of A - sigma*B (Sylvester's law of inertia)
+    std::vector<index_t> below(slices+1);
+    std::vector<index_t> success(slices+1);
+#pragma omp parallel for schedule(dynamic,1)
+    for (index_t i = 0; i < slices+1; i++)
+    {
+        Factorization_t factor;
+        factor.compute(m_A-sigma[i]*m_B);
+        success[i] = (factor.info()==gsEigen::ComputationInfo::Success);
+        below[i]   = success[i] ? (factor.vectorD().array() < 0).count() : 0;
+    }
+    if (std::find(success.begin(),success.end(),0)!=success.end())
+    {
+        gsWarn<<"Factorization of A - sigma*B failed at a slice edge. Use other bounds or another number of slices.\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+
+    // The eigenvalues in a slice are the ones closest to its center: every eigenvalue inside the edges is
+    // closer to the center than any eigenvalue outside. Every slice is solved independently
+    std::vector<gsMatrix<T>> sliceVectors(slices);
+    std::vector<gsVector<T>> sliceValues(slices);
+    std::vector<gsStatus> status(slices,gsStatus::Success);
+    std::vector<gsMatrix<T>> X0(slices);
+    for (index_t j = 0; j!=slices; j++)
+    {
+        const index_t number = below[j+1] - below[j];
+        if (number<=0) continue;
+        X0[j].resize(n,std::min(std::max(2*number,number+8),n));
+        this->_initialBlock(X0[j]);
+    }
+
+#pragma omp parallel for schedule(dynamic,1)
+    for (index_t j = 0; j < slices; j++)
+    {
+        const index_t number = below[j+1] - below[j];
+        if (number<=0) continue;
+
+        const T center = (sigma[j] + sigma[j+1]) / 2;
+        Factorization_t factor;
+        factor.compute(m_A-center*m_B);
+        if (factor.info()!=gsEigen::ComputationInfo::Success)
+        {
+            status[j] = gsStatus::SolverError;
+            continue;
+        }
+        status[j] = this->_subspaceIteration(factor,center,number,X0[j],sliceValues[j]);
+        sliceVectors[j] = X0[j];
+    }
+
+    // Merge the slices. Every slice contributes the converged pairs closest to its center, as many as the
+    // inertia counts within its edges; the Ritz values beyond these are guards and did not converge.
+    // Pairs that are found twice at an edge (equal eigenvalue and parallel eigenvector) are removed
+    std::vector<std::pair<T,index_t>> pairs;
+    std::vector<gsVector<T>> vectors;
+    T tol = m_options.getReal("tolerance");
+    m_status = gsStatus::Success;
+    for (index_t j = 0; j!=slices; j++)
+    {
+        const index_t number = below[j+1] - below[j];
+        if (number<=0) continue;
+        if (status[j]!=gsStatus::Success)
+        {
+            gsWarn<<"Slice ["<<sigma[j]<<","<<sigma[j+1]<<"] did not converge.\n";
+            m_status = status[j];
+        }
+
+        // Eigenvalues on an edge may be computed just outside of it, hence the tolerance
+        const T edgeTol = math::sqrt(tol) * math::max(math::abs(sigma[j+1]-sigma[j]),(T)(1));
+        std::vector<std::pair<T,index_t>> slicePairs;
+        for (index_t i = 0; i!=std::min(number,(index_t)(sliceValues[j].rows())); i++)
+            if (sliceValues[j][i] >= sigma[j] - edgeTol && sliceValues[j][i] <= sigma[j+1] + edgeTol)
+                slicePairs.push_back(std::make_pair(sliceValues[j][i],i));
+        std::sort(slicePairs.begin(),slicePairs.end());
+
+        for (typename std::vector<std::pair<T,index_t>>::const_iterator it = slicePairs.begin(); it!=slicePairs.end(); it++)
+        {
+            const gsVector<T> v = sliceVectors[j].col(it->second);
+            bool duplicate = false;
+            for (index_t k = (index_t)(vectors.size())-1; k >= 0 && math::abs(pairs[k].first - it->first) <= math::sqrt(tol) * math::max(math::abs(it->first),(T)(1)); k--)
+                if (math::abs(vectors[k].dot(v)) > (T)(0.99) * vectors[k].norm() * v.norm())
+                {
+                    duplicate = true;
+                    break;
+                }
+            if (duplicate) continue;
+            pairs.push_back(std::make_pair(it->first,(index_t)(vectors.size())));
+            vectors.push_back(v);
+        }
+
+        if ((index_t)(slicePairs.size()) < number && m_status==gsStatus::Success)
+        {
+            gsWarn<<"Slice ["<<sigma[j]<<","<<sigma[j+1]<<"] contains "<<number<<" eigenvalues, but "<<slicePairs.size()<<" were found.\n";
+            m_status = gsStatus::NotConverged;
+        }
+    }
+
+    m_values.resize(pairs.size(),1);
+    m_vectors.resize(n,pairs.size());
+    for (size_t k = 0; k!=pairs.size(); k++)
+    {
+        m_values(k,0) = pairs[k].first;
+        m_vectors.col(k) = vectors[k];
+    }
+    if (m_status==gsStatus::Success)
+        this->_trackModes();
+
+    if (verbose) { gsInfo<<"Found "<<pairs.size()<<" eigenvalues in ["<<lower<<","<<upper<<"], expected "<<below[slices]-below[0]<<"\n" ; }
+    return m_status;
+}
+
+template <class T>
+gsStatus gsEigenProblemBase<T>::computeLOBPCG(const index_t number)
+{
+    m_status = this->_initialize();
+    if (m_status!=gsStatus::Success)
+        return m_status;
+
+    bool verbose = m_options.getSwitch("verbose");
+    if (verbose) { gsInfo<<"Solving eigenvalue problem" ; }
+
+    T shift = m_options.getReal("shift");
+    const index_t n = m_A.cols();
+    GISMO_ENSURE(number <= n,"The number of requested eigenvalues ("<<number<<") is larger than the size of the problem ("<<n<<")");
+    // Block size, a few guard vectors improve the convergence of the last requested pair
+    const index_t m = std::min(number + std::min<index_t>(number,8),n);
+
+    index_t kmax = m_options.getInt("maxIt");
+    T tol = m_options.getReal("tolerance");
+
+    gsSparseMatrix<T> As;
+    if (shift!=0.0)
+        As = m_A-shift*m_B;
+    else
+        As = m_A;
+
+    // LOBPCG requires a positive definite right-hand side matrix. If B is not (e.g. buckling), the method is
+    // applied to (-B, A - shift*B), with eigenvalues mu = -1/(lambda-shift). Unless the option 'positiveB' is
+    // given, B is tested on the Gram matrices of the Rayleigh-Ritz steps, which costs nothing extra
+    const index_t positiveB = m_options.getInt("positiveB");
+    bool swap = positiveB==0;
+    bool indefinite = false;
+    auto applyK = [&](const gsMatrix<T> & S) -> gsMatrix<T>
+    {
+        gsMatrix<T> KS;
+        if (swap)
+            KS = -(m_B * S);
+        else
+            KS = As * S;
+        return KS;
+    };
+    auto applyM = [&](const gsMatrix<T> & S) -> gsMatrix<T>
+    {
+        gsMatrix<T> MS;
+        if (swap)
+            MS = As * S;
+        else
+            MS = m_B * S;
+        return MS;
+    };
+
+    Preconditioner_t precond = m_preconditioner ? m_preconditioner : this->_preconditioner(As);
+    if (!precond)
+    {
+        gsWarn<<"Construction of the preconditioner failed.\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+
+    typedef typename gsMatrix<T>::Base DenseMatrix;
+    // Rayleigh-Ritz on span(S). The basis is M-orthonormalized through the eigendecomposition of its Gram matrix,
+    // dropping (nearly) linearly dependent directions. Returns the coefficients of the m smallest Ritz pairs
+    auto rayleighRitz = [&](const gsMatrix<T> & S, gsMatrix<T> & Z, gsVector<T> & ritz) -> bool
+    {
+        DenseMatrix GK = S.transpose() * applyK(S);
+        GK = ((GK + GK.transpose()) / 2).eval();
+        DenseMatrix GM = S.transpose() * applyM(S);
+        GM = ((GM + GM.transpose()) / 2).eval();
+
+        gsEigen::SelfAdjointEigenSolver<DenseMatrix> esM(GM);
+        const T dmax = esM.eigenvalues().maxCoeff();
+        // A negative eigenvalue of S^T B S shows that B is not positive definite
+        if (positiveB==-1 && !swap &&
+            esM.eigenvalues().minCoeff() < -math::sqrt(std::numeric_limits<T>::epsilon()) * esM.eigenvalues().cwiseAbs().maxCoeff())
+        {
+            indefinite = true;
+            return false;
+        }
+        if (!(dmax > 0))
+            return false;
+        std::vector<index_t> keep;
+        for (index_t i = 0; i!=GM.rows(); i++)
+            if (esM.eigenvalues()[i] > math::sqrt(std::numeric_limits<T>::epsilon()) * dmax)
+                keep.push_back(i);
+        if ((index_t)(keep.size()) < m)
+            return false;
+
+        DenseMatrix Tr(GM.rows(),keep.size());
+        for (size_t i = 0; i!=keep.size(); i++)
+            Tr.col(i) = esM.eigenvectors().col(keep[i]) / math::sqrt(esM.eigenvalues()[keep[i]]);
+        DenseMatrix H = Tr.transpose() * GK * Tr;
+        H = ((H + H.transpose()) / 2).eval();
+
+        gsEigen::SelfAdjointEigenSolver<DenseMatrix> es(H);
+        ritz = es.eigenvalues().head(m);
+        Z = Tr * es.eigenvectors().leftCols(m);
+        return true;
+    };
+
+    gsMatrix<T> X(n,m), KX, MX, R, Ra, W, P, S, Z;
+    gsVector<T> theta;
+    std::vector<index_t> active;
+    // Starts from the initial block, on (-B, A - shift*B) if B turns out to be indefinite
+    auto start = [&]() -> bool
+    {
+        this->_initialBlock(X);
+        if (!rayleighRitz(X,Z,theta))
+        {
+            if (!indefinite)
+                return false;
+            swap = true;
+            indefinite = false;
+            this->_initialBlock(X);
+            if (!rayleighRitz(X,Z,theta))
+                return false;
+        }
+        X = (X * Z).eval();
+        P.resize(n,0);
+        return true;
+    };
+    if (!start())
+    {
+        gsWarn<<"The initial block of LOBPCG is rank deficient.\n";
+        m_status = gsStatus::SolverError;
+        return m_status;
+    }
+
+    m_status = gsStatus::NotConverged;
+    for (index_t k=0; k!=kmax; k++)
+    {
+        KX = applyK(X);
+        MX = applyM(X);
+        R = KX - MX * theta.asDiagonal();
+
+        // Soft locking: converged pairs stay in the basis, but do not get new search directions
+        active.clear();
+        index_t numConverged = 0;
+        for (index_t i = 0; i!=m; i++)
+        {
+            T scale = KX.col(i).norm() + math::abs(theta[i]) * MX.col(i).norm();
+            if (R.col(i).norm() > tol * (scale!=0 ? scale : (T)(1)))
+                active.push_back(i);
+            else if (i < number)
+                numConverged++;
+        }
+        if (numConverged==number)
+        {
+            m_status = gsStatus::Success;
+            break;
+        }
+
+        const index_t na = active.size();
+        const index_t np = P.cols()!=0 ? na : 0;
+        Ra.resize(n,na);
+        for (index_t j = 0; j!=na; j++)
+            Ra.col(j) = R.col(active[j]);
+        precond(Ra,W);
+
+        S.resize(n,m+na+np);
+        S.leftCols(m) = X;
+        S.middleCols(m,na) = W;
+        for (index_t j = 0; j!=np; j++)
+            S.col(m+na+j) = P.col(active[j]);
+
+        // The search directions are made M-orthogonal to the (M-orthonormal) iterates and normalized. Otherwise
+        // they vanish close to convergence, and the rank test of the Rayleigh-Ritz step drops them
+        S.rightCols(na+np) -= X * (MX.transpose() * S.rightCols(na+np));
+        for (index_t j = m; j!=m+na+np; j++)
+        {
+            const T norm = S.col(j).norm();
+            if (norm!=0)
+                S.col(j) /= norm;
+        }
+
+        bool success = rayleighRitz(S,Z,theta);
+        if (!success && !indefinite && np!=0)
+        {
+            // Restart without the previous search directions
+            S = S.leftCols(m+na).eval();
+            success = rayleighRitz(S,Z,theta);
+        }
+        if (!success && indefinite)
+        {
+            if (verbose) { gsInfo<<"B is not positive definite, restarting on (-B, A - shift*B)" ; }
+            swap = true;
+            indefinite = false;
+            if (start())
+                continue;
+        }
+        if (!success)
+        {
+            gsWarn<<"The LOBPCG basis is rank deficient.\n";
+            m_status = gsStatus::SolverError;
+            break;
+        }
+
+        // The search directions are the components of the new iterates outside of the current block
+        P = S.rightCols(S.cols()-m) * Z.bottomRows(S.cols()-m);
+        X = S * Z;
+    }
+
+    m_vectors = X.leftCols(number);
+    m_values.resize(number,1);
+    for (index_t i = 0; i!=number; i++)
+        m_values(i,0) = (swap ? -1 / theta[i] : theta[i]) + shift;
+    if (m_status==gsStatus::Success)
+        this->_trackModes();
 
     if (verbose) { gsInfo<<"Finished\n" ; }
     return m_status;
 };
 
+template <class T>
+gsMatrix<T> gsEigenProblemBase<T>::MAC(const gsMatrix<T> & reference) const
+{
+    GISMO_ENSURE(reference.rows()==m_vectors.rows(),"The reference modes have "<<reference.rows()<<" rows, but the computed modes have "<<m_vectors.rows()<<" rows");
+    gsMatrix<T> result = (reference.transpose() * m_vectors).array().square().matrix();
+    const gsVector<T> refNorms = reference.colwise().squaredNorm().transpose();
+    const gsVector<T> vecNorms = m_vectors.colwise().squaredNorm().transpose();
+    for (index_t i = 0; i!=result.rows(); i++)
+        for (index_t j = 0; j!=result.cols(); j++)
+            result(i,j) = (refNorms[i]!=0 && vecNorms[j]!=0) ? result(i,j) / (refNorms[i] * vecNorms[j]) : (T)(0);
+    return result;
+}
+
+template <class T>
+void gsEigenProblemBase<T>::_initialBlock(gsMatrix<T> & X) const
+{
+    X.setRandom();
+    if (m_initial.rows()==X.rows())
+    {
+        const index_t k = std::min(m_initial.cols(),X.cols());
+        X.leftCols(k) = m_initial.leftCols(k);
+    }
+}
+
+template <class T>
+void gsEigenProblemBase<T>::_trackModes()
+{
+    m_trackedMAC.setZero(m_vectors.cols());
+    if (!m_options.getSwitch("trackModes") || m_initial.rows()!=m_vectors.rows() || m_initial.cols()==0)
+        return;
+
+    // Greedy matching: the pair with the largest MAC is matched first
+    gsMatrix<T> mac = this->MAC(m_initial);
+    const index_t r = mac.rows(), p = mac.cols();
+    std::vector<index_t> match(r,-1), matchedTo(p,-1);
+    index_t i, j;
+    for (index_t k = 0; k!=std::min(r,p); k++)
+    {
+        if (mac.maxCoeff(&i,&j) <= 0)
+            break;
+        match[i] = j;
+        matchedTo[j] = i;
+        mac.row(i).setConstant(-1);
+        mac.col(j).setConstant(-1);
+    }
+
+    // The matched modes come first, in the order of the initial subspace, followed by the other modes in their original order
+    std::vector<index_t> order;
+    for (index_t k = 0; k!=r; k++)
+        if (match[k]!=-1)
+            order.push_back(match[k]);
+    for (index_t k = 0; k!=p; k++)
+        if (matchedTo[k]==-1)
+            order.push_back(k);
+
+    mac = this->MAC(m_initial);
+    gsMatrix<T> values(m_values.rows(),m_values.cols()), vectors(m_vectors.rows(),m_vectors.cols());
+    for (index_t k = 0; k!=p; k++)
+    {
+        values.row(k) = m_values.row(order[k]);
+        vectors.col(k) = m_vectors.col(order[k]);
+        if ((i = matchedTo[order[k]])!=-1)
+        {
+            m_trackedMAC[k] = mac(i,order[k]);
+            // Align the sign with the reference mode
+            if (vectors.col(k).dot(m_initial.col(i)) < 0)
+                vectors.col(k) *= -1;
+        }
+    }
+    m_values.swap(values);
+    m_vectors.swap(vectors);
+}
+
+template <class T>
+typename gsEigenProblemBase<T>::Preconditioner_t gsEigenProblemBase<T>::_preconditioner(const gsSparseMatrix<T> & K) const
+{
+    const std::string name = m_options.getString("preconditioner");
+    if (name=="None")
+        return [](const gsMatrix<T> & R, gsMatrix<T> & W) { W = R; };
+    else if (name=="Jacobi")
+    {
+        gsVector<T> invDiag = K.diagonal();
+        for (index_t i = 0; i!=invDiag.rows(); i++)
+            invDiag[i] = (invDiag[i]!=0) ? 1 / math::abs(invDiag[i]) : (T)(1);
+        return [invDiag](const gsMatrix<T> & R, gsMatrix<T> & W) { W = invDiag.asDiagonal() * R; };
+    }
+    else if (name=="IncompleteCholesky")
+    {
+        typedef gsEigen::IncompleteCholesky<T,gsEigen::Lower,gsEigen::AMDOrdering<index_t>> IC_t;
+        memory::shared_ptr<IC_t> ic = memory::make_shared(new IC_t());
+        ic->compute(K);
+        if (ic->info()!=gsEigen::ComputationInfo::Success)
+            return Preconditioner_t();
+        return [ic](const gsMatrix<T> & R, gsMatrix<T> & W) { W = ic->solve(R); };
+    }
+    else
+    {
+        memory::shared_ptr<gsSparseSolver<T>> solver = gsSparseSolver<T>::get(name);
+        solver->compute(K);
+        if (solver->info()!=gsEigen::ComputationInfo::Success)
+            return Preconditioner_t();
+        return [solver](const gsMatrix<T> & R, gsMatrix<T> & W) { W = solver->solve(R); };
+    }
+}
+
 template <class T>
 std::vector<std::pair<T,gsMatrix<T>> > gsEigenProblemBase<T>::makeMode(int k) const
 {
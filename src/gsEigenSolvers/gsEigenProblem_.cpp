@@ -7,6 +7,9 @@
 
 #include <gsStructuralAnalysis/src/gsEigenSolvers/gsModalSolver.h>
 
+#include <gsStructuralAnalysis/src/gsEigenSolvers/gsCraigBamptonSolver.h>
+#include <gsStructuralAnalysis/src/gsEigenSolvers/gsCraigBamptonSolver.hpp>
+
 namespace gismo
 {
 		CLASS_TEMPLATE_INST gsEigenProblemBase<real_t>;
@@ -14,4 +17,6 @@ namespace gismo
 		CLASS_TEMPLATE_INST gsBucklingSolver<real_t>;
 
 		CLASS_TEMPLATE_INST gsModalSolver<real_t>;
+
+		CLASS_TEMPLATE_INST gsCraigBamptonSolver<real_t>;
 }
@@ -19,6 +19,7 @@
 #endif
 #include <gsIO/gsOptionList.h>
 #include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsParallelKernels.h>
 
 #pragma once
 
@@ -42,6 +43,7 @@ protected:
     typedef typename gsStructuralAnalysisOps<T>::ALResidual_t    ALResidual_t;
     typedef typename gsStructuralAnalysisOps<T>::Jacobian_t      Jacobian_t;
     typedef typename gsStructuralAnalysisOps<T>::dJacobian_t     dJacobian_t;
+    typedef typename gsStructuralAnalysisOps<T>::ResidualJacobian_t ResidualJacobian_t;
 
 public:
 
@@ -83,6 +85,9 @@ public:
         m_verbose = m_options.getInt("verbose");
         m_stabilityMethod     = m_options.getInt ("BifurcationMethod");
         m_solver = gsSparseSolver<T>::get( m_options.askString("Solver","SimplicialLDLT") );
+        // The norms do not depend on the number of threads, hence also not on the option KernelThreads==0 (serial kernels of Eigen)
+        const index_t threads = m_options.askInt("KernelThreads",0);
+        m_kernels.setNumThreads(threads==0 ? 1 : threads);
     }
 
     /// Set the options from \a options
@@ -158,6 +163,14 @@ public:
     }
 
 protected:
+    /// Returns the Euclidean norm of \a x, see \ref gsParallelKernels
+    template<class Derived>
+    T _norm(const gsEigen::MatrixBase<Derived> & x) const { return m_kernels.norm(x); }
+
+    /// Returns the dot product of \a x and \a y, see \ref gsParallelKernels
+    template<class DerivedX, class DerivedY>
+    T _dot(const gsEigen::MatrixBase<DerivedX> & x, const gsEigen::MatrixBase<DerivedY> & y) const { return m_kernels.dot(x,y); }
+
     /// Computes the stability vector using the determinant of the Jacobian
     virtual bool _computeStabilityDet(const gsSparseMatrix<T> & jacMat)
     {
@@ -261,6 +274,9 @@ protected:
 
     index_t m_stabilityMethod;
 
+    /// Deterministic reductions for the norms and dot products
+    gsParallelKernels<T> m_kernels;
+
     struct stabmethod
     {
         enum type
@@ -9,6 +9,9 @@
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticNewton.h>
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticNewton.hpp>
 
+#include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticDeflatedNewton.h>
+#include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticDeflatedNewton.hpp>
+
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticOpt.h>
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticOpt.hpp>
 
@@ -28,8 +31,15 @@ namespace gismo
 		CLASS_TEMPLATE_INST gsStaticBase<real_t>;
 		CLASS_TEMPLATE_INST gsStaticDR<real_t>;
 		CLASS_TEMPLATE_INST gsStaticNewton<real_t>;
+		CLASS_TEMPLATE_INST gsStaticDeflatedNewton<real_t>;
 		CLASS_TEMPLATE_INST gsStaticComposite<real_t>;
 
+		// The other precision for Dynamic Relaxation, which is bound by the memory bandwidth: single precision, or double precision if real_t is float
+		typedef std::conditional<std::is_same<real_t,float>::value,double,float>::type other_t;
+
+		CLASS_TEMPLATE_INST gsStaticBase<other_t>;
+		CLASS_TEMPLATE_INST gsStaticDR<other_t>;
+
 		CLASS_TEMPLATE_INST gsOptProblemStatic<real_t>;
 		CLASS_TEMPLATE_INST gsStaticOpt<real_t, gsGradientDescent<real_t>>;
 #ifdef gsHLBFGS_ENABLED
@@ -19,11 +19,23 @@ namespace gismo
 /**
  * @brief Static solver using the Dynamic Relaxation method
  *
- * @tparam     T     coefficient type
+ * The residual is called in every iteration. By default, it is stored as a
+ * std::function (\ref gsStructuralAnalysisOps). For cheap residuals, e.g.
+ * linear ones, its type can be given as \a ResidualOp, such that the call
+ * is bound at compile time and can be inlined:
+ * \code
+ * auto residual = [&](gsVector<real_t> const & x, gsVector<real_t> & result) { result = F - K*x; return true; };
+ * gsStaticDR<real_t,decltype(residual)> DRM(M,F,residual);
+ * \endcode
+ * Only the default \a ResidualOp is instantiated in the library; for other
+ * types, gsStaticDR.hpp should be included.
+ *
+ * @tparam     T           coefficient type
+ * @tparam     ResidualOp  type of the residual, callable as bool(gsVector<T> const &, gsVector<T> &)
  *
  * \ingroup gsStaticBase
  */
-template <class T>
+template <class T, class ResidualOp = typename gsStructuralAnalysisOps<T>::Residual_t>
 class gsStaticDR : public gsStaticBase<T>
 {
 protected:
@@ -33,6 +45,8 @@ protected:
     typedef typename Base::Residual_t    Residual_t;
     typedef typename Base::ALResidual_t  ALResidual_t;
 
+    typedef typename gsStructuralAnalysisAccumulator<T>::type Accumulator_t;
+
 public:
 
     /**
@@ -44,7 +58,7 @@ public:
      */
     gsStaticDR( const gsVector<T> & M, // lumped
                 const gsVector<T> & F,
-                const Residual_t &Residual
+                const ResidualOp &Residual
                )
     :
     m_mass(M),
@@ -73,10 +87,6 @@ public:
     m_ALresidualFun(ALResidual)
     {
         m_L = 1.0;
-        m_residualFun = [this](gsVector<T> const & x, gsVector<T> & result) -> bool
-        {
-            return m_ALresidualFun(x,m_L,result);
-        };
         this->_init();
     }
 
@@ -118,6 +128,8 @@ protected:
     void _solve();
     /// Performs an iteration
     void _iteration();
+    /// Performs an iteration with the fused multithreaded kernel, see the option KernelThreads
+    void _fusedIteration();
     /// Identifies a peak
     void _peak();
     /// Starts the method
@@ -127,6 +139,10 @@ protected:
 
     gsVector<T> _computeResidual(const gsVector<T> & U);
 
+    using Base::_norm;
+    /// Returns the kinetic energy of the velocities \a v, accumulated in \ref gsStructuralAnalysisAccumulator
+    T _kineticEnergy(const gsVector<T> & v) const;
+
 public:
     //// Perform a step back
     void _stepBack()
@@ -141,12 +157,12 @@ public:
     }
 
     /// Return the residual norm
-    T residualNorm() const { return m_R.norm(); }
+    T residualNorm() const { return _norm(m_R); }
 
 protected:
     const gsVector<T> & m_mass;
     const gsVector<T> & m_forcing;
-    Residual_t m_residualFun;
+    ResidualOp m_residualFun;
     const ALResidual_t m_ALresidualFun;
 
     // Solution
@@ -199,6 +215,10 @@ protected:
     // Kinetic energy
     T m_Ek, m_Ek_prev, m_Ek0;       // (class-specific)
     mutable std::vector<T> m_Eks;   // (class-specific)
+
+    // Kernels
+    using Base::m_kernels;
+    index_t m_kernelThreads;        // (class-specific)
 };
 
 } //namespace
@@ -16,28 +16,30 @@
 namespace gismo
 {
 
-template <class T>
-void gsStaticDR<T>::defaultOptions()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::defaultOptions()
 {
     Base::defaultOptions();
     m_options.addReal("damping","damping factor",1.0);
     m_options.addReal("alpha","mass coefficient",2.0);
     m_options.addReal("tolE","Kinetic energy tolerance",1e-6);
     m_options.addInt("ResetIt","Reset rate of velocities if damping is zero",-1);
+    m_options.addInt("KernelThreads","Number of threads of the fused iteration kernel and the norms. If 0, the serial kernels of Eigen are used for the iteration; if <0, the maximum number of threads is used. The results do not depend on the number of threads",0);
 }
 
-template <class T>
-void gsStaticDR<T>::getOptions()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::getOptions()
 {
     Base::getOptions();
     m_c = m_options.getReal("damping");
     m_alpha = m_options.getReal("alpha");
     m_tolE = m_options.getReal("tolE");
     m_resetIterations = m_options.getInt("ResetIt");
+    m_kernelThreads = m_options.getInt("KernelThreads");
 }
 
-template <class T>
-void gsStaticDR<T>::initOutput()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::initOutput()
 {
     gsInfo<<"\t";
     gsInfo<<std::setw(4)<<std::left<<"It.";
@@ -52,8 +54,8 @@ void gsStaticDR<T>::initOutput()
     gsInfo<<"\n";
 }
 
-template <class T>
-void gsStaticDR<T>::stepOutput(index_t k)
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::stepOutput(index_t k)
 {
     gsInfo<<"\t";
     gsInfo<<std::setw(4)<<std::left<<k;
@@ -61,15 +63,15 @@ void gsStaticDR<T>::stepOutput(index_t k)
     gsInfo<<std::setw(17)<<std::left<<m_residual/m_residualIni;
     gsInfo<<std::setw(17)<<std::left<<m_Ek;
     gsInfo<<std::setw(17)<<std::left<<m_Ek/m_Ek0;
-    gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm();
-    gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm()/m_DeltaU.norm();
-    gsInfo<<std::setw(17)<<std::left<<m_deltaU.norm()/(m_U+m_DeltaU).norm();
-    gsInfo<<std::setw(17)<<std::left<<m_v.norm();
+    gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU);
+    gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU)/_norm(m_DeltaU);
+    gsInfo<<std::setw(17)<<std::left<<_norm(m_deltaU)/_norm(m_U+m_DeltaU);
+    gsInfo<<std::setw(17)<<std::left<<_norm(m_v);
     gsInfo<<"\n";
 }
 
-template <class T>
-gsStatus gsStaticDR<T>::solve()
+template <class T, class ResidualOp>
+gsStatus gsStaticDR<T,ResidualOp>::solve()
 {
     // try
     // {
@@ -94,8 +96,8 @@ gsStatus gsStaticDR<T>::solve()
     return m_status;
 }
 
-template <class T>
-void gsStaticDR<T>::_solve()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_solve()
 {
     m_Eks.clear();
     m_Eks.reserve(m_maxIterations);
@@ -125,13 +127,13 @@ void gsStaticDR<T>::_solve()
 
         m_residualOld = m_residual;
 
-        if (m_residual/m_residualIni < m_tolF && m_Ek/m_Ek0 < m_tolE && m_deltaU.norm()/m_DeltaU.norm() < m_tolU)
+        if (m_residual/m_residualIni < m_tolF && m_Ek/m_Ek0 < m_tolE && _norm(m_deltaU)/_norm(m_DeltaU) < m_tolU)
         {
             m_U += m_DeltaU;
             gsDebug <<"Converged: \n";
             gsDebug <<"\t |R|/|R0| = "<<m_residual/m_residualIni<<" < tolF = "<<m_tolF<<"\n";
             gsDebug <<"\t |E|/|E0| = "<<m_Ek/m_Ek0              <<" < tolE = "<<m_tolE<<"\n";
-            gsDebug <<"\t |U|/|U0| = "<<m_deltaU.norm()/m_DeltaU.norm()<<" < tolF = "<<m_tolU<<"\n";
+            gsDebug <<"\t |U|/|U0| = "<<_norm(m_deltaU)/_norm(m_DeltaU)<<" < tolF = "<<m_tolU<<"\n";
             break;
         }
         if (m_numIterations==m_maxIterations-1)
@@ -144,8 +146,8 @@ void gsStaticDR<T>::_solve()
     gsInfo<<"\n";
 };
 
-template <class T>
-void gsStaticDR<T>::initialize()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::initialize()
 {
     this->reset();
     getOptions();
@@ -153,8 +155,8 @@ void gsStaticDR<T>::initialize()
     m_damp = m_c * m_mass;
 }
 
-template <class T>
-void gsStaticDR<T>::reset()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::reset()
 {
     m_dofs = m_mass.rows();
     m_massInv = m_mass.array().inverse();
@@ -165,29 +167,46 @@ void gsStaticDR<T>::reset()
     m_status = gsStatus::NotStarted;
 }
 
-template <class T>
-void gsStaticDR<T>::_init()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_init()
 {
     this->reset();
     m_dt = 1.0;
+    m_kernelThreads = 0;
     defaultOptions();
 }
 
-template <class T>
-gsVector<T> gsStaticDR<T>::_computeResidual(const gsVector<T> & U)
+template <class T, class ResidualOp>
+gsVector<T> gsStaticDR<T,ResidualOp>::_computeResidual(const gsVector<T> & U)
 {
   gsVector<T> resVec;
-  if (!m_residualFun(U, resVec))
+  if (m_ALresidualFun!=nullptr ? !m_ALresidualFun(U, m_L, resVec) : !m_residualFun(U, resVec))
     throw 2;
   return resVec;
 }
 
-template <class T>
-void gsStaticDR<T>::_iteration()
+template <class T, class ResidualOp>
+T gsStaticDR<T,ResidualOp>::_kineticEnergy(const gsVector<T> & v) const
+{
+    return static_cast<T>(m_kernels.reduce(v.size(),[&](index_t b, index_t s) -> Accumulator_t
+    {
+        return v.segment(b,s).template cast<Accumulator_t>().dot(m_mass.segment(b,s).template cast<Accumulator_t>().cwiseProduct(v.segment(b,s).template cast<Accumulator_t>()));
+    },Accumulator_t(0)));
+}
+
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_iteration()
 {
     m_Ek_prev = m_Ek;
+    if (m_kernelThreads!=0)
+    {
+        this->_fusedIteration();
+        if (m_residualIni==0) m_residualIni = m_residual;
+        return;
+    }
+
     m_R = _computeResidual(m_U+m_DeltaU) - m_damp.cwiseProduct(m_v);
-    m_residual = m_R.norm();
+    m_residual = _norm(m_R);
     if (m_residualIni==0) m_residualIni = m_residual;
 //----------------------------------------------------------------------------------
     m_v += m_dt * m_massInv.cwiseProduct(m_R);                    // Velocities at t+dt/2
@@ -198,11 +217,35 @@ void gsStaticDR<T>::_iteration()
 //----------------------------------------------------------------------------------
 
     m_DeltaU += m_deltaU;               // Velocities at t+dt
-    m_Ek = m_v.transpose() * m_mass.cwiseProduct(m_v);
+    m_Ek = _kineticEnergy(m_v);
+}
+
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_fusedIteration()
+{
+    const gsVector<T> res = _computeResidual(m_U+m_DeltaU);
+    m_R.resize(m_dofs);
+    m_deltaU.resize(m_dofs);
+    if (m_DeltaU.rows()!=m_dofs) m_DeltaU.setZero(m_dofs);
+
+    // One pass over the vectors computes the residual, the velocities, the updates, |R|^2 and the kinetic energy
+    typedef gsEigen::Matrix<Accumulator_t,2,1> Sums;
+    const Sums sums = m_kernels.reduce(m_dofs,[&](index_t b, index_t s) -> Sums
+    {
+        m_R.segment(b,s)       = res.segment(b,s) - m_damp.segment(b,s).cwiseProduct(m_v.segment(b,s));
+        m_v.segment(b,s)      += m_dt * m_massInv.segment(b,s).cwiseProduct(m_R.segment(b,s));
+        m_deltaU.segment(b,s)  = m_dt * m_v.segment(b,s);
+        m_DeltaU.segment(b,s) += m_deltaU.segment(b,s);
+        return Sums(m_R.segment(b,s).template cast<Accumulator_t>().squaredNorm(),
+                    m_v.segment(b,s).template cast<Accumulator_t>().dot(m_mass.segment(b,s).template cast<Accumulator_t>().cwiseProduct(m_v.segment(b,s).template cast<Accumulator_t>())));
+    },Sums(Sums::Zero()));
+
+    m_residual = static_cast<T>(math::sqrt(sums[0]));
+    m_Ek = static_cast<T>(sums[1]);
 }
 
-template <class T>
-void gsStaticDR<T>::_peak()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_peak()
 {
     m_R = _computeResidual(m_U+m_DeltaU)- m_damp.cwiseProduct(m_v);
     m_deltaU = - 1.5 * m_dt * m_v + m_dt*m_dt / 2. * m_massInv.cwiseProduct(m_R);
@@ -213,8 +256,8 @@ void gsStaticDR<T>::_peak()
     // m_v = 0.5 * m_dt * m_massInv * m_R; // Velocities at dt/2
 }
 
-template <class T>
-void gsStaticDR<T>::_start()
+template <class T, class ResidualOp>
+void gsStaticDR<T,ResidualOp>::_start()
 {
     m_v.setZero();
 
@@ -230,7 +273,7 @@ void gsStaticDR<T>::_start()
         // Compute current residual and its norm
         m_R = _computeResidual(m_U);
         // m_residual = m_R.norm();
-        m_residual = m_forcing.norm();
+        m_residual = _norm(m_forcing);
         // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
         if (m_residual==0) m_residual=1;
         // All residual norms are equal
@@ -241,13 +284,13 @@ void gsStaticDR<T>::_start()
         // Compute current residual and its norm
         m_R = _computeResidual(m_U + m_DeltaU);
         // m_residual = m_R.norm();
-        m_residual = m_forcing.norm();
+        m_residual = _norm(m_forcing);
         // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
         if (m_residual==0) m_residual=1;
         // The previous step residual is the same as the residual
         m_residualOld = m_residual;
         // Residual0 is the residual without m_DeltaU
-        m_residualIni = _computeResidual(m_U).norm();
+        m_residualIni = _norm(_computeResidual(m_U));
         // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
         if (m_residualIni==0) m_residualIni=1;
 
@@ -263,7 +306,7 @@ void gsStaticDR<T>::_start()
 
     m_DeltaU += m_deltaU;
 
-    m_Ek = m_v.transpose() * m_mass.cwiseProduct(m_v);
+    m_Ek = _kineticEnergy(m_v);
 }
 
 } // namespace gismo
@@ -0,0 +1,248 @@
+ /** @file gsStaticDeflatedNewton.h
+
+    @brief Static solver using a deflated Newton method to find multiple equilibria
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticBase.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSymmetricStorage.h>
+#pragma once
+
+
+namespace gismo
+{
+
+/**
+    @brief Static solver using a deflated Newton method
+
+    The solver searches for multiple distinct equilibrium states of the system
+    R(u) = 0. Every search is a Newton iteration on the deflated residual
+
+        M(u) R(u),   M(u) = \prod_i ( ||u-u_i||^{-p} + \sigma ),
+
+    where u_i are the equilibria that are already known. Because of the
+    deflation operator M(u), a search that converges cannot converge to one of
+    the u_i. Following Farrell et al. (2015), the deflated Newton update is a
+    scaled version of the plain Newton update, so only one factorization per
+    iteration is needed.
+
+    Several searches are launched in parallel (OpenMP), each starting from a
+    random perturbation of the linear solution. The searches of one round are
+    deflated with the equilibria known at the start of that round. The found
+    equilibria are merged, and the next round is deflated with the enlarged
+    set. The solver stops when a round does not produce new equilibria or
+    when the maximum number of rounds is reached.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template <class T>
+class gsStaticDeflatedNewton : public gsStaticBase<T>
+{
+protected:
+
+    typedef gsStaticBase<T> Base;
+
+    typedef typename Base::Residual_t    Residual_t;
+    typedef typename Base::ALResidual_t  ALResidual_t;
+    typedef typename Base::Jacobian_t    Jacobian_t;
+    typedef typename Base::dJacobian_t   dJacobian_t;
+
+public:
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  linear     The linear stiffness matrix
+     * @param[in]  force      The external force
+     * @param[in]  nonlinear  The Jacobian
+     * @param[in]  residual   The residual
+     */
+    gsStaticDeflatedNewton( const gsSparseMatrix<T> &linear,
+                            const gsVector<T> &force,
+                            const Jacobian_t &nonlinear,
+                            const Residual_t &residual      )
+    :
+        m_linear(linear),
+        m_force(force),
+        m_nonlinear(nonlinear),
+        m_residualFun(residual),
+        m_ALresidualFun(nullptr)
+    {
+        this->_init();
+    }
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  linear      The linear stiffness matrix
+     * @param[in]  force       The external force
+     * @param[in]  nonlinear   The Jacobian
+     * @param[in]  ALResidual  The residual as arc-length object
+     */
+    gsStaticDeflatedNewton( const gsSparseMatrix<T> &linear,
+                            const gsVector<T>  &force,
+                            const Jacobian_t   &nonlinear,
+                            const ALResidual_t &ALResidual  )
+    :
+        m_linear(linear),
+        m_force(force),
+        m_nonlinear(nonlinear),
+        m_residualFun(nullptr),
+        m_ALresidualFun(ALResidual)
+    {
+        m_L = 1.0;
+        this->_init();
+    }
+
+public:
+
+    /// See \ref gsStaticBase
+    gsStatus solve() override;
+
+    /// See \ref gsStaticBase
+    void initOutput() override;
+
+    /// See \ref gsStaticBase
+    void stepOutput(index_t k) override;
+
+    /// See \ref gsStaticBase
+    void defaultOptions() override;
+
+    /// See \ref gsStaticBase
+    void reset() override;
+
+    /// See \ref gsStaticBase
+    void getOptions() override;
+
+    /// Adds a known equilibrium that is deflated from the start (e.g. from a path-following analysis)
+    void addKnownSolution(const gsVector<T> & solution) { m_known.push_back(solution); }
+
+    /// Removes all known equilibria
+    void clearKnownSolutions() { m_known.clear(); }
+
+    /// Returns the distinct equilibria found in the last call to \ref solve (known solutions excluded)
+    const std::vector<gsVector<T>> & solutions() const { return m_solutions; }
+
+    /// Returns the number of distinct equilibria found in the last call to \ref solve
+    index_t numSolutions() const { return m_solutions.size(); }
+
+protected:
+
+    /// Initializes the method
+    void _init();
+
+    /**
+     * @brief      Performs a single deflated Newton search
+     *
+     * The function is thread-safe as long as the operators are, and does not
+     * modify any member of the class.
+     *
+     * @param[in]  U0          The initial guess
+     * @param[in]  deflated    The equilibria to be deflated
+     * @param      U           The converged solution (or the last iterate)
+     * @param      iterations  The number of performed iterations
+     *
+     * @return     The status of the search
+     */
+    gsStatus _deflatedSearch(const gsVector<T> & U0,
+                             const std::vector<gsVector<T>> & deflated,
+                             gsVector<T> & U,
+                             index_t & iterations) const;
+
+    /// Computes the scaling of the Newton update \a dU in \a U due to the deflation of \a deflated
+    T _deflationFactor(const gsVector<T> & U,
+                       const gsVector<T> & dU,
+                       const std::vector<gsVector<T>> & deflated) const;
+
+    /// Returns true if \a U is not within the distance tolerance of any vector in \a solutions
+    bool _isDistinct(const gsVector<T> & U, const std::vector<gsVector<T>> & solutions) const;
+
+    /// Computes the residual, serialized when the operators are not thread-safe
+    bool _residual(const gsVector<T> & U, gsVector<T> & R) const;
+
+    /// Computes the Jacobian, serialized when the operators are not thread-safe
+    bool _jacobian(const gsVector<T> & U, gsSparseMatrix<T> & K) const;
+
+protected:
+
+    const gsSparseMatrix<T> & m_linear;
+    const gsVector<T> & m_force;
+    const Jacobian_t      m_nonlinear;
+          Residual_t      m_residualFun;
+    const ALResidual_t    m_ALresidualFun;
+
+    /// Equilibria provided by the user
+    std::vector<gsVector<T>> m_known;
+    /// Equilibria found by the solver
+    std::vector<gsVector<T>> m_solutions;
+
+    /// Deflation power p and shift sigma
+    T m_power, m_shift;
+    /// Amplitude of the perturbations, relative to the norm of the linear solution
+    T m_perturbation;
+    /// Relative distance below which two equilibria are considered equal
+    T m_distTol;
+    /// Residual norm of the undeformed state, used for the relative residual
+    T m_refResidual;
+    /// Number of parallel searches per round, number of rounds and number of threads
+    index_t m_searches, m_rounds, m_threads;
+    /// Seed of the random perturbations
+    index_t m_seed;
+    /// Whether the operators can be called concurrently
+    bool m_threadSafe;
+    /// Whether the linear matrix and the Jacobian are in symmetric storage (see \ref gsSymmetricStorage)
+    bool m_symmetric;
+    /// Name of the sparse solver used in every search
+    std::string m_solverName;
+
+    /// Statistics of the last round, used for output
+    index_t m_roundConverged, m_roundNew;
+
+    using Base::_norm;
+    using Base::_dot;
+
+    using Base::m_R;
+
+    using Base::m_U;
+    using Base::m_DeltaU;
+    using Base::m_deltaU;
+
+    using Base::m_L;
+
+    using Base::m_verbose;
+
+    using Base::m_options;
+
+    using Base::m_tolF;
+    using Base::m_tolU;
+
+    using Base::m_maxIterations;
+    using Base::m_numIterations;
+
+    using Base::m_start;
+    using Base::m_headstart;
+
+    using Base::m_stabilityMethod;
+
+    using Base::m_dofs;
+
+    // Solver status
+    using Base::m_status;
+};
+
+
+} // namespace gismo
+
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsStaticDeflatedNewton.hpp)
+#endif
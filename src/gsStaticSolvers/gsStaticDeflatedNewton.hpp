@@ -0,0 +1,330 @@
+ /** @file gsStaticDeflatedNewton.hpp
+
+    @brief Static solver using a deflated Newton method to find multiple equilibria
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <random>
+#include <gsParallel/gsOpenMP.h>
+
+#pragma once
+
+namespace gismo
+{
+
+template <class T>
+void gsStaticDeflatedNewton<T>::defaultOptions()
+{
+    Base::defaultOptions();
+    m_options.addReal("DeflationPower","Power p of the deflation operator",2);
+    m_options.addReal("DeflationShift","Shift sigma of the deflation operator",1);
+    m_options.addReal("Perturbation","Amplitude of the initial perturbations, relative to the norm of the linear solution",1);
+    m_options.addReal("DistanceTol","Relative distance below which two equilibria are considered equal",1e-6);
+    m_options.addInt("Searches","Number of parallel searches per round",4);
+    m_options.addInt("Rounds","Maximum number of rounds of parallel searches",3);
+    m_options.addInt("Threads","Number of threads. If <1, the maximum number of threads is used",-1);
+    m_options.addInt("Seed","Seed for the random perturbations",0);
+    m_options.addSwitch("ThreadSafe","The residual and Jacobian operators can be called concurrently. If false, calls to the operators are serialized",false);
+    m_options.addSwitch("SymmetricStorage","The linear matrix and the Jacobian operator provide only the lower triangle (column-major) of the symmetric matrices, see gsSymmetricStorage",false);
+};
+
+template <class T>
+void gsStaticDeflatedNewton<T>::getOptions()
+{
+    Base::getOptions();
+    m_power        = m_options.getReal("DeflationPower");
+    m_shift        = m_options.getReal("DeflationShift");
+    m_perturbation = m_options.getReal("Perturbation");
+    m_distTol      = m_options.getReal("DistanceTol");
+    m_searches     = m_options.getInt("Searches");
+    m_rounds       = m_options.getInt("Rounds");
+    m_threads      = m_options.getInt("Threads");
+    m_seed         = m_options.getInt("Seed");
+    m_threadSafe   = m_options.getSwitch("ThreadSafe");
+    m_symmetric    = m_options.getSwitch("SymmetricStorage");
+    m_solverName   = m_options.askString("Solver","SimplicialLDLT");
+
+    if (m_threads < 1)
+        m_threads = omp_get_max_threads();
+};
+
+template <class T>
+void gsStaticDeflatedNewton<T>::initOutput()
+{
+    gsInfo<<"\t";
+    gsInfo<<std::setw(8)<<std::left<<"Round";
+    gsInfo<<std::setw(17)<<std::left<<"Searches";
+    gsInfo<<std::setw(17)<<std::left<<"Converged";
+    gsInfo<<std::setw(17)<<std::left<<"New";
+    gsInfo<<std::setw(17)<<std::left<<"Total";
+    gsInfo<<"\n";
+}
+
+template <class T>
+void gsStaticDeflatedNewton<T>::stepOutput(index_t k)
+{
+    gsInfo<<"\t";
+    gsInfo<<std::setw(8)<<std::left<<k;
+    gsInfo<<std::setw(17)<<std::left<<m_searches;
+    gsInfo<<std::setw(17)<<std::left<<m_roundConverged;
+    gsInfo<<std::setw(17)<<std::left<<m_roundNew;
+    gsInfo<<std::setw(17)<<std::left<<m_solutions.size();
+    gsInfo<<"\n";
+}
+
+template <class T>
+gsStatus gsStaticDeflatedNewton<T>::solve()
+{
+    this->getOptions();
+    m_solutions.clear();
+    m_numIterations = 0;
+
+    // Reference residual, corresponding to the undeformed state
+    gsVector<T> R0;
+    if (!_residual(gsVector<T>::Zero(m_dofs),R0))
+    {
+        m_status = gsStatus::AssemblyError;
+        return m_status;
+    }
+    m_refResidual = _norm(R0);
+    // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
+    if (m_refResidual==0) m_refResidual = 1;
+
+    // Base state for the perturbations: the provided displacement or the linear solution
+    gsVector<T> U0;
+    if (m_start)
+        U0 = m_U;
+    else
+    {
+        typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get(m_solverName);
+        gsSparseMatrix<T> full;
+        solver->compute(m_symmetric ? gsSymmetricStorage<T>::forSolver(*solver,m_linear,full) : m_linear);
+        if (solver->info()!=gsEigen::ComputationInfo::Success)
+        {
+            m_status = gsStatus::SolverError;
+            return m_status;
+        }
+        U0 = solver->solve(m_force);
+    }
+    const T U0norm = _norm(U0);
+    T amplitude = m_perturbation * (U0norm!=0 ? U0norm : (T)(1));
+
+    std::mt19937 gen(m_seed);
+    std::normal_distribution<double> dist(0.0,1.0);
+
+    std::vector<gsVector<T>> deflated = m_known;
+    std::vector<gsVector<T>> starts(m_searches), results(m_searches);
+    std::vector<gsStatus> status(m_searches);
+    std::vector<index_t> iterations(m_searches);
+    gsVector<T> pert(m_dofs);
+
+    if (m_verbose>0) { initOutput(); }
+    for (index_t r = 0; r!=m_rounds; r++)
+    {
+        // The perturbations are generated serially to make the result independent of the number of threads
+        for (index_t s = 0; s!=m_searches; s++)
+        {
+            if (r==0 && s==0)
+            {
+                starts[s] = U0;
+                continue;
+            }
+            for (index_t i = 0; i!=m_dofs; i++)
+                pert[i] = (T)(dist(gen));
+            starts[s] = U0 + amplitude * pert / math::sqrt((T)(m_dofs));
+        }
+
+#pragma omp parallel for num_threads(m_threads) schedule(dynamic,1)
+        for (index_t s = 0; s < m_searches; s++)
+            status[s] = _deflatedSearch(starts[s],deflated,results[s],iterations[s]);
+
+        // Merge the converged searches, in order of the searches
+        m_roundConverged = m_roundNew = 0;
+        for (index_t s = 0; s!=m_searches; s++)
+        {
+            m_numIterations += iterations[s];
+            if (status[s]!=gsStatus::Success)
+                continue;
+            m_roundConverged++;
+            // Both the deflated states and the states found in this round are compared
+            if (_isDistinct(results[s],deflated))
+            {
+                deflated.push_back(results[s]);
+                m_solutions.push_back(results[s]);
+                m_roundNew++;
+            }
+        }
+
+        if (m_verbose>0) { stepOutput(r); }
+
+        if (m_roundNew==0)
+            break;
+    }
+
+    if (m_solutions.size()!=0)
+    {
+        m_U = m_solutions.front();
+        m_DeltaU.setZero(m_dofs);
+        m_status = gsStatus::Success;
+    }
+    else
+        m_status = gsStatus::NotConverged;
+
+    return m_status;
+}
+
+template <class T>
+gsStatus gsStaticDeflatedNewton<T>::_deflatedSearch(const gsVector<T> & U0,
+                                                    const std::vector<gsVector<T>> & deflated,
+                                                    gsVector<T> & U,
+                                                    index_t & iterations) const
+{
+    iterations = 0;
+    U = U0;
+    try
+    {
+        // Every search has its own solver
+        typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get(m_solverName);
+
+        gsSparseMatrix<T> K, Kfull;
+        gsVector<T> R, dU;
+        if (!_residual(U,R))
+            throw 2;
+
+        for (iterations = 0; iterations != m_maxIterations; ++iterations)
+        {
+            if (!_jacobian(U,K))
+                throw 2;
+            // In symmetric storage, the full matrix is only made for solvers that do not read the stored triangle
+            solver->compute(m_symmetric ? gsSymmetricStorage<T>::forSolver(*solver,K,Kfull) : K);
+            if (solver->info()!=gsEigen::ComputationInfo::Success)
+                throw 3;
+            dU = solver->solve(R);
+
+            dU *= _deflationFactor(U,dU,deflated);
+            U += dU;
+
+            if (!U.allFinite())
+                throw 1;
+
+            if (!_residual(U,R))
+                throw 2;
+
+            // The update is relative to the solution, unless it is close to zero (e.g. the trivial root)
+            if (_norm(dU) <= m_tolU*math::max(_norm(U),(T)(1)) && _norm(R)/m_refResidual < m_tolF)
+            {
+                ++iterations;
+                return gsStatus::Success;
+            }
+        }
+        throw 1;
+    }
+    catch (int errorCode)
+    {
+        if      (errorCode==1)
+            return gsStatus::NotConverged;
+        else if (errorCode==2)
+            return gsStatus::AssemblyError;
+        else if (errorCode==3)
+            return gsStatus::SolverError;
+        else
+            return gsStatus::OtherError;
+    }
+    catch (...)
+    {
+        return gsStatus::OtherError;
+    }
+}
+
+template <class T>
+T gsStaticDeflatedNewton<T>::_deflationFactor(const gsVector<T> & U,
+                                              const gsVector<T> & dU,
+                                              const std::vector<gsVector<T>> & deflated) const
+{
+    // (grad M(u) . dU) / M(u) = sum_i -p ||u-u_i||^(-p-2) (u-u_i).dU / (||u-u_i||^(-p) + sigma)
+    T eta = 0, dist, distp;
+    for (typename std::vector<gsVector<T>>::const_iterator it = deflated.begin(); it!=deflated.end(); it++)
+    {
+        dist  = _norm(U - *it);
+        if (dist==0)
+            throw 1; // the iterate coincides with a deflated solution
+        distp = math::pow(dist,-m_power);
+        eta  += -m_power * distp / (dist*dist) * _dot(U - *it,dU) / (distp + m_shift);
+    }
+    // The deflated update is dU / (1 - eta). When eta approaches 1, the deflation is ignored
+    return math::abs(1 - eta) > std::numeric_limits<T>::epsilon() ? 1 / (1 - eta) : (T)(1);
+}
+
+template <class T>
+bool gsStaticDeflatedNewton<T>::_isDistinct(const gsVector<T> & U, const std::vector<gsVector<T>> & solutions) const
+{
+    for (typename std::vector<gsVector<T>>::const_iterator it = solutions.begin(); it!=solutions.end(); it++)
+        if (_norm(U - *it) <= m_distTol * math::max(math::max(_norm(U),_norm(*it)),(T)(1)))
+            return false;
+    return true;
+}
+
+template <class T>
+bool gsStaticDeflatedNewton<T>::_residual(const gsVector<T> & U, gsVector<T> & R) const
+{
+    bool success;
+    if (m_threadSafe)
+        success = m_residualFun!=nullptr ? m_residualFun(U,R) : m_ALresidualFun(U,m_L,R);
+    else
+    {
+#pragma omp critical (gsStaticDeflatedNewton_operators)
+        success = m_residualFun!=nullptr ? m_residualFun(U,R) : m_ALresidualFun(U,m_L,R);
+    }
+    return success;
+}
+
+template <class T>
+bool gsStaticDeflatedNewton<T>::_jacobian(const gsVector<T> & U, gsSparseMatrix<T> & K) const
+{
+    bool success;
+    if (m_threadSafe)
+        success = m_nonlinear(U,K);
+    else
+    {
+#pragma omp critical (gsStaticDeflatedNewton_operators)
+        success = m_nonlinear(U,K);
+    }
+    return success;
+}
+
+template <class T>
+void gsStaticDeflatedNewton<T>::reset()
+{
+    m_dofs = m_force.rows();
+    // resets m_U, m_DeltaU, m_deltaU, m_R, m_L, m_DeltaL, m_deltaL and m_headstart
+    Base::reset();
+    m_solutions.clear();
+}
+
+template <class T>
+void gsStaticDeflatedNewton<T>::_init()
+{
+    this->reset();
+
+    m_stabilityMethod = 0;
+    m_start = false;
+
+    m_dofs = m_linear.rows();
+    if (m_dofs==0)
+        gsWarn<<"The number of degrees of freedom is equal to zero. This can lead to bad initialization.\n";
+
+    m_roundConverged = m_roundNew = 0;
+
+    defaultOptions();
+
+    m_status = gsStatus::NotStarted;
+}
+
+} // namespace gismo
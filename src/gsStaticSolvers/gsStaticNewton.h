@@ -12,6 +12,9 @@
 */
 
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticBase.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsRecyclingCG.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSparsityPattern.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSymmetricStorage.h>
 #pragma once
 
 
@@ -36,6 +39,7 @@ protected:
     typedef typename Base::ALResidual_t  ALResidual_t;
     typedef typename Base::Jacobian_t    Jacobian_t;
     typedef typename Base::dJacobian_t   dJacobian_t;
+    typedef typename Base::ResidualJacobian_t ResidualJacobian_t;
 
 public:
 
@@ -56,6 +60,32 @@ public:
         this->_init();
     }
 
+    /**
+     * @brief      Constructor
+     *
+     * The residual and the Jacobian are computed in one call of \a
+     * residualJacobian. The Jacobian computed with the residual is kept and
+     * used when the Jacobian is requested on the same solution.
+     *
+     * @param[in]  linear            The linear stiffness matrix
+     * @param[in]  force             The external force
+     * @param[in]  residualJacobian  The residual and the Jacobian
+     */
+    gsStaticNewton( const gsSparseMatrix<T> &linear,
+                    const gsVector<T> &force,
+                    const ResidualJacobian_t &residualJacobian )
+    :
+        m_linear(linear),
+        m_force(force),
+        m_nonlinear(nullptr),
+        m_dnonlinear(nullptr),
+        m_residualFun(nullptr),
+        m_ALresidualFun(nullptr),
+        m_residualJacobian(residualJacobian)
+    {
+        this->_init();
+    }
+
     /**
      * @brief      Constructor
      *
@@ -76,11 +106,6 @@ public:
         m_residualFun(residual),
         m_ALresidualFun(nullptr)
     {
-        m_dnonlinear = [this](gsVector<T> const & x, gsVector<T> const & /*dx*/, gsSparseMatrix<T> & m) -> bool
-        {
-            return m_nonlinear(x,m);
-        };
-
         this->_init();
     }
 
@@ -105,16 +130,6 @@ public:
         m_ALresidualFun(ALResidual)
     {
         m_L = 1.0;
-        m_residualFun = [this](gsVector<T> const & x, gsVector<T> & result) -> bool
-        {
-            return m_ALresidualFun(x,m_L,result);
-        };
-
-        m_dnonlinear = [this](gsVector<T> const & x, gsVector<T> const & /*dx*/, gsSparseMatrix<T> & m) -> bool
-        {
-            return m_nonlinear(x,m);
-        };
-
         this->_init();
     }
 
@@ -191,7 +206,8 @@ public:
     T indicator()
     {
         gsSparseMatrix<T> m;
-        GISMO_ENSURE(m_nonlinear(m_U, m),"Assembly failed");
+        gsVector<T> dU = gsVector<T>::Zero(m_U.rows());
+        GISMO_ENSURE(this->_assembleJacobian(m_U, dU, m),"Assembly failed");
         return indicator(m);
     }
 
@@ -199,10 +215,14 @@ public:
     gsVector<T> stabilityVec()
     {
         gsSparseMatrix<T> m;
-        GISMO_ENSURE(m_nonlinear(m_U, m),"Assembly failed");
+        gsVector<T> dU = gsVector<T>::Zero(m_U.rows());
+        GISMO_ENSURE(this->_assembleJacobian(m_U, dU, m),"Assembly failed");
         return stabilityVec(m);
     }
 
+    /// Returns the sparsity pattern of the last factorization, see option 'PatternStable'
+    const gsSparsityPattern<T> & pattern() const { return m_pattern; }
+
 protected:
 
     /// Perform a linear solve
@@ -211,6 +231,7 @@ protected:
     gsVector<T> _solveNonlinear();
 
     using Base::_computeStability;
+    using Base::_norm;
 
     /// Initializes the method
     void _init();
@@ -223,7 +244,11 @@ protected:
 
     gsVector<T> _computeResidual(const gsVector<T> & U);
 
-    gsSparseMatrix<T> _computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU);
+    /// Computes the Jacobian in \a m. If the pattern is stable, the operator overwrites the matrix of the previous iteration
+    void _computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU, gsSparseMatrix<T> & m);
+
+    /// Calls the Jacobian operator that was given to the constructor, returns its status
+    bool _assembleJacobian(const gsVector<T> & U, const gsVector<T> & deltaU, gsSparseMatrix<T> & m) const;
 
 protected:
 
@@ -233,6 +258,14 @@ protected:
           dJacobian_t     m_dnonlinear;
           Residual_t      m_residualFun;
     const ALResidual_t    m_ALresidualFun;
+    const ResidualJacobian_t m_residualJacobian;
+
+    /// Jacobian computed together with the last residual, or residual computed together with the last Jacobian, and the solution it belongs to
+    gsSparseMatrix<T> m_fusedJacobian;
+    gsVector<T>       m_fusedResidual;
+    gsVector<T>       m_fusedU;
+    bool              m_fusedValid;
+    bool              m_fusedResidualValid;
 
     using Base::m_R;
 
@@ -269,6 +302,21 @@ protected:
     /// Linear solver employed
     using Base::m_solver;   // Cholesky by default
 
+    /// Recycling CG solver, used instead of m_solver when m_recycling > 0
+    mutable gsRecyclingCG<T> m_recycler;
+    /// Number of recycled vectors
+    index_t m_recycling;
+    /// Whether the last factorized Jacobian is solved with the recycling CG solver
+    mutable bool m_recyclerActive;
+
+    /// Whether the sparsity pattern of the Jacobian is stable, and the pattern of the last factorization
+    bool m_patternStable;
+    mutable gsSparsityPattern<T> m_pattern;
+
+    /// Whether the linear matrix and the Jacobian are in symmetric storage (see \ref gsSymmetricStorage), and the full matrix for solvers that do not read the stored triangle
+    bool m_symmetric;
+    mutable gsSparseMatrix<T> m_symmetricFull;
+
     using Base::m_stabilityMethod;
 
     /// Indicator for bifurcation
@@ -22,6 +22,13 @@ void gsStaticNewton<T>::defaultOptions()
     Base::defaultOptions();
     m_options.setString("Solver","CGDiagonal"); // The CG solver is robust for membrane models, where zero-blocks in the matrix might occur.
     m_options.addReal("Relaxation","Relaxation parameter",1);
+    m_options.addInt("Recycling","Number of Ritz vectors recycled over subsequent solves by a deflated CG solver. If 0, the sparse linear solver from 'Solver' is used",0);
+    m_options.addReal("RecyclingTol","Relative tolerance on the residual of the recycling CG solver. If <=0, 1e-2*tolF is used",-1);
+    m_options.addInt("RecyclingMaxIt","Maximum number of iterations of the recycling CG solver. If <=0, twice the number of degrees of freedom is used",-1);
+    m_options.addInt("KernelThreads","Number of threads of the kernels of the recycling CG solver and the norms. If 0, the serial kernels of Eigen are used in the CG solver; if <0, the maximum number of threads is used. The results do not depend on the number of threads (>0)",0);
+    m_options.addInt("BlockLayout","Format of the matrix products of the recycling CG solver: 0: scalar sparse; 1: 3x3 blocks, DoFs ordered per component, with the same number of DoFs per component; 2: 3x3 blocks, DoFs ordered per node. A matrix whose size is not a multiple of 3 is multiplied in the scalar format",0);
+    m_options.addSwitch("PatternStable","The sparsity pattern of the Jacobian does not change. The Jacobian operator overwrites the matrix of the previous iteration, and the symbolic factorization is reused",false);
+    m_options.addSwitch("SymmetricStorage","The linear matrix and the Jacobian operator provide only the lower triangle (column-major) of the symmetric matrices, see gsSymmetricStorage",false);
 };
 
 template <class T>
@@ -36,6 +43,16 @@ void gsStaticNewton<T>::getOptions()
     // }
 
     m_relax = m_options.getReal("Relaxation");
+    m_recycling = m_options.getInt("Recycling");
+    m_recycler.setRecycleSize(m_recycling);
+    m_recycler.setTolerance(m_options.getReal("RecyclingTol") > 0 ? m_options.getReal("RecyclingTol") : 1e-2*m_tolF);
+    m_recycler.setMaxIterations(m_options.getInt("RecyclingMaxIt"));
+    m_recycler.setBlockLayout(m_options.getInt("BlockLayout"));
+    m_recycler.setNumThreads(m_options.getInt("KernelThreads"));
+    m_patternStable = m_options.getSwitch("PatternStable");
+    // The solver is created again, hence its analysis cannot be reused
+    m_pattern.clear();
+    m_symmetric = m_options.getSwitch("SymmetricStorage");
 };
 
 template <class T>
@@ -61,10 +78,10 @@ void gsStaticNewton<T>::stepOutput(index_t k)
     gsInfo<<std::setw(4)<<std::left<<k;
     gsInfo<<std::setw(17)<<std::left<<m_residual;
     gsInfo<<std::setw(17)<<std::left<<m_residual/m_residualIni;
-    gsInfo<<std::setw(17)<<std::left<<m_DeltaU.norm();
-    gsInfo<<std::setw(17)<<std::left<<m_relax * m_deltaU.norm();
-    gsInfo<<std::setw(17)<<std::left<<m_relax * m_deltaU.norm()/m_DeltaU.norm();
-    gsInfo<<std::setw(17)<<std::left<<m_relax * m_deltaU.norm()/(m_U+m_DeltaU).norm();
+    gsInfo<<std::setw(17)<<std::left<<_norm(m_DeltaU);
+    gsInfo<<std::setw(17)<<std::left<<m_relax * _norm(m_deltaU);
+    gsInfo<<std::setw(17)<<std::left<<m_relax * _norm(m_deltaU)/_norm(m_DeltaU);
+    gsInfo<<std::setw(17)<<std::left<<m_relax * _norm(m_deltaU)/_norm(m_U+m_DeltaU);
     gsInfo<<std::setw(17)<<std::left<<math::log10(m_residualOld/m_residualIni);
     gsInfo<<std::setw(17)<<std::left<<math::log10(m_residual/m_residualIni);
     gsInfo<<"\n";
@@ -145,7 +162,7 @@ gsVector<T> gsStaticNewton<T>::_solveNonlinear()
     // m_start: true -> m_U given
     // m_headstart: true -> m_DeltaU given
 
-    if (m_DeltaU.norm()==0 && m_DeltaU.rows()==0) ///
+    if (_norm(m_DeltaU)==0 && m_DeltaU.rows()==0) ///
     {
         m_deltaU = m_DeltaU = this->_solveLinear();
         m_U.setZero(); // Needed because linear solve modifies m_U.
@@ -159,7 +176,7 @@ gsVector<T> gsStaticNewton<T>::_solveNonlinear()
 
     for (m_numIterations = 0; m_numIterations != m_maxIterations; ++m_numIterations)
     {
-        jacMat = this->_computeJacobian(m_U+m_DeltaU,m_deltaU);
+        this->_computeJacobian(m_U+m_DeltaU,m_deltaU,jacMat);
         if (m_verbose==2)
         {
             gsInfo<<"Matrix: \n"<<jacMat.toDense()<<"\n";
@@ -171,13 +188,13 @@ gsVector<T> gsStaticNewton<T>::_solveNonlinear()
         m_DeltaU += m_relax * m_deltaU;
 
         m_R = this->_computeResidual(m_U+m_DeltaU);
-        m_residual = m_R.norm();
+        m_residual = _norm(m_R);
 
         if (m_verbose>0) { stepOutput(m_numIterations); }
 
         m_residualOld = m_residual;
 
-        if (m_relax * m_deltaU.norm()/m_DeltaU.norm()  < m_tolU && m_residual/m_residualIni < m_tolF)
+        if (m_relax * _norm(m_deltaU)/_norm(m_DeltaU)  < m_tolU && m_residual/m_residualIni < m_tolF)
         {
             m_U+=m_DeltaU;
             break;
@@ -196,25 +213,95 @@ template <class T>
 gsVector<T> gsStaticNewton<T>::_computeResidual(const gsVector<T> & U)
 {
   gsVector<T> resVec;
-  if (!m_residualFun(U, resVec))
+  if (m_residualJacobian!=nullptr)
+  {
+    // The residual computed with the last Jacobian on the same solution is used
+    if (m_fusedResidualValid && m_fusedU.rows()==U.rows() && m_fusedU==U)
+    {
+      m_fusedResidualValid = false;
+      resVec.swap(m_fusedResidual);
+      return resVec;
+    }
+    // Keep the Jacobian for the next call of _computeJacobian
+    m_fusedValid = m_fusedResidualValid = false;
+    if (!m_residualJacobian(U, resVec, m_fusedJacobian))
+      throw 2;
+    m_fusedU = U;
+    m_fusedValid = true;
+  }
+  else if (m_residualFun!=nullptr ? !m_residualFun(U, resVec) : !m_ALresidualFun(U, m_L, resVec))
     throw 2;
   return resVec;
 }
 
 template <class T>
-gsSparseMatrix<T> gsStaticNewton<T>::_computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU)
+void gsStaticNewton<T>::_computeJacobian(const gsVector<T> & U, const gsVector<T> & deltaU, gsSparseMatrix<T> & m)
 {
   // Compute Jacobian
-  gsSparseMatrix<T> m;
-  if (!m_dnonlinear(U,deltaU,m))
+  if (m_fusedValid && m_fusedU.rows()==U.rows() && m_fusedU==U)
+  {
+    // The matrix of the previous iteration is passed to the next fused evaluation
+    m_fusedValid = false;
+    m.swap(m_fusedJacobian);
+    return;
+  }
+  if (!m_patternStable)
+    m.resize(0,0);
+  if (m_dnonlinear==nullptr && m_nonlinear==nullptr)
+  {
+    // Keep the residual for the next call of _computeResidual, such that the fused operator is called once per solution
+    m_fusedValid = m_fusedResidualValid = false;
+    if (!m_residualJacobian(U, m_fusedResidual, m))
+      throw 2;
+    m_fusedU = U;
+    m_fusedResidualValid = true;
+  }
+  else if (!this->_assembleJacobian(U,deltaU,m))
     throw 2;
-  return m;
+  if (m_patternStable && !m.isCompressed())
+    m.makeCompressed();
+}
+
+template <class T>
+bool gsStaticNewton<T>::_assembleJacobian(const gsVector<T> & U, const gsVector<T> & deltaU, gsSparseMatrix<T> & m) const
+{
+  if (m_dnonlinear!=nullptr)
+    return m_dnonlinear(U,deltaU,m);
+  else if (m_nonlinear!=nullptr)
+    return m_nonlinear(U,m);
+  gsVector<T> R;
+  return m_residualJacobian(U,R,m);
 }
 
 template <class T>
 void gsStaticNewton<T>::_factorizeMatrix(const gsSparseMatrix<T> & jacMat) const
 {
-    m_solver->compute(jacMat);
+    m_recyclerActive = false;
+    if (m_recycling > 0)
+    {
+        if (m_symmetric)
+        {
+            gsSymmetricStorage<T>::full(jacMat,m_symmetricFull);
+            m_recycler.compute(m_symmetricFull);
+        }
+        else
+            m_recycler.compute(jacMat);
+        // CG requires a symmetric positive definite Jacobian, otherwise the sparse linear solver is used
+        if (m_recycler.info()==gsEigen::ComputationInfo::Success)
+        {
+            m_recyclerActive = true;
+            return;
+        }
+        if (m_verbose>0)
+            gsWarn<<"The Jacobian is not symmetric or has a non-positive diagonal. The sparse linear solver is used instead of the recycling CG solver.\n";
+    }
+
+    // In symmetric storage, the full matrix is only made for solvers that do not read the stored triangle
+    const gsSparseMatrix<T> & A = m_symmetric ? gsSymmetricStorage<T>::forSolver(*m_solver,jacMat,m_symmetricFull) : jacMat;
+    if (m_patternStable)
+      m_pattern.factorize(*m_solver,A);
+    else
+      m_solver->compute(A);
     if (m_solver->info()!=gsEigen::ComputationInfo::Success)
     {
       gsInfo<<"Solver error with code "<<m_solver->info()<<". See Eigen documentation on ComputationInfo \n"
@@ -231,6 +318,27 @@ gsVector<T> gsStaticNewton<T>::_solveSystem(const gsVector<T> & F)
 {
     try
     {
+      if (m_recyclerActive)
+      {
+        gsVector<T> x = m_recycler.solve(F);
+        if (m_recycler.info()==gsEigen::ComputationInfo::Success)
+          return x;
+        if (m_recycler.info()==gsEigen::ComputationInfo::NoConvergence)
+        {
+          if (m_verbose>0)
+            gsWarn<<"Recycling CG did not converge in "<<m_recycler.iterations()<<" iterations, relative residual = "<<m_recycler.error()<<"\n";
+          throw 3;
+        }
+        // The Jacobian is indefinite, hence it is factorized with the sparse linear solver
+        if (m_verbose>0)
+          gsWarn<<"The Jacobian is not positive definite. The sparse linear solver is used instead of the recycling CG solver.\n";
+        m_recyclerActive = false;
+        // The full matrix has another pattern than the one analyzed before
+        m_pattern.clear();
+        m_solver->compute(m_recycler.matrix());
+        if (m_solver->info()!=gsEigen::ComputationInfo::Success)
+          throw 3;
+      }
       return m_solver->solve(F);
     }
     catch (...)
@@ -251,13 +359,19 @@ template <class T>
 void gsStaticNewton<T>::_init()
 {
     this->reset();
-    if( m_dnonlinear==nullptr || m_residualFun==nullptr)
+    if( (m_dnonlinear==nullptr && m_nonlinear==nullptr && m_residualJacobian==nullptr) ||
+        (m_residualFun==nullptr && m_ALresidualFun==nullptr && m_residualJacobian==nullptr) )
         m_NL=false;
     else
         m_NL = true;
 
     m_stabilityMethod = 0;
     m_start = false;
+    m_recycling = 0;
+    m_recyclerActive = false;
+    m_patternStable = false;
+    m_symmetric = false;
+    m_fusedValid = m_fusedResidualValid = false;
 
     m_dofs = m_linear.rows();
     if (m_dofs==0)
@@ -285,7 +399,7 @@ void gsStaticNewton<T>::_start()
         m_DeltaU.setZero(m_dofs);
         // Compute current residual and its norm
         m_R = this->_computeResidual(m_U);
-        m_residual = m_R.norm();
+        m_residual = _norm(m_R);
         // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
         if (m_residual==0) m_residual=1;
         // All residual norms are equal
@@ -294,17 +408,17 @@ void gsStaticNewton<T>::_start()
     else
     {
         // If we have a headstart, we need to compute Residual0 on the solution m_U
-        // Compute current residual and its norm
+        // Residual0 is the residual without m_DeltaU
+        m_residualIni = _norm(this->_computeResidual(m_U));
+        // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
+        if (m_residualIni==0) m_residualIni=1;
+        // Compute current residual and its norm. This one is computed last, since the first iteration starts on it
         m_R = this->_computeResidual(m_U + m_DeltaU);
-        m_residual = m_R.norm();
+        m_residual = _norm(m_R);
         // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
         if (m_residual==0) m_residual=1;
         // The previous step residual is the same as the residual
         m_residualOld = m_residual;
-        // Residual0 is the residual without m_DeltaU
-        m_residualIni = this->_computeResidual(m_U).norm();
-        // If the residual is 0 (e.g. with purely displacment loading), we set it to 1 to allow divisions
-        if (m_residualIni==0) m_residualIni=1;
 
         // Now we can reset the headstart
         m_headstart = false;
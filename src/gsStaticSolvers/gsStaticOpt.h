@@ -94,9 +94,12 @@ public:
     {
         gsVector<T> result;
         m_residualFun(u,result);
-        return result.norm();
+        return m_kernels.norm(result);
     }
 
+    /// Sets the number of threads of the norms
+    void setNumThreads(index_t numThreads) { m_kernels.setNumThreads(numThreads); }
+
     /**
      * @brief Computes the gradient of the objective function.
      *
@@ -116,6 +119,7 @@ private:
     Residual_t m_residualFun;
     ALResidual_t m_ALresidualFun;
     const T & m_L;
+    gsParallelKernels<T> m_kernels;
     // Lastly, we forward the memebers of the base clase gsOptProblem
     using Base::m_numDesignVars;
     using Base::m_numConstraints;
@@ -274,6 +278,8 @@ protected:
 
     // Solver status
     using Base::m_status;
+
+    using Base::m_kernels;
 };
 
 
@@ -55,6 +55,7 @@ template <class T, class Optimizer>
 void gsStaticOpt<T,Optimizer>::getOptions()
 {
     Base::getOptions();
+    m_optProblem.setNumThreads(m_kernels.numThreads());
 
     m_optimizer.options().setInt("MaxIterations",m_maxIterations);
     m_optimizer.options().setInt("Verbose",m_verbose);
@@ -0,0 +1,309 @@
+ /** @file gsBlockSparseMatrix.h
+
+    @brief Node-blocked sparse matrix format for vector-valued unknowns
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsParallel/gsOpenMP.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Sparse matrix stored in blocks of size B x B per pair of nodes (block compressed rows)
+
+    The unknowns of shell and solid models come in groups of B (usually 3)
+    components per control point. In the block format, the column indices are
+    stored once per block instead of once per coefficient, and the product
+    with a vector is computed with fixed-size B x B kernels, which increases
+    the arithmetic intensity of the product compared to the scalar format.
+
+    The matrix is made from a square gsSparseMatrix. The degrees of freedom
+    are either ordered per component (all first components, then all second
+    components, etc.), which is the ordering of the assemblers in G+Smo, or
+    per node (interleaved). Both layouts require B times the number of nodes
+    rows, and the ordering per component moreover requires the same number of
+    degrees of freedom for every component. For other matrices, e.g. after the
+    elimination of Dirichlet conditions on some of the components, the node
+    and the component of every degree of freedom are given explicitly (for
+    example from a gsDofMapper); the missing components of a node are then
+    treated as zero.
+
+    The format is meant for repeated products with the same matrix, e.g. in
+    explicit time integration and Krylov solvers. Factorizations should use
+    the gsSparseMatrix.
+
+    \tparam T coefficient type
+    \tparam B block size
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T, int B = 3>
+class gsBlockSparseMatrix
+{
+    typedef gsEigen::Matrix<T,B,B,gsEigen::RowMajor> Block;
+    typedef gsEigen::Matrix<T,B,1> BlockVector;
+
+public:
+
+    /// Block size
+    enum { BlockSize = B };
+
+    gsBlockSparseMatrix()
+    :
+    m_rows(0),
+    m_nodes(0),
+    m_layout(0)
+    { }
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  matrix       The matrix
+     * @param[in]  interleaved  Whether the degrees of freedom are ordered per node instead of per component
+     */
+    gsBlockSparseMatrix(const gsSparseMatrix<T> & matrix, bool interleaved = false)
+    {
+        GISMO_ENSURE(this->assign(matrix,interleaved),"The size of the matrix ("<<matrix.rows()<<") is not a multiple of the block size ("<<B<<")");
+    }
+
+    /**
+     * @brief      Makes the block pattern and the coefficients from \a matrix, with the degrees of freedom ordered per component or per node
+     *
+     * @param[in]  matrix       The matrix
+     * @param[in]  interleaved  Whether the degrees of freedom are ordered per node instead of per component
+     *
+     * @return     False if the size of \a matrix is not a multiple of the block size; the matrix is then empty
+     */
+    bool assign(const gsSparseMatrix<T> & matrix, bool interleaved = false)
+    {
+        GISMO_ENSURE(matrix.rows()==matrix.cols(),"The matrix should be square, but is "<<matrix.rows()<<" x "<<matrix.cols());
+        if (matrix.rows() % B != 0)
+        {
+            this->clear();
+            return false;
+        }
+        const index_t nodes = matrix.rows() / B;
+        gsVector<index_t> node(matrix.rows()), comp(matrix.rows());
+        for (index_t i = 0; i!=matrix.rows(); i++)
+        {
+            node[i] = interleaved ? i / B : i % nodes;
+            comp[i] = interleaved ? i % B : i / nodes;
+        }
+        this->_assign(matrix,node,comp);
+        m_layout = interleaved ? 2 : 1;
+        return true;
+    }
+
+    /**
+     * @brief      Makes the block pattern and the coefficients from \a matrix, given the node and the component of every degree of freedom
+     *
+     * @param[in]  matrix  The matrix
+     * @param[in]  node    The node of every degree of freedom
+     * @param[in]  comp    The component (0,...,B-1) of every degree of freedom. Every pair of node and component appears at most once
+     *
+     * @return     False if the maps do not fit \a matrix; the matrix is then empty
+     */
+    bool assign(const gsSparseMatrix<T> & matrix, const gsVector<index_t> & node, const gsVector<index_t> & comp)
+    {
+        GISMO_ENSURE(matrix.rows()==matrix.cols(),"The matrix should be square, but is "<<matrix.rows()<<" x "<<matrix.cols());
+        if (node.rows()!=matrix.rows() || comp.rows()!=matrix.rows() || (matrix.rows()!=0 &&
+            (node.minCoeff() < 0 || comp.minCoeff() < 0 || comp.maxCoeff() >= B)))
+        {
+            this->clear();
+            return false;
+        }
+        if (!this->_assign(matrix,node,comp))
+            return false;
+        m_layout = 0;
+        return true;
+    }
+
+    /**
+     * @brief      Overwrites the coefficients with the ones of \a matrix, keeping the block pattern
+     *
+     * @param[in]  matrix  The matrix, with the block pattern of the stored matrix or a subset of it
+     *
+     * @return     False if \a matrix does not fit in the block pattern; the coefficients are then invalid and \ref assign should be called
+     */
+    bool setValues(const gsSparseMatrix<T> & matrix)
+    {
+        if (matrix.rows()!=this->rows() || matrix.cols()!=this->cols())
+            return false;
+        std::fill(m_values.begin(),m_values.end(),0);
+        return this->_scatter(matrix);
+    }
+
+    /// Makes the matrix empty
+    void clear()
+    {
+        m_rows = m_nodes = m_layout = 0;
+        m_node.clear();
+        m_comp.clear();
+        m_dof.clear();
+        m_rowPtr.clear();
+        m_colIdx.clear();
+        m_values.clear();
+    }
+
+    /// Returns the number of rows
+    index_t rows() const { return m_rows; }
+
+    /// Returns the number of columns
+    index_t cols() const { return m_rows; }
+
+    /// Returns the number of nodes, i.e. the number of block rows
+    index_t nodes() const { return m_nodes; }
+
+    /// Returns the number of stored blocks
+    index_t nonZeroBlocks() const { return m_colIdx.size(); }
+
+    /// Returns the ordering of the degrees of freedom: 1: per component; 2: per node; 0: given by the node and component maps
+    index_t layout() const { return m_layout; }
+
+    /// Returns whether the degrees of freedom are ordered per node
+    bool interleaved() const { return m_layout==2; }
+
+    /// Computes \a result = A \a x, where \a x can have multiple columns. The block rows are divided over \a numThreads threads
+    template<class Derived>
+    void multiply(const gsEigen::MatrixBase<Derived> & x, gsMatrix<T> & result, index_t numThreads = 1) const
+    {
+        GISMO_ASSERT(x.rows()==this->cols(),"The vector has "<<x.rows()<<" rows, but the matrix has "<<this->cols()<<" columns");
+        GISMO_UNUSED(numThreads);
+        result.resize(this->rows(),x.cols());
+        for (index_t c = 0; c!=x.cols(); c++)
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (index_t I = 0; I < m_nodes; I++)
+            {
+                BlockVector xb, yb;
+                yb.setZero();
+                for (index_t k = m_rowPtr[I]; k!=m_rowPtr[I+1]; k++)
+                {
+                    for (index_t d = 0; d!=B; d++)
+                        xb[d] = _dof(m_colIdx[k],d) < 0 ? T(0) : x(_dof(m_colIdx[k],d),c);
+                    yb.noalias() += gsEigen::Map<const Block>(&m_values[B*B*k]) * xb;
+                }
+                for (index_t d = 0; d!=B; d++)
+                    if (_dof(I,d) >= 0)
+                        result(_dof(I,d),c) = yb[d];
+            }
+    }
+
+    /// Returns the product with \a x
+    template<class Derived>
+    gsMatrix<T> operator*(const gsEigen::MatrixBase<Derived> & x) const
+    {
+        gsMatrix<T> result;
+        this->multiply(x,result);
+        return result;
+    }
+
+    /// Returns the matrix in the scalar sparse format
+    gsSparseMatrix<T> toSparse() const
+    {
+        gsSparseMatrix<T> result(this->rows(),this->cols());
+        result.reserve(gsVector<index_t>::Constant(this->cols(),B*(m_nodes==0 ? 0 : (m_colIdx.size() / m_nodes + 1))));
+        for (index_t I = 0; I!=m_nodes; I++)
+            for (index_t k = m_rowPtr[I]; k!=m_rowPtr[I+1]; k++)
+                for (index_t di = 0; di!=B; di++)
+                    for (index_t dj = 0; dj!=B; dj++)
+                        if (m_values[B*B*k + B*di + dj]!=0)
+                            result.insert(_dof(I,di),_dof(m_colIdx[k],dj)) = m_values[B*B*k + B*di + dj];
+        result.makeCompressed();
+        return result;
+    }
+
+protected:
+
+    /// Returns the node of degree of freedom \a i
+    index_t _node(index_t i) const { return m_node[i]; }
+
+    /// Returns the component of degree of freedom \a i
+    index_t _comp(index_t i) const { return m_comp[i]; }
+
+    /// Returns the degree of freedom of component \a d of node \a I, or -1 if the node has no such component
+    index_t _dof(index_t I, index_t d) const { return m_dof[B*I + d]; }
+
+    /// Makes the maps, the block pattern and the coefficients, returns false if a pair of node and component appears twice
+    bool _assign(const gsSparseMatrix<T> & matrix, const gsVector<index_t> & node, const gsVector<index_t> & comp)
+    {
+        m_rows = matrix.rows();
+        m_nodes = m_rows==0 ? 0 : node.maxCoeff() + 1;
+        m_node.assign(node.data(),node.data() + m_rows);
+        m_comp.assign(comp.data(),comp.data() + m_rows);
+        m_dof.assign(B*m_nodes,-1);
+        for (index_t i = 0; i!=m_rows; i++)
+        {
+            if (m_dof[B*node[i] + comp[i]]!=-1)
+            {
+                this->clear();
+                return false;
+            }
+            m_dof[B*node[i] + comp[i]] = i;
+        }
+
+        // Block columns per block row
+        std::vector<std::vector<index_t> > blockCols(m_nodes);
+        for (index_t j = 0; j!=matrix.outerSize(); j++)
+            for (typename gsSparseMatrix<T>::InnerIterator it(matrix,j); it; ++it)
+                blockCols[_node(it.row())].push_back(_node(it.col()));
+
+        m_rowPtr.resize(m_nodes+1);
+        m_rowPtr[0] = 0;
+        for (index_t I = 0; I!=m_nodes; I++)
+        {
+            std::sort(blockCols[I].begin(),blockCols[I].end());
+            blockCols[I].erase(std::unique(blockCols[I].begin(),blockCols[I].end()),blockCols[I].end());
+            m_rowPtr[I+1] = m_rowPtr[I] + blockCols[I].size();
+        }
+        m_colIdx.resize(m_rowPtr[m_nodes]);
+        for (index_t I = 0; I!=m_nodes; I++)
+            std::copy(blockCols[I].begin(),blockCols[I].end(),m_colIdx.begin() + m_rowPtr[I]);
+
+        m_values.assign(B*B*m_colIdx.size(),0);
+        this->_scatter(matrix);
+        return true;
+    }
+
+    /// Writes the coefficients of \a matrix in the blocks, returns false if a block is not in the pattern
+    bool _scatter(const gsSparseMatrix<T> & matrix)
+    {
+        typename std::vector<index_t>::const_iterator first, last, pos;
+        for (index_t j = 0; j!=matrix.outerSize(); j++)
+            for (typename gsSparseMatrix<T>::InnerIterator it(matrix,j); it; ++it)
+            {
+                const index_t I = _node(it.row()), J = _node(it.col());
+                first = m_colIdx.begin() + m_rowPtr[I];
+                last  = m_colIdx.begin() + m_rowPtr[I+1];
+                pos = std::lower_bound(first,last,J);
+                if (pos==last || *pos!=J)
+                    return false;
+                m_values[B*B*(pos - m_colIdx.begin()) + B*_comp(it.row()) + _comp(it.col())] = it.value();
+            }
+        return true;
+    }
+
+protected:
+    index_t m_rows, m_nodes;
+    /// Ordering of the degrees of freedom, see \ref layout
+    index_t m_layout;
+
+    /// Node and component per degree of freedom, and the degree of freedom per node and component (-1 if absent)
+    std::vector<index_t> m_node, m_comp, m_dof;
+
+    /// Block row pointers, block column indices and the row-major blocks
+    std::vector<index_t> m_rowPtr, m_colIdx;
+    std::vector<T> m_values;
+};
+
+} // namespace gismo
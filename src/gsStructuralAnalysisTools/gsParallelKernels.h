@@ -0,0 +1,252 @@
+ /** @file gsParallelKernels.h
+
+    @brief Multithreaded matrix-vector products and vector kernels with deterministic reductions
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsParallel/gsOpenMP.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsBlockSparseMatrix.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Multithreaded (OpenMP) kernels for the explicit and Krylov solvers
+
+    The kernels split the index range [0,n) into chunks of \ref ChunkSize
+    entries. The chunks are processed in parallel, and reductions (dot
+    products, norms) are computed per chunk and summed afterwards pairwise,
+    in a tree over the chunks. Since the chunks and the tree do not depend
+    on the number of threads, the results are bitwise identical for any
+    number of threads, including a single thread. The solvers compute all
+    their norms and dot products with these reductions, such that iteration
+    counts and solution paths do not depend on the number of threads.
+    The reductions are accumulated in \ref gsStructuralAnalysisAccumulator,
+    i.e. in double precision for single-precision vectors.
+
+    The sparse matrix-vector product is computed on a row-major copy of the
+    matrix (see \ref toRowMajor), such that every thread computes its own
+    rows. For symmetric matrices, the column-major gsSparseMatrix is already
+    the row-major storage of the same matrix, and no copy is needed (see
+    \ref rowMajorView).
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsParallelKernels
+{
+public:
+
+    typedef typename gsSparseMatrix<T>::StorageIndex StorageIndex;
+    typedef gsEigen::SparseMatrix<T,gsEigen::RowMajor,StorageIndex> RowMatrix;
+    typedef gsEigen::Map<const RowMatrix> RowMatrixMap;
+    typedef typename gsStructuralAnalysisAccumulator<T>::type Accumulator;
+
+    /// Number of entries per chunk
+    enum { ChunkSize = 4096 };
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  numThreads  The number of threads. If <1, the maximum number of threads is used
+     */
+    gsParallelKernels(index_t numThreads = 1)
+    {
+        this->setNumThreads(numThreads);
+    }
+
+    /// Sets the number of threads. If <1, the maximum number of threads is used
+    void setNumThreads(index_t numThreads)
+    {
+        m_numThreads = numThreads < 1 ? omp_get_max_threads() : numThreads;
+    }
+
+    /// Returns the number of threads
+    index_t numThreads() const { return m_numThreads; }
+
+    /// Stores \a matrix in row-major format in \a result
+    static void toRowMajor(const gsSparseMatrix<T> & matrix, RowMatrix & result)
+    {
+        result = matrix;
+        result.makeCompressed();
+    }
+
+    /// Returns the row-major view of the compressed symmetric \a matrix, i.e. of its transpose
+    static RowMatrixMap rowMajorView(const gsSparseMatrix<T> & matrix)
+    {
+        GISMO_ASSERT(matrix.isCompressed(),"The matrix should be compressed");
+        return RowMatrixMap(matrix.cols(),matrix.rows(),matrix.nonZeros(),
+                            matrix.outerIndexPtr(),matrix.innerIndexPtr(),matrix.valuePtr());
+    }
+
+    /**
+     * @brief      Applies \a fun on all chunks of [0,n) in parallel
+     *
+     * @param[in]  n     The number of entries
+     * @param[in]  fun   The function, called as fun(begin,size)
+     */
+    template<class Fun>
+    void forEach(index_t n, const Fun & fun) const
+    {
+        const index_t numChunks = (n + ChunkSize - 1) / ChunkSize;
+        if (m_numThreads==1 || numChunks<=1)
+        {
+            for (index_t c = 0; c < numChunks; c++)
+                fun(c*ChunkSize, std::min<index_t>(ChunkSize, n - c*ChunkSize));
+            return;
+        }
+#pragma omp parallel for num_threads(m_numThreads) schedule(static)
+        for (index_t c = 0; c < numChunks; c++)
+            fun(c*ChunkSize, std::min<index_t>(ChunkSize, n - c*ChunkSize));
+    }
+
+    /**
+     * @brief      Sums \a fun over all chunks of [0,n). The chunks are evaluated in parallel and summed pairwise
+     *
+     * @param[in]  n     The number of entries
+     * @param[in]  fun   The function, called as fun(begin,size)
+     * @param[in]  zero  The zero of the result type
+     *
+     * @return     The sum
+     */
+    template<class Result, class Fun>
+    Result reduce(index_t n, const Fun & fun, const Result & zero) const
+    {
+        const index_t numChunks = (n + ChunkSize - 1) / ChunkSize;
+        if (numChunks==0)
+            return zero;
+        // Serial, without the partial sums and the parallel region, in the same tree
+        if (m_numThreads==1 || numChunks==1)
+            return this->template _reduce<Result>(n,0,numChunks,fun);
+
+        std::vector<Result> partial(numChunks,zero);
+#pragma omp parallel for num_threads(m_numThreads) schedule(static)
+        for (index_t c = 0; c < numChunks; c++)
+            partial[c] = fun(c*ChunkSize, std::min<index_t>(ChunkSize, n - c*ChunkSize));
+
+        // Pairwise summation, in a tree that only depends on the number of chunks
+        for (index_t width = 1; width < numChunks; width *= 2)
+            for (index_t c = 0; c + width < numChunks; c += 2*width)
+                partial[c] += partial[c + width];
+        return partial[0];
+    }
+
+    /// Returns the dot product of \a x and \a y
+    template<class DerivedX, class DerivedY>
+    T dot(const gsEigen::MatrixBase<DerivedX> & x, const gsEigen::MatrixBase<DerivedY> & y) const
+    {
+        GISMO_ASSERT(x.size()==y.size(),"The vectors have different sizes");
+        GISMO_ASSERT(x.cols()==1 && y.cols()==1,"The arguments should be column vectors");
+        return static_cast<T>(this->reduce(x.size(),[&](index_t b, index_t s) -> Accumulator
+        {
+            return x.col(0).segment(b,s).template cast<Accumulator>().dot(y.col(0).segment(b,s).template cast<Accumulator>());
+        },Accumulator(0)));
+    }
+
+    /// Returns the squared Euclidean norm of \a x
+    template<class Derived>
+    T squaredNorm(const gsEigen::MatrixBase<Derived> & x) const
+    {
+        return static_cast<T>(this->_squaredNorm(x));
+    }
+
+    /// Returns the Euclidean norm of \a x. The square root is taken in the precision of the accumulation
+    template<class Derived>
+    T norm(const gsEigen::MatrixBase<Derived> & x) const
+    {
+        return static_cast<T>(math::sqrt(this->_squaredNorm(x)));
+    }
+
+    /// Computes \a y += \a a * \a x
+    template<class Derived>
+    void axpy(const T a, const gsEigen::MatrixBase<Derived> & x, gsVector<T> & y) const
+    {
+        GISMO_ASSERT(x.size()==y.size(),"The vectors have different sizes");
+        this->forEach(y.size(),[&](index_t b, index_t s) { y.segment(b,s).noalias() += a * x.segment(b,s); });
+    }
+
+    /// Computes \a y += \a a * \a x and returns the dot product of the updated \a y with \a w
+    template<class DerivedX, class DerivedW>
+    T axpyDot(const T a, const gsEigen::MatrixBase<DerivedX> & x, gsVector<T> & y, const gsEigen::MatrixBase<DerivedW> & w) const
+    {
+        GISMO_ASSERT(x.size()==y.size() && w.size()==y.size(),"The vectors have different sizes");
+        return static_cast<T>(this->reduce(y.size(),[&](index_t b, index_t s) -> Accumulator
+        {
+            y.segment(b,s).noalias() += a * x.segment(b,s);
+            return y.segment(b,s).template cast<Accumulator>().dot(w.segment(b,s).template cast<Accumulator>());
+        },Accumulator(0)));
+    }
+
+    /// Computes \a result = \a A \a x for a row-major matrix \a A
+    template<class Matrix, class Derived>
+    void multiply(const Matrix & A, const gsEigen::MatrixBase<Derived> & x, gsMatrix<T> & result) const
+    {
+        GISMO_ASSERT(A.cols()==x.rows(),"The vector has "<<x.rows()<<" rows, but the matrix has "<<A.cols()<<" columns");
+        result.resize(A.rows(),x.cols());
+        for (index_t c = 0; c!=x.cols(); c++)
+            this->forEach(A.rows(),[&](index_t b, index_t s)
+            {
+                T sum;
+                for (index_t i = b; i!=b+s; i++)
+                {
+                    sum = 0;
+                    for (typename Matrix::InnerIterator it(A,i); it; ++it)
+                        sum += it.value() * x(it.col(),c);
+                    result(i,c) = sum;
+                }
+            });
+    }
+
+    /// Computes \a result = \a A \a x for a matrix in the block format
+    template<class Derived>
+    void multiply(const gsBlockSparseMatrix<T> & A, const gsEigen::MatrixBase<Derived> & x, gsMatrix<T> & result) const
+    {
+        A.multiply(x,result,m_numThreads);
+    }
+
+protected:
+
+    /// Sums \a fun over \a count chunks from chunk \a first serially, in the tree of \ref reduce
+    template<class Result, class Fun>
+    Result _reduce(index_t n, index_t first, index_t count, const Fun & fun) const
+    {
+        if (count==1)
+            return fun(first*ChunkSize, std::min<index_t>(ChunkSize, n - first*ChunkSize));
+        // The tree of reduce sums the largest power of two of chunks before the rest
+        index_t width = 1;
+        while (2*width < count)
+            width *= 2;
+        Result sum = this->template _reduce<Result>(n,first,width,fun);
+        sum += this->template _reduce<Result>(n,first+width,count-width,fun);
+        return sum;
+    }
+
+    /// Returns the squared Euclidean norm of \a x in the accumulation type
+    template<class Derived>
+    Accumulator _squaredNorm(const gsEigen::MatrixBase<Derived> & x) const
+    {
+        GISMO_ASSERT(x.cols()==1,"The argument should be a column vector");
+        return this->reduce(x.size(),[&](index_t b, index_t s) -> Accumulator
+        {
+            return x.col(0).segment(b,s).template cast<Accumulator>().squaredNorm();
+        },Accumulator(0));
+    }
+
+protected:
+    index_t m_numThreads;
+};
+
+} // namespace gismo
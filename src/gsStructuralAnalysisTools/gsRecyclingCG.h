@@ -0,0 +1,483 @@
+ /** @file gsRecyclingCG.h
+
+    @brief Deflated conjugate gradient solver that recycles a Ritz subspace over subsequent solves
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsParallelKernels.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Deflated conjugate gradient solver with subspace recycling
+
+    The solver is a Jacobi-preconditioned conjugate gradient method, deflated
+    with a subspace W (Saad et al., 2000). The initial guess and the search
+    directions are projected such that the residuals are orthogonal to W,
+    hence the eigenvalues of the operator associated with W do not slow down
+    the convergence.
+
+    After every solve, the subspace W is updated with the Ritz vectors of the
+    matrix on span([W, P]), where P contains the first search directions of
+    the solve. The Ritz vectors belonging to the Ritz values with the smallest
+    magnitude are kept. The subspace is kept over subsequent calls of
+    \ref compute, such that it is carried over the iterations and steps of a
+    nonlinear solver, where the matrices vary slowly.
+
+    The interface follows the one of the sparse solvers, i.e. \ref compute
+    followed by \ref solve and \ref info. The matrix should be symmetric
+    positive definite: \ref compute reports InvalidInput for a nonsymmetric
+    matrix or a matrix with a non-positive diagonal entry, and \ref solve
+    reports NumericalIssue when a search direction of non-positive curvature
+    is found, i.e. when the matrix is indefinite.
+
+    The products with the matrix can be computed in the node-blocked format
+    of \ref gsBlockSparseMatrix, see \ref setBlockLayout and \ref
+    setBlockMap. A matrix that does not fit in blocks is multiplied in the
+    scalar format. With \ref setNumThreads, the products and the vector updates are computed with the
+    multithreaded kernels of \ref gsParallelKernels, of which the results
+    do not depend on the number of threads.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsRecyclingCG
+{
+    typedef typename gsMatrix<T>::Base DenseMatrix;
+
+public:
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  numRecycle  The number of recycled vectors
+     */
+    gsRecyclingCG(index_t numRecycle = 5)
+    :
+    m_numRecycle(numRecycle),
+    m_tol(std::numeric_limits<T>::epsilon()),
+    m_maxIter(-1),
+    m_blockLayout(0),
+    m_blocked(false),
+    m_blockWarned(false),
+    m_numThreads(0),
+    m_numFixed(0),
+    m_iterations(0),
+    m_error(0),
+    m_info(gsEigen::ComputationInfo::Success)
+    { }
+
+    /// Sets the number of recycled vectors. Resets the recycled subspace when it changes
+    void setRecycleSize(index_t numRecycle)
+    {
+        if (numRecycle!=m_numRecycle)
+            this->reset();
+        m_numRecycle = numRecycle;
+    }
+
+    /// Sets the relative tolerance on the residual
+    void setTolerance(T tol) { m_tol = tol; }
+
+    /// Sets the maximum number of iterations. If negative, twice the size of the system is used
+    void setMaxIterations(index_t maxIter) { m_maxIter = maxIter; }
+
+    /**
+     * @brief      Sets the format of the products with the matrix. Applies from the next call of \ref compute
+     *
+     * @param[in]  layout  0: scalar sparse format; 1: 3x3 blocks, with the degrees of freedom ordered per component; 2: 3x3 blocks, with the degrees of freedom ordered per node
+     */
+    void setBlockLayout(index_t layout)
+    {
+        m_blockLayout = layout;
+        m_Ablock.clear();
+        m_blockWarned = false;
+    }
+
+    /**
+     * @brief      Sets the node and the component of every degree of freedom for the products in the block format,
+     *             e.g. from the gsDofMapper of the unknowns. Overrides \ref setBlockLayout from the next call of \ref compute
+     *
+     * @param[in]  node  The node of every degree of freedom. An empty vector removes the maps
+     * @param[in]  comp  The component of every degree of freedom
+     */
+    void setBlockMap(const gsVector<index_t> & node, const gsVector<index_t> & comp)
+    {
+        m_blockNode = node;
+        m_blockComp = comp;
+        m_Ablock.clear();
+        m_blockWarned = false;
+    }
+
+    /// Sets the number of threads of the kernels (see \ref gsParallelKernels). If 0, the serial kernels of Eigen are used; if <0, the maximum number of threads is used. The products with the matrix apply it from the next call of \ref compute
+    void setNumThreads(index_t numThreads)
+    {
+        m_numThreads = numThreads;
+        if (m_numThreads!=0)
+            m_kernels.setNumThreads(m_numThreads);
+    }
+
+    /// Removes the recycled subspace. The deflation vectors are kept
+    void reset()
+    {
+        m_W = m_W.leftCols(m_numFixed).eval();
+        m_AW.resize(0,0);
+    }
+
+    /// Sets the recycled subspace, the columns of \a W should be linearly independent
+    void setRecycledSpace(const gsMatrix<T> & W)
+    {
+        gsMatrix<T> Z(W.rows(), m_numFixed + W.cols());
+        Z << m_W.leftCols(m_numFixed), W;
+        orthonormalize(Z,m_numFixed);
+        m_W = Z.leftCols(std::min<index_t>(Z.cols(),m_numFixed + m_numRecycle));
+        if (m_A.rows()==m_W.rows())
+            this->_setupCoarse();
+    }
+
+    /**
+     * @brief      Sets vectors that are always contained in the deflation space,
+     *             next to the recycled subspace. For example (near) null vectors of the matrix
+     *
+     * @param[in]  D     The deflation vectors, stored column-wise. An empty matrix removes them
+     */
+    void setDeflationVectors(const gsMatrix<T> & D)
+    {
+        const index_t numRecycled = m_W.cols() - m_numFixed;
+        gsMatrix<T> Z(D.rows(), D.cols() + numRecycled);
+        if (m_W.rows()==D.rows())
+            Z << D, m_W.rightCols(numRecycled);
+        else
+            Z = D;
+        m_numFixed = orthonormalize(Z,D.cols());
+        m_W = Z;
+        if (m_A.rows()==m_W.rows())
+            this->_setupCoarse();
+    }
+
+    /// Returns the deflation space, i.e. the deflation vectors followed by the recycled subspace
+    const gsMatrix<T> & recycledSpace() const { return m_W; }
+
+    /// Sets the matrix of the system. The status is InvalidInput if the matrix is not symmetric or has a non-positive diagonal entry
+    gsRecyclingCG & compute(const gsSparseMatrix<T> & A)
+    {
+        m_A = A;
+        m_A.makeCompressed();
+        const bool spd = this->_symmetric() && (m_A.diagonal().array() > 0).all();
+        m_blocked = spd && this->_assignBlocks();
+        // The row-major copy is only used by the multithreaded scalar products
+        if (!spd || m_blocked || m_numThreads==0)
+        {
+            m_Arow.resize(0,0);
+            m_Arow.data().squeeze();
+        }
+        if (!spd)
+        {
+            m_info = gsEigen::ComputationInfo::InvalidInput;
+            return *this;
+        }
+        m_invDiag = m_A.diagonal();
+        for (index_t i = 0; i!=m_invDiag.rows(); i++)
+            m_invDiag[i] = (m_invDiag[i]!=0) ? 1 / m_invDiag[i] : (T)(1);
+
+        if (m_W.rows()!=m_A.rows())
+        {
+            m_W.resize(m_A.rows(),0);
+            m_numFixed = 0;
+        }
+        this->_setupCoarse();
+
+        m_info = gsEigen::ComputationInfo::Success;
+        return *this;
+    }
+
+    /// Solves the system with right-hand side \a b and updates the recycled subspace
+    gsVector<T> solve(const gsVector<T> & b)
+    {
+        const index_t n = m_A.rows();
+        const index_t maxIter = m_maxIter > 0 ? m_maxIter : 2*n;
+
+        gsVector<T> x(n), r, z, p;
+        gsMatrix<T> Ap(n,1);
+        gsMatrix<T> P(n,m_numRecycle);
+        index_t numP = 0;
+
+        m_iterations = 0;
+        m_error = 0;
+        m_info = gsEigen::ComputationInfo::Success;
+
+        const T bnorm = math::sqrt(this->_dot(b,b));
+        if (bnorm==0)
+        {
+            x.setZero();
+            return x;
+        }
+
+        // Initial guess in the recycled space, such that W^T r = 0
+        if (m_W.cols()!=0)
+            x = m_W * m_Efact.solve(m_W.transpose() * b);
+        else
+            x.setZero();
+        this->_product(x,Ap);
+        r = b - Ap;
+        z = m_invDiag.cwiseProduct(r);
+        p = z;
+        this->_project(p,z);
+
+        T rz = this->_dot(r,z), rzOld, rr = this->_dot(r,r), pAp, alpha, beta;
+        m_error = math::sqrt(rr) / bnorm;
+        while (m_error > m_tol && m_iterations < maxIter)
+        {
+            this->_product(p,Ap);
+            pAp = this->_dot(p,Ap);
+            // The matrix is not positive definite
+            if (pAp <= 0)
+            {
+                m_info = gsEigen::ComputationInfo::NumericalIssue;
+                break;
+            }
+
+            // Store the A-normalized search directions for the subspace update
+            if (numP < m_numRecycle)
+                P.col(numP++) = p / math::sqrt(math::abs(pAp));
+
+            alpha = rz / pAp;
+            rzOld = rz;
+            if (m_numThreads!=0)
+            {
+                // Fused update of the solution, the residual and the preconditioned residual
+                typedef typename gsParallelKernels<T>::Accumulator Accumulator;
+                typedef gsEigen::Matrix<Accumulator,2,1> Sums;
+                const Sums sums = m_kernels.reduce(n,[&](index_t first, index_t s) -> Sums
+                {
+                    x.segment(first,s).noalias() += alpha * p.segment(first,s);
+                    r.segment(first,s).noalias() -= alpha * Ap.col(0).segment(first,s);
+                    z.segment(first,s) = m_invDiag.segment(first,s).cwiseProduct(r.segment(first,s));
+                    return Sums(r.segment(first,s).template cast<Accumulator>().dot(z.segment(first,s).template cast<Accumulator>()),
+                                r.segment(first,s).template cast<Accumulator>().squaredNorm());
+                },Sums(Sums::Zero()));
+                rz = static_cast<T>(sums[0]);
+                rr = static_cast<T>(sums[1]);
+                beta = rz / rzOld;
+                m_kernels.forEach(n,[&](index_t first, index_t s) { p.segment(first,s) = beta * p.segment(first,s) + z.segment(first,s); });
+            }
+            else
+            {
+                x.noalias() += alpha * p;
+                r.noalias() -= alpha * Ap;
+                z = m_invDiag.cwiseProduct(r);
+                rz = r.dot(z);
+                rr = r.squaredNorm();
+                p = (rz / rzOld) * p + z;
+            }
+            this->_project(p,z);
+
+            m_error = math::sqrt(rr) / bnorm;
+            m_iterations++;
+        }
+
+        if (m_info==gsEigen::ComputationInfo::Success && m_error > m_tol)
+            m_info = gsEigen::ComputationInfo::NoConvergence;
+
+        this->_harvest(P.leftCols(numP));
+        return x;
+    }
+
+    /**
+     * @brief      Orthonormalizes the columns of \a Z using modified Gram-Schmidt, dropping linearly dependent columns
+     *
+     * @param      Z      The vectors, resized to the remaining columns
+     * @param[in]  first  The number of leading columns of interest
+     *
+     * @return     The number of remaining columns among the first \a first columns
+     */
+    static index_t orthonormalize(gsMatrix<T> & Z, index_t first)
+    {
+        index_t q = 0, qFirst = 0;
+        gsVector<T> v;
+        T nrm;
+        for (index_t j = 0; j!=Z.cols(); j++)
+        {
+            v = Z.col(j);
+            nrm = v.norm();
+            for (index_t i = 0; i!=q; i++)
+                v -= Z.col(i).dot(v) * Z.col(i);
+            if (nrm==0 || v.norm() <= math::sqrt(std::numeric_limits<T>::epsilon()) * nrm)
+                continue;
+            Z.col(q++) = v / v.norm();
+            if (j < first) qFirst++;
+        }
+        Z.conservativeResize(gsEigen::NoChange,q);
+        return qFirst;
+    }
+
+    /// Returns the matrix of the system
+    const gsSparseMatrix<T> & matrix() const { return m_A; }
+
+    /// Returns the status of the last call to \ref compute or \ref solve
+    gsEigen::ComputationInfo info() const { return m_info; }
+
+    /// Returns the number of iterations of the last solve
+    index_t iterations() const { return m_iterations; }
+
+    /// Returns the relative residual of the last solve
+    T error() const { return m_error; }
+
+protected:
+
+    /// Computes the product of the matrix with \a x in \a result, without reallocating \a result if it has the right size
+    template<class Derived>
+    void _product(const gsEigen::MatrixBase<Derived> & x, gsMatrix<T> & result) const
+    {
+        if (m_blocked)
+            m_Ablock.multiply(x,result,m_numThreads!=0 ? m_kernels.numThreads() : 1);
+        else if (m_numThreads!=0 && m_Arow.rows()==m_A.rows())
+            m_kernels.multiply(m_Arow,x,result);
+        else
+            result.noalias() = m_A * x;
+    }
+
+    /// Makes the matrix in the block format, if set. Returns false if the products use the scalar format
+    bool _assignBlocks()
+    {
+        if (m_blockNode.rows()==0 && m_blockLayout==0)
+            return false;
+        const index_t layout = m_blockNode.rows()!=0 ? 0 : m_blockLayout;
+        if (m_Ablock.layout()==layout && m_Ablock.setValues(m_A))
+            return true;
+        if (layout==0 ? m_Ablock.assign(m_A,m_blockNode,m_blockComp) : m_Ablock.assign(m_A,layout==2))
+            return true;
+        if (!m_blockWarned)
+            gsWarn<<"The matrix of size "<<m_A.rows()<<" does not fit in "<<gsBlockSparseMatrix<T>::BlockSize<<"x"<<gsBlockSparseMatrix<T>::BlockSize
+                  <<" blocks with the given layout or maps. The products are computed in the scalar format.\n";
+        m_blockWarned = true;
+        return false;
+    }
+
+    /// Returns whether the compressed matrix is symmetric, up to a relative tolerance on the coefficients. Stores the row-major copy of the matrix
+    bool _symmetric()
+    {
+        // The row-major storage of a symmetric matrix is equal to its column-major storage
+        gsParallelKernels<T>::toRowMajor(m_A,m_Arow);
+        const index_t nnz = m_A.nonZeros();
+        if (m_A.rows()!=m_A.cols() || m_Arow.nonZeros()!=nnz
+            || !std::equal(m_A.outerIndexPtr(),m_A.outerIndexPtr() + m_A.outerSize() + 1,m_Arow.outerIndexPtr())
+            || !std::equal(m_A.innerIndexPtr(),m_A.innerIndexPtr() + nnz,m_Arow.innerIndexPtr()))
+            return false;
+        if (nnz==0)
+            return true;
+        const T tol = math::sqrt(std::numeric_limits<T>::epsilon()) * m_A.coeffs().cwiseAbs().maxCoeff();
+        for (index_t k = 0; k!=nnz; k++)
+            if (math::abs(m_A.valuePtr()[k] - m_Arow.valuePtr()[k]) > tol)
+                return false;
+        return true;
+    }
+
+    /// Returns the dot product of the vectors \a x and \a y
+    template<class DerivedX, class DerivedY>
+    T _dot(const gsEigen::MatrixBase<DerivedX> & x, const gsEigen::MatrixBase<DerivedY> & y) const
+    {
+        return m_numThreads!=0 ? m_kernels.dot(x,y) : x.col(0).dot(y.col(0));
+    }
+
+    /// Computes A W and factorizes the coarse matrix E = W^T A W
+    void _setupCoarse()
+    {
+        if (m_W.cols()==0)
+            return;
+        this->_product(m_W,m_AW);
+        DenseMatrix E = m_W.transpose() * m_AW;
+        m_Efact.compute(E);
+    }
+
+    /// Makes the search direction \a p A-orthogonal to W, given the preconditioned residual \a z
+    void _project(gsVector<T> & p, const gsVector<T> & z) const
+    {
+        if (m_W.cols()!=0)
+            p.noalias() -= m_W * m_Efact.solve(m_AW.transpose() * z);
+    }
+
+    /// Updates the recycled subspace with the Ritz vectors on span([W, P]), orthogonal to the deflation vectors
+    void _harvest(const gsMatrix<T> & P)
+    {
+        if (m_numRecycle==0 || P.cols()==0)
+            return;
+
+        gsMatrix<T> Z(P.rows(), m_W.cols() + P.cols());
+        if (m_W.cols()!=0)
+            Z << m_W, P;
+        else
+            Z = P;
+
+        // The deflation vectors are already orthonormal and come first, hence they are kept
+        orthonormalize(Z,m_numFixed);
+        const index_t q = Z.cols() - m_numFixed;
+        if (q==0)
+            return;
+
+        const gsMatrix<T> Zr = Z.rightCols(q);
+        gsMatrix<T> AZr;
+        this->_product(Zr,AZr);
+        DenseMatrix H = Zr.transpose() * AZr;
+        gsEigen::SelfAdjointEigenSolver<DenseMatrix> es(H);
+
+        // Keep the Ritz vectors with the smallest Ritz values in magnitude
+        std::vector<index_t> order(q);
+        for (index_t i = 0; i!=q; i++) order[i] = i;
+        std::sort(order.begin(),order.end(),
+                  [&es](index_t a, index_t b) { return math::abs(es.eigenvalues()[a]) < math::abs(es.eigenvalues()[b]); });
+
+        const index_t k = std::min(m_numRecycle,q);
+        m_W.resize(Z.rows(),m_numFixed + k);
+        m_W.leftCols(m_numFixed) = Z.leftCols(m_numFixed);
+        for (index_t i = 0; i!=k; i++)
+            m_W.col(m_numFixed + i) = Zr * es.eigenvectors().col(order[i]);
+
+        this->_setupCoarse();
+    }
+
+protected:
+    index_t m_numRecycle;
+    T m_tol;
+    index_t m_maxIter;
+
+    gsSparseMatrix<T> m_A;
+    gsVector<T> m_invDiag;
+    /// Row-major copy of the matrix for the multithreaded products
+    typename gsParallelKernels<T>::RowMatrix m_Arow;
+
+    /// Format of the products with the matrix (see \ref setBlockLayout), the maps of \ref setBlockMap, and the matrix in the block format
+    index_t m_blockLayout;
+    gsVector<index_t> m_blockNode, m_blockComp;
+    gsBlockSparseMatrix<T> m_Ablock;
+    /// Whether the products use the block format, and whether it was reported that the matrix does not fit in blocks
+    bool m_blocked, m_blockWarned;
+
+    /// Number of threads of the kernels, 0 for the serial kernels of Eigen
+    index_t m_numThreads;
+    gsParallelKernels<T> m_kernels;
+
+    /// Deflation space (deflation vectors followed by the recycled subspace), its product with the matrix, and the factorization of W^T A W
+    gsMatrix<T> m_W, m_AW;
+    /// Number of deflation vectors in m_W
+    index_t m_numFixed;
+    gsEigen::LDLT<DenseMatrix> m_Efact;
+
+    index_t m_iterations;
+    T m_error;
+    gsEigen::ComputationInfo m_info;
+};
+
+} // namespace gismo
@@ -0,0 +1,169 @@
+ /** @file gsSparsityPattern.h
+
+    @brief Keeps the sparsity pattern of a factorized matrix to reuse its symbolic factorization
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsCore/gsLinearAlgebra.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Sparsity pattern of the last matrix analyzed by a sparse solver
+
+    In a Newton iteration, the Jacobians of subsequent iterations have the
+    same sparsity pattern. When the pattern is stable, the symbolic
+    factorization (ordering and elimination tree) of the first Jacobian can
+    be reused, and only the numerical factorization has to be computed.
+
+    \ref factorize compares the pattern of a compressed matrix with the
+    pattern of the matrix that was last analyzed by the same solver. If they
+    are equal, only the numerical factorization is computed; otherwise the
+    solver computes the full factorization and the pattern is stored. The
+    numerical factorization is available for the SimplicialLDLT,
+    SimplicialLLT and SparseLU solvers; other solvers always compute the full
+    factorization.
+
+    \ref overwriteValues can be used in the Jacobian operators, such that the
+    matrix that is passed to the operator keeps its memory.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsSparsityPattern
+{
+    typedef typename gsSparseMatrix<T>::StorageIndex StorageIndex;
+
+public:
+
+    gsSparsityPattern()
+    :
+    m_solver(nullptr),
+    m_rows(0),
+    m_symbolic(0),
+    m_numeric(0)
+    { }
+
+    /// Removes the stored pattern, such that the next factorization is a full one
+    void clear()
+    {
+        m_solver = nullptr;
+        m_outer.clear();
+        m_inner.clear();
+    }
+
+    /// Returns true if \a matrix is compressed and has the stored pattern
+    bool matches(const gsSparseMatrix<T> & matrix) const
+    {
+        return matrix.isCompressed() && m_outer.size()!=0 && samePattern(matrix, m_rows, m_outer, m_inner);
+    }
+
+    /**
+     * @brief      Factorizes \a matrix with \a solver, reusing the symbolic factorization if the pattern did not change
+     *
+     * @param      solver  The solver
+     * @param[in]  matrix  The matrix
+     *
+     * @return     True if only the numerical factorization was computed
+     */
+    bool factorize(gsSparseSolver<T> & solver, const gsSparseMatrix<T> & matrix)
+    {
+        if (m_solver==&solver && this->matches(matrix) && _numericFactorization(solver,matrix))
+        {
+            m_numeric++;
+            return true;
+        }
+
+        solver.compute(matrix);
+        m_symbolic++;
+        if (matrix.isCompressed())
+        {
+            m_solver = &solver;
+            m_rows   = matrix.innerSize();
+            m_outer.assign(matrix.outerIndexPtr(), matrix.outerIndexPtr() + matrix.outerSize() + 1);
+            m_inner.assign(matrix.innerIndexPtr(), matrix.innerIndexPtr() + matrix.nonZeros());
+        }
+        else
+            this->clear();
+        return false;
+    }
+
+    /// Returns the number of full factorizations
+    index_t symbolicFactorizations() const { return m_symbolic; }
+
+    /// Returns the number of factorizations that reused the symbolic factorization
+    index_t numericFactorizations() const { return m_numeric; }
+
+    /**
+     * @brief      Copies the coefficients of \a source into \a target if they have the same pattern, and \a source otherwise
+     *
+     * @param[in]  source  The source matrix, e.g. the matrix of an assembler
+     * @param      target  The target matrix, e.g. the argument of a Jacobian operator
+     *
+     * @return     True if only the coefficients were copied
+     */
+    static bool overwriteValues(const gsSparseMatrix<T> & source, gsSparseMatrix<T> & target)
+    {
+        if (source.isCompressed() && target.isCompressed() && source.nonZeros()==target.nonZeros() &&
+            source.outerSize()==target.outerSize() && source.innerSize()==target.innerSize() &&
+            std::equal(source.outerIndexPtr(), source.outerIndexPtr() + source.outerSize() + 1, target.outerIndexPtr()) &&
+            std::equal(source.innerIndexPtr(), source.innerIndexPtr() + source.nonZeros(), target.innerIndexPtr()))
+        {
+            std::copy(source.valuePtr(), source.valuePtr() + source.nonZeros(), target.valuePtr());
+            return true;
+        }
+        target = source;
+        return false;
+    }
+
+protected:
+
+    static bool samePattern(const gsSparseMatrix<T> & matrix, index_t rows,
+                            const std::vector<StorageIndex> & outer,
+                            const std::vector<StorageIndex> & inner)
+    {
+        return matrix.innerSize()==rows &&
+               (size_t)(matrix.outerSize() + 1)==outer.size() &&
+               (size_t)(matrix.nonZeros())==inner.size() &&
+               std::equal(outer.begin(), outer.end(), matrix.outerIndexPtr()) &&
+               std::equal(inner.begin(), inner.end(), matrix.innerIndexPtr());
+    }
+
+    /// Computes the numerical factorization only, returns false if \a solver does not provide it
+    static bool _numericFactorization(gsSparseSolver<T> & solver, const gsSparseMatrix<T> & matrix)
+    {
+        if ( auto * s = dynamic_cast<typename gsSparseSolver<T>::SimplicialLDLT*>(&solver) )
+            s->factorize(matrix);
+        else if ( auto * s = dynamic_cast<typename gsSparseSolver<T>::SimplicialLLT*>(&solver) )
+            s->factorize(matrix);
+        else if ( auto * s = dynamic_cast<typename gsSparseSolver<T>::SparseLU*>(&solver) )
+            s->factorize(matrix);
+        else
+            return false;
+        return true;
+    }
+
+protected:
+    /// Solver that analyzed the pattern
+    const gsSparseSolver<T> * m_solver;
+
+    /// Number of rows (inner size) and the compressed pattern
+    index_t m_rows;
+    std::vector<StorageIndex> m_outer, m_inner;
+
+    index_t m_symbolic, m_numeric;
+};
+
+} // namespace gismo
@@ -0,0 +1,321 @@
+ /** @file gsStructuralAnalysisCache.h
+
+    @brief Memoises the evaluations of the operators of the gsStructuralAnalysis module
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <deque>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsSparsityPattern.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Cache of the evaluations of the operators in \ref gsStructuralAnalysisOps
+
+    The solvers evaluate the residual and the Jacobian on the same state more
+    than once, e.g. when the stability is computed after a converged step, or
+    when a singular point is tested. The cache wraps the operators, such that
+    the results of the last evaluations are returned instead of evaluating
+    the operators again.
+
+    The entries of the cache are identified by a hash of the solution vector,
+    and are verified on the full solution vector. Per entry, the cache holds
+    - the state object, e.g. the deformed geometry, made by the state function (see \ref setStateFunction and \ref state),
+    - the last residual, together with the load factor and the time it was computed for,
+    - the last Jacobian, together with the time it was computed for.
+
+    The number of entries is limited by \ref setCapacity; the oldest entry is
+    removed first. The cache is not thread-safe.
+
+    \tparam T       coefficient type
+    \tparam State   type of the state object made from the solution vector
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T, class State = gsMatrix<T> >
+class gsStructuralAnalysisCache
+{
+    typedef gsStructuralAnalysisOps<T> Ops;
+
+public:
+
+    typedef typename Ops::Residual_t            Residual_t;
+    typedef typename Ops::ALResidual_t          ALResidual_t;
+    typedef typename Ops::TResidual_t           TResidual_t;
+    typedef typename Ops::Jacobian_t            Jacobian_t;
+    typedef typename Ops::TJacobian_t           TJacobian_t;
+    typedef typename Ops::ResidualJacobian_t    ResidualJacobian_t;
+    typedef typename Ops::ALResidualJacobian_t  ALResidualJacobian_t;
+
+    /// Function making the state object from the solution vector
+    typedef std::function < typename memory::shared_ptr<State> ( gsVector<T> const & ) > StateFun_t;
+
+protected:
+
+    struct Entry
+    {
+        std::size_t hash;
+        gsVector<T> x;
+
+        typename memory::shared_ptr<State> state;
+
+        bool hasResidual;
+        T residualL, residualT;
+        gsVector<T> residual;
+
+        bool hasJacobian;
+        T jacobianT;
+        gsSparseMatrix<T> jacobian;
+    };
+
+public:
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  capacity  The maximum number of cached states
+     */
+    gsStructuralAnalysisCache(index_t capacity = 2)
+    :
+    m_capacity(capacity),
+    m_stateFun(nullptr)
+    {
+        this->resetStatistics();
+    }
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  stateFun  The function making the state object
+     * @param[in]  capacity  The maximum number of cached states
+     */
+    gsStructuralAnalysisCache(const StateFun_t & stateFun, index_t capacity = 2)
+    :
+    m_capacity(capacity),
+    m_stateFun(stateFun)
+    {
+        this->resetStatistics();
+    }
+
+    /// Sets the function making the state object from the solution vector
+    void setStateFunction(const StateFun_t & stateFun) { m_stateFun = stateFun; this->clear(); }
+
+    /// Sets the maximum number of cached states
+    void setCapacity(index_t capacity)
+    {
+        GISMO_ENSURE(capacity > 0,"The capacity of the cache should be positive");
+        m_capacity = capacity;
+        while ((index_t)(m_entries.size()) > m_capacity)
+            m_entries.pop_front();
+    }
+
+    /// Removes all cached evaluations. Should be called when the operators change, e.g. when the assembler options change
+    void clear() { m_entries.clear(); }
+
+    /// Resets the numbers of hits and misses
+    void resetStatistics() { m_hits = m_misses = 0; }
+
+    /// Returns the number of evaluations that were served from the cache
+    index_t hits() const { return m_hits; }
+
+    /// Returns the number of evaluations that called the operators
+    index_t misses() const { return m_misses; }
+
+    /// Returns the state object belonging to the solution \a x, made by the state function if it is not cached
+    const State & state(const gsVector<T> & x)
+    {
+        Entry & entry = this->_entry(x);
+        if (!entry.state)
+        {
+            GISMO_ENSURE(m_stateFun!=nullptr,"No state function is set");
+            entry.state = m_stateFun(x);
+            m_misses++;
+        }
+        else
+            m_hits++;
+        return *entry.state;
+    }
+
+    /// Returns a cached version of the residual \a residual
+    Residual_t residual(const Residual_t & residual)
+    {
+        return [this,residual](gsVector<T> const & x, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,0,0,result,[&](gsVector<T> & R) { return residual(x,R); });
+        };
+    }
+
+    /// Returns a cached version of the arc-length residual \a ALResidual
+    ALResidual_t ALResidual(const ALResidual_t & ALResidual)
+    {
+        return [this,ALResidual](gsVector<T> const & x, const T L, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,L,0,result,[&](gsVector<T> & R) { return ALResidual(x,L,R); });
+        };
+    }
+
+    /// Returns a cached version of the time-dependent residual \a TResidual
+    TResidual_t TResidual(const TResidual_t & TResidual)
+    {
+        return [this,TResidual](gsVector<T> const & x, const T time, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,0,time,result,[&](gsVector<T> & R) { return TResidual(x,time,R); });
+        };
+    }
+
+    /// Returns a cached version of the Jacobian \a jacobian
+    Jacobian_t jacobian(const Jacobian_t & jacobian)
+    {
+        return [this,jacobian](gsVector<T> const & x, gsSparseMatrix<T> & result) -> bool
+        {
+            return this->_jacobian(x,0,result,[&](gsSparseMatrix<T> & K) { return jacobian(x,K); });
+        };
+    }
+
+    /// Returns a cached version of the time-dependent Jacobian \a TJacobian
+    TJacobian_t TJacobian(const TJacobian_t & TJacobian)
+    {
+        return [this,TJacobian](gsVector<T> const & x, const T time, gsSparseMatrix<T> & result) -> bool
+        {
+            return this->_jacobian(x,time,result,[&](gsSparseMatrix<T> & K) { return TJacobian(x,time,K); });
+        };
+    }
+
+    /// Returns a cached version of the fused residual and Jacobian \a residualJacobian
+    ResidualJacobian_t residualJacobian(const ResidualJacobian_t & residualJacobian)
+    {
+        return [this,residualJacobian](gsVector<T> const & x, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            return this->_residualJacobian(x,0,0,R,K,[&](gsVector<T> & r, gsSparseMatrix<T> & k) { return residualJacobian(x,r,k); });
+        };
+    }
+
+    /// Returns a cached version of the fused arc-length residual and Jacobian \a ALResidualJacobian
+    ALResidualJacobian_t ALResidualJacobian(const ALResidualJacobian_t & ALResidualJacobian)
+    {
+        return [this,ALResidualJacobian](gsVector<T> const & x, const T L, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            return this->_residualJacobian(x,L,0,R,K,[&](gsVector<T> & r, gsSparseMatrix<T> & k) { return ALResidualJacobian(x,L,r,k); });
+        };
+    }
+
+    /// Returns the hash of the solution vector \a x
+    static std::size_t hash(const gsVector<T> & x)
+    {
+        std::hash<T> hasher;
+        std::size_t seed = x.rows();
+        for (index_t i = 0; i!=x.rows(); i++)
+            seed ^= hasher(x[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+
+protected:
+
+    /// Returns the entry belonging to \a x, or makes a new one
+    Entry & _entry(const gsVector<T> & x)
+    {
+        const std::size_t h = hash(x);
+        for (typename std::deque<Entry>::reverse_iterator it = m_entries.rbegin(); it!=m_entries.rend(); it++)
+            if (it->hash==h && it->x.rows()==x.rows() && it->x==x)
+                return *it;
+
+        if ((index_t)(m_entries.size()) >= m_capacity)
+            m_entries.pop_front();
+        m_entries.push_back(Entry());
+        Entry & entry = m_entries.back();
+        entry.hash = h;
+        entry.x = x;
+        entry.hasResidual = entry.hasJacobian = false;
+        return entry;
+    }
+
+    template<class Fun>
+    bool _residual(const gsVector<T> & x, const T L, const T time, gsVector<T> & result, const Fun & fun)
+    {
+        Entry & entry = this->_entry(x);
+        if (entry.hasResidual && entry.residualL==L && entry.residualT==time)
+        {
+            m_hits++;
+            result = entry.residual;
+            return true;
+        }
+        m_misses++;
+        // The operator can evaluate the state, hence the entry is accessed again afterwards
+        if (!fun(result))
+            return false;
+        Entry & updated = this->_entry(x);
+        updated.residual = result;
+        updated.residualL = L;
+        updated.residualT = time;
+        updated.hasResidual = true;
+        return true;
+    }
+
+    template<class Fun>
+    bool _jacobian(const gsVector<T> & x, const T time, gsSparseMatrix<T> & result, const Fun & fun)
+    {
+        Entry & entry = this->_entry(x);
+        if (entry.hasJacobian && entry.jacobianT==time)
+        {
+            m_hits++;
+            gsSparsityPattern<T>::overwriteValues(entry.jacobian,result);
+            return true;
+        }
+        m_misses++;
+        if (!fun(result))
+            return false;
+        Entry & updated = this->_entry(x);
+        gsSparsityPattern<T>::overwriteValues(result,updated.jacobian);
+        updated.jacobianT = time;
+        updated.hasJacobian = true;
+        return true;
+    }
+
+    template<class Fun>
+    bool _residualJacobian(const gsVector<T> & x, const T L, const T time, gsVector<T> & R, gsSparseMatrix<T> & K, const Fun & fun)
+    {
+        Entry & entry = this->_entry(x);
+        if (entry.hasResidual && entry.residualL==L && entry.residualT==time &&
+            entry.hasJacobian && entry.jacobianT==time)
+        {
+            m_hits++;
+            R = entry.residual;
+            gsSparsityPattern<T>::overwriteValues(entry.jacobian,K);
+            return true;
+        }
+        m_misses++;
+        if (!fun(R,K))
+            return false;
+        Entry & updated = this->_entry(x);
+        updated.residual = R;
+        updated.residualL = L;
+        updated.residualT = time;
+        updated.hasResidual = true;
+        gsSparsityPattern<T>::overwriteValues(K,updated.jacobian);
+        updated.jacobianT = time;
+        updated.hasJacobian = true;
+        return true;
+    }
+
+protected:
+    index_t m_capacity;
+    StateFun_t m_stateFun;
+
+    /// Cached entries, the most recent one last
+    std::deque<Entry> m_entries;
+
+    index_t m_hits, m_misses;
+};
+
+} // namespace gismo
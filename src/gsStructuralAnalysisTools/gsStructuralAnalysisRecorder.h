@@ -0,0 +1,636 @@
+ /** @file gsStructuralAnalysisRecorder.h
+
+    @brief Records the evaluations of the operators of the gsStructuralAnalysis module and replays them
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <fstream>
+#include <unordered_map>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisTypes.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisCache.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Binary log format of \ref gsStructuralAnalysisRecorder and \ref gsStructuralAnalysisReplay
+
+    The log starts with the magic string "GSSAREC1", the size of the
+    coefficient type and the size of the sparse index type (one byte each).
+    Every record consists of
+    - a flag byte: bit 0: residual, bit 1: Jacobian, bit 2: the Jacobian has the pattern of the previous Jacobian in the log, bit 3: the operator succeeded, bit 4: solution update,
+    - the load factor and the time the operators were evaluated for,
+    - the state (solution vector),
+    - the solution update, if recorded (Jacobians that take the update),
+    - the residual, if recorded,
+    - the Jacobian, if recorded, in compressed column format. The pattern is omitted if bit 2 is set.
+
+    Vectors are stored as their size (int64) followed by the coefficients.
+    When reading, the size is checked against the remaining length of the log.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+struct gsStructuralAnalysisLog
+{
+    typedef typename gsSparseMatrix<T>::StorageIndex StorageIndex;
+
+    enum
+    {
+        HasResidual = 1,
+        HasJacobian = 2,
+        SamePattern = 4,
+        Success     = 8,
+        HasUpdate   = 16
+    };
+
+    static const char * magic() { return "GSSAREC1"; }
+
+    template<class S>
+    static void write(std::ostream & os, const S & value)
+    {
+        os.write(reinterpret_cast<const char *>(&value),sizeof(S));
+    }
+
+    template<class S>
+    static void write(std::ostream & os, const S * data, std::size_t size)
+    {
+        write<int64_t>(os,size);
+        os.write(reinterpret_cast<const char *>(data),size*sizeof(S));
+    }
+
+    template<class S>
+    static S read(std::istream & is)
+    {
+        S value;
+        is.read(reinterpret_cast<char *>(&value),sizeof(S));
+        GISMO_ENSURE(is.good(),"The log is corrupt");
+        return value;
+    }
+
+    /// Reads the size of a vector of \a S, which has to fit in the remaining part of the stream
+    template<class S>
+    static std::size_t readSize(std::istream & is)
+    {
+        const int64_t size = read<int64_t>(is);
+        const std::streampos pos = is.tellg();
+        is.seekg(0,std::ios::end);
+        const std::streamoff remaining = is.tellg() - pos;
+        is.seekg(pos);
+        GISMO_ENSURE(is.good() && size >= 0 && (uint64_t)(size) <= (uint64_t)(remaining) / sizeof(S),"The log is corrupt");
+        return size;
+    }
+
+    template<class S>
+    static void read(std::istream & is, std::vector<S> & data)
+    {
+        data.resize(readSize<S>(is));
+        is.read(reinterpret_cast<char *>(data.data()),data.size()*sizeof(S));
+        GISMO_ENSURE(is.good(),"The log is corrupt");
+    }
+
+    static void read(std::istream & is, gsVector<T> & data)
+    {
+        data.resize(readSize<T>(is));
+        is.read(reinterpret_cast<char *>(data.data()),data.size()*sizeof(T));
+        GISMO_ENSURE(is.good(),"The log is corrupt");
+    }
+};
+
+/**
+    @brief Records the evaluations of the operators in \ref gsStructuralAnalysisOps in a binary log
+
+    The recorder wraps the operators, such that every evaluation is written
+    to the log together with the state it was evaluated on. The log can be
+    served to any solver with \ref gsStructuralAnalysisReplay, e.g. to
+    compare linear solvers or solver settings on the matrices of a
+    production run without the assembler. See \ref gsStructuralAnalysisLog
+    for the format. Subsequent Jacobians with the same sparsity pattern store
+    the pattern only once.
+
+    The recorder is not thread-safe.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsStructuralAnalysisRecorder
+{
+    typedef gsStructuralAnalysisOps<T> Ops;
+    typedef gsStructuralAnalysisLog<T> Log;
+    typedef typename Log::StorageIndex StorageIndex;
+
+public:
+
+    typedef typename Ops::Residual_t            Residual_t;
+    typedef typename Ops::ALResidual_t          ALResidual_t;
+    typedef typename Ops::TResidual_t           TResidual_t;
+    typedef typename Ops::Jacobian_t            Jacobian_t;
+    typedef typename Ops::TJacobian_t           TJacobian_t;
+    typedef typename Ops::dJacobian_t           dJacobian_t;
+    typedef typename Ops::ResidualJacobian_t    ResidualJacobian_t;
+    typedef typename Ops::ALResidualJacobian_t  ALResidualJacobian_t;
+
+    /**
+     * @brief      Constructor
+     *
+     * @param[in]  filename  The file the log is written to. An existing file is overwritten
+     */
+    gsStructuralAnalysisRecorder(const std::string & filename)
+    :
+    m_file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+    m_records(0)
+    {
+        GISMO_ENSURE(m_file.is_open(),"The log "<<filename<<" could not be opened");
+        m_file.write(Log::magic(),8);
+        Log::template write<uint8_t>(m_file,sizeof(T));
+        Log::template write<uint8_t>(m_file,sizeof(StorageIndex));
+    }
+
+    /// Returns a recorded version of the residual \a residual
+    Residual_t residual(const Residual_t & residual)
+    {
+        return [this,residual](gsVector<T> const & x, gsVector<T> & result) -> bool
+        {
+            const bool success = residual(x,result);
+            this->_record(x,nullptr,0,0,&result,nullptr,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the arc-length residual \a ALResidual
+    ALResidual_t ALResidual(const ALResidual_t & ALResidual)
+    {
+        return [this,ALResidual](gsVector<T> const & x, const T L, gsVector<T> & result) -> bool
+        {
+            const bool success = ALResidual(x,L,result);
+            this->_record(x,nullptr,L,0,&result,nullptr,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the time-dependent residual \a TResidual
+    TResidual_t TResidual(const TResidual_t & TResidual)
+    {
+        return [this,TResidual](gsVector<T> const & x, const T time, gsVector<T> & result) -> bool
+        {
+            const bool success = TResidual(x,time,result);
+            this->_record(x,nullptr,0,time,&result,nullptr,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the Jacobian \a jacobian
+    Jacobian_t jacobian(const Jacobian_t & jacobian)
+    {
+        return [this,jacobian](gsVector<T> const & x, gsSparseMatrix<T> & result) -> bool
+        {
+            const bool success = jacobian(x,result);
+            this->_record(x,nullptr,0,0,nullptr,&result,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the time-dependent Jacobian \a TJacobian
+    TJacobian_t TJacobian(const TJacobian_t & TJacobian)
+    {
+        return [this,TJacobian](gsVector<T> const & x, const T time, gsSparseMatrix<T> & result) -> bool
+        {
+            const bool success = TJacobian(x,time,result);
+            this->_record(x,nullptr,0,time,nullptr,&result,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the Jacobian \a dJacobian, which takes the solution update. The solution and the update are recorded
+    dJacobian_t dJacobian(const dJacobian_t & dJacobian)
+    {
+        return [this,dJacobian](gsVector<T> const & x, gsVector<T> const & dx, gsSparseMatrix<T> & result) -> bool
+        {
+            const bool success = dJacobian(x,dx,result);
+            this->_record(x,&dx,0,0,nullptr,&result,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the fused residual and Jacobian \a residualJacobian
+    ResidualJacobian_t residualJacobian(const ResidualJacobian_t & residualJacobian)
+    {
+        return [this,residualJacobian](gsVector<T> const & x, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            const bool success = residualJacobian(x,R,K);
+            this->_record(x,nullptr,0,0,&R,&K,success);
+            return success;
+        };
+    }
+
+    /// Returns a recorded version of the fused arc-length residual and Jacobian \a ALResidualJacobian
+    ALResidualJacobian_t ALResidualJacobian(const ALResidualJacobian_t & ALResidualJacobian)
+    {
+        return [this,ALResidualJacobian](gsVector<T> const & x, const T L, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            const bool success = ALResidualJacobian(x,L,R,K);
+            this->_record(x,nullptr,L,0,&R,&K,success);
+            return success;
+        };
+    }
+
+    /// Returns the number of records written
+    index_t records() const { return m_records; }
+
+    /// Writes the buffered records to the file
+    void flush() { m_file.flush(); }
+
+protected:
+
+    void _record(const gsVector<T> & x, const gsVector<T> * dx, const T L, const T time, const gsVector<T> * R, gsSparseMatrix<T> * K, bool success)
+    {
+        uint8_t flags = success ? Log::Success : 0;
+        if (dx) flags |= Log::HasUpdate;
+        if (R) flags |= Log::HasResidual;
+        if (K)
+        {
+            flags |= Log::HasJacobian;
+            K->makeCompressed();
+            if (this->_samePattern(*K))
+                flags |= Log::SamePattern;
+        }
+
+        Log::template write<uint8_t>(m_file,flags);
+        Log::template write<T>(m_file,L);
+        Log::template write<T>(m_file,time);
+        Log::template write<T>(m_file,x.data(),x.size());
+        if (dx)
+            Log::template write<T>(m_file,dx->data(),dx->size());
+        if (R)
+            Log::template write<T>(m_file,R->data(),R->size());
+        if (K)
+        {
+            Log::template write<int64_t>(m_file,K->rows());
+            Log::template write<int64_t>(m_file,K->cols());
+            if (!(flags & Log::SamePattern))
+            {
+                Log::template write<StorageIndex>(m_file,K->outerIndexPtr(),K->outerSize()+1);
+                Log::template write<StorageIndex>(m_file,K->innerIndexPtr(),K->nonZeros());
+                m_outer.assign(K->outerIndexPtr(),K->outerIndexPtr()+K->outerSize()+1);
+                m_inner.assign(K->innerIndexPtr(),K->innerIndexPtr()+K->nonZeros());
+                m_rows = K->rows();
+            }
+            Log::template write<T>(m_file,K->valuePtr(),K->nonZeros());
+        }
+        GISMO_ENSURE(m_file.good(),"Writing the log failed");
+        m_records++;
+    }
+
+    /// Returns true if \a K has the pattern of the last Jacobian in the log
+    bool _samePattern(const gsSparseMatrix<T> & K) const
+    {
+        return !m_outer.empty() && K.rows()==m_rows &&
+               (size_t)(K.outerSize()+1)==m_outer.size() && (size_t)(K.nonZeros())==m_inner.size() &&
+               std::equal(m_outer.begin(),m_outer.end(),K.outerIndexPtr()) &&
+               std::equal(m_inner.begin(),m_inner.end(),K.innerIndexPtr());
+    }
+
+protected:
+    std::ofstream m_file;
+    index_t m_records;
+
+    /// Pattern of the last Jacobian in the log
+    index_t m_rows;
+    std::vector<StorageIndex> m_outer, m_inner;
+};
+
+/**
+    @brief Serves the evaluations recorded by \ref gsStructuralAnalysisRecorder as operators
+
+    The operators of the replay can be given to any solver instead of the
+    operators of an assembler. They serve the recorded residuals and
+    Jacobians in one of two modes:
+    - \ref Sequential: every call returns the next recorded residual or Jacobian, regardless of its arguments. The solver sees the recorded workload, even if its own iterates differ from the recorded ones, e.g. when comparing linear solvers.
+    - \ref ByState: every call returns the last recorded evaluation on the same state (and load factor or time, or solution update). If there is none, the operator returns false, which the solvers report as an assembly error.
+
+    A fused operator serves the next residual and the next Jacobian, or the
+    evaluations on the same state, respectively. Operators return the
+    success flag that was recorded. The Jacobians of the replay share the
+    sparsity patterns of the log; only their values are stored per record.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsStructuralAnalysisReplay
+{
+    typedef gsStructuralAnalysisOps<T> Ops;
+    typedef gsStructuralAnalysisLog<T> Log;
+    typedef typename Log::StorageIndex StorageIndex;
+
+    /// Sparsity pattern of a Jacobian, shared by the records that have it
+    struct Pattern
+    {
+        index_t rows, cols;
+        std::vector<StorageIndex> outer, inner;
+    };
+
+    struct Record
+    {
+        uint8_t flags;
+        T L, time;
+        gsVector<T> x, update;
+        gsVector<T> residual;
+        /// The index of the pattern of the Jacobian in m_patterns, and its values
+        index_t pattern;
+        gsVector<T> values;
+    };
+
+public:
+
+    typedef typename Ops::Residual_t            Residual_t;
+    typedef typename Ops::ALResidual_t          ALResidual_t;
+    typedef typename Ops::TResidual_t           TResidual_t;
+    typedef typename Ops::Jacobian_t            Jacobian_t;
+    typedef typename Ops::TJacobian_t           TJacobian_t;
+    typedef typename Ops::dJacobian_t           dJacobian_t;
+    typedef typename Ops::ResidualJacobian_t    ResidualJacobian_t;
+    typedef typename Ops::ALResidualJacobian_t  ALResidualJacobian_t;
+
+    /// Modes of serving the records
+    enum Mode
+    {
+        Sequential = 0, ///< The records are served in their order
+        ByState    = 1  ///< The records are served by the state they were evaluated on
+    };
+
+    /**
+     * @brief      Constructor, reads the log
+     *
+     * @param[in]  filename  The log written by \ref gsStructuralAnalysisRecorder
+     * @param[in]  mode      The mode of serving the records
+     */
+    gsStructuralAnalysisReplay(const std::string & filename, Mode mode = Sequential)
+    :
+    m_mode(mode)
+    {
+        this->_read(filename);
+        this->rewind();
+    }
+
+    /// Sets the mode of serving the records
+    void setMode(Mode mode) { m_mode = mode; }
+
+    /// Restarts serving the records from the first one (see \ref Sequential)
+    void rewind() { m_nextResidual = m_nextJacobian = 0; }
+
+    /// Returns the number of records
+    index_t records() const { return m_records.size(); }
+
+    /// Returns the state of record \a k
+    const gsVector<T> & state(index_t k) const { return m_records[k].x; }
+
+    /// Returns the Jacobian of record \a k. The matrix is empty if record \a k has no Jacobian
+    gsSparseMatrix<T> jacobian(index_t k) const
+    {
+        gsSparseMatrix<T> result;
+        if (m_records[k].flags & Log::HasJacobian)
+            this->_assign(m_records[k],result);
+        return result;
+    }
+
+    /// Returns the number of distinct sparsity patterns of the Jacobians
+    index_t patterns() const { return m_patterns.size(); }
+
+    /// Returns the residual of record \a k. The vector is empty if record \a k has no residual
+    const gsVector<T> & residual(index_t k) const { return m_records[k].residual; }
+
+    /// Returns the recorded residual
+    Residual_t residual()
+    {
+        return [this](gsVector<T> const & x, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,0,0,result);
+        };
+    }
+
+    /// Returns the recorded arc-length residual
+    ALResidual_t ALResidual()
+    {
+        return [this](gsVector<T> const & x, const T L, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,L,0,result);
+        };
+    }
+
+    /// Returns the recorded time-dependent residual
+    TResidual_t TResidual()
+    {
+        return [this](gsVector<T> const & x, const T time, gsVector<T> & result) -> bool
+        {
+            return this->_residual(x,0,time,result);
+        };
+    }
+
+    /// Returns the recorded Jacobian
+    Jacobian_t jacobian()
+    {
+        return [this](gsVector<T> const & x, gsSparseMatrix<T> & result) -> bool
+        {
+            return this->_jacobian(x,nullptr,0,result);
+        };
+    }
+
+    /// Returns the recorded time-dependent Jacobian
+    TJacobian_t TJacobian()
+    {
+        return [this](gsVector<T> const & x, const T time, gsSparseMatrix<T> & result) -> bool
+        {
+            return this->_jacobian(x,nullptr,time,result);
+        };
+    }
+
+    /// Returns the recorded Jacobian, as an operator that takes the solution update
+    dJacobian_t dJacobian()
+    {
+        return [this](gsVector<T> const & x, gsVector<T> const & dx, gsSparseMatrix<T> & result) -> bool
+        {
+            return this->_jacobian(x,&dx,0,result);
+        };
+    }
+
+    /// Returns the recorded fused residual and Jacobian
+    ResidualJacobian_t residualJacobian()
+    {
+        return [this](gsVector<T> const & x, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            const bool success = this->_residual(x,0,0,R);
+            return this->_jacobian(x,nullptr,0,K) && success;
+        };
+    }
+
+    /// Returns the recorded fused arc-length residual and Jacobian
+    ALResidualJacobian_t ALResidualJacobian()
+    {
+        return [this](gsVector<T> const & x, const T L, gsVector<T> & R, gsSparseMatrix<T> & K) -> bool
+        {
+            const bool success = this->_residual(x,L,0,R);
+            return this->_jacobian(x,nullptr,0,K) && success;
+        };
+    }
+
+protected:
+
+    void _read(const std::string & filename)
+    {
+        std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+        GISMO_ENSURE(file.is_open(),"The log "<<filename<<" could not be opened");
+        char magic[8];
+        file.read(magic,8);
+        GISMO_ENSURE(file.good() && std::equal(magic,magic+8,Log::magic()),filename<<" is not a log of gsStructuralAnalysisRecorder");
+        GISMO_ENSURE(Log::template read<uint8_t>(file)==sizeof(T),"The coefficient type of the log does not match");
+        GISMO_ENSURE(Log::template read<uint8_t>(file)==sizeof(StorageIndex),"The index type of the log does not match");
+
+        m_records.clear();
+        m_patterns.clear();
+        m_index.clear();
+        while (file.peek()!=std::char_traits<char>::eof())
+        {
+            Record record;
+            record.flags = Log::template read<uint8_t>(file);
+            record.L     = Log::template read<T>(file);
+            record.time  = Log::template read<T>(file);
+            Log::read(file,record.x);
+            if (record.flags & Log::HasUpdate)
+                Log::read(file,record.update);
+            if (record.flags & Log::HasResidual)
+                Log::read(file,record.residual);
+            record.pattern = -1;
+            if (record.flags & Log::HasJacobian)
+            {
+                const int64_t rows = Log::template read<int64_t>(file);
+                const int64_t cols = Log::template read<int64_t>(file);
+                if (!(record.flags & Log::SamePattern))
+                {
+                    Pattern pattern;
+                    pattern.rows = rows;
+                    pattern.cols = cols;
+                    Log::read(file,pattern.outer);
+                    Log::read(file,pattern.inner);
+                    GISMO_ENSURE(this->_valid(pattern),"The log is corrupt");
+                    m_patterns.push_back(give(pattern));
+                }
+                GISMO_ENSURE(!m_patterns.empty() && m_patterns.back().rows==rows && m_patterns.back().cols==cols,"The log is corrupt");
+                record.pattern = m_patterns.size()-1;
+                Log::read(file,record.values);
+                GISMO_ENSURE(record.values.size()==(index_t)(m_patterns.back().inner.size()),"The log is corrupt");
+            }
+            m_index[gsStructuralAnalysisCache<T>::hash(record.x)].push_back(m_records.size());
+            m_records.push_back(give(record));
+        }
+    }
+
+    /// Returns the index of the next record with flag \a flag from \a next, or -1
+    index_t _next(index_t & next, uint8_t flag) const
+    {
+        while (next < (index_t)(m_records.size()) && !(m_records[next].flags & flag))
+            next++;
+        return next < (index_t)(m_records.size()) ? next++ : -1;
+    }
+
+    /// Checks that the compressed storage of \a pattern is consistent, before it is mapped
+    static bool _valid(const Pattern & pattern)
+    {
+        if (pattern.rows < 0 || pattern.cols < 0 || (index_t)(pattern.outer.size())!=pattern.cols+1 ||
+            pattern.outer.front()!=0 || pattern.outer.back()!=(StorageIndex)(pattern.inner.size()))
+            return false;
+        for (index_t j = 0; j!=pattern.cols; j++)
+            if (pattern.outer[j] > pattern.outer[j+1])
+                return false;
+        for (typename std::vector<StorageIndex>::const_iterator i = pattern.inner.begin(); i!=pattern.inner.end(); i++)
+            if (*i < 0 || *i >= pattern.rows)
+                return false;
+        return true;
+    }
+
+    /// Assigns the Jacobian of \a record to \a result. Only the values are copied if \a result has its pattern
+    void _assign(const Record & record, gsSparseMatrix<T> & result) const
+    {
+        const Pattern & pattern = m_patterns[record.pattern];
+        if (result.isCompressed() && result.rows()==pattern.rows && result.cols()==pattern.cols &&
+            result.nonZeros()==record.values.size() &&
+            std::equal(pattern.outer.begin(),pattern.outer.end(),result.outerIndexPtr()) &&
+            std::equal(pattern.inner.begin(),pattern.inner.end(),result.innerIndexPtr()))
+            std::copy(record.values.data(),record.values.data()+record.values.size(),result.valuePtr());
+        else
+            result = gsEigen::Map<const typename gsSparseMatrix<T>::Base>(pattern.rows,pattern.cols,record.values.size(),
+                                                                          pattern.outer.data(),pattern.inner.data(),record.values.data());
+    }
+
+    /// Returns the index of the last record with flag \a flag on \a x, or -1.
+    /// Records with a solution update only match if \a dx is that update, and are preferred over records without one
+    index_t _find(const gsVector<T> & x, const gsVector<T> * dx, const T L, const T time, uint8_t flag) const
+    {
+        typename std::unordered_map<std::size_t,std::vector<index_t> >::const_iterator it = m_index.find(gsStructuralAnalysisCache<T>::hash(x));
+        if (it==m_index.end())
+            return -1;
+        index_t withoutUpdate = -1;
+        for (typename std::vector<index_t>::const_reverse_iterator k = it->second.rbegin(); k!=it->second.rend(); k++)
+        {
+            const Record & record = m_records[*k];
+            if (!(record.flags & flag) || record.time!=time || (flag==Log::HasResidual && record.L!=L) ||
+                record.x.rows()!=x.rows() || record.x!=x)
+                continue;
+            if (!(record.flags & Log::HasUpdate))
+            {
+                if (!dx)
+                    return *k;
+                if (withoutUpdate==-1)
+                    withoutUpdate = *k;
+            }
+            else if (dx && record.update.rows()==dx->rows() && record.update==*dx)
+                return *k;
+        }
+        return withoutUpdate;
+    }
+
+    bool _residual(const gsVector<T> & x, const T L, const T time, gsVector<T> & result)
+    {
+        const index_t k = m_mode==Sequential ? this->_next(m_nextResidual,Log::HasResidual) : this->_find(x,nullptr,L,time,Log::HasResidual);
+        if (k==-1)
+            return false;
+        result = m_records[k].residual;
+        return m_records[k].flags & Log::Success;
+    }
+
+    bool _jacobian(const gsVector<T> & x, const gsVector<T> * dx, const T time, gsSparseMatrix<T> & result)
+    {
+        const index_t k = m_mode==Sequential ? this->_next(m_nextJacobian,Log::HasJacobian) : this->_find(x,dx,0,time,Log::HasJacobian);
+        if (k==-1)
+            return false;
+        this->_assign(m_records[k],result);
+        return m_records[k].flags & Log::Success;
+    }
+
+protected:
+    Mode m_mode;
+    std::vector<Record> m_records;
+    std::vector<Pattern> m_patterns;
+
+    /// Records per hash of the state
+    std::unordered_map<std::size_t,std::vector<index_t> > m_index;
+
+    /// Next records in the sequential mode
+    index_t m_nextResidual, m_nextJacobian;
+};
+
+} // namespace gismo
@@ -14,6 +14,8 @@
 #include <functional>
 #include <gsCore/gsLinearAlgebra.h>
 
+#pragma once
+
 namespace gismo
 {
 
@@ -24,7 +26,9 @@ enum struct gsStatus
     AssemblyError,   ///< Assembly problem in step
     SolverError,     ///< Assembly problem in step
     NotStarted,      ///< ALM has not started yet
-    OtherError       ///< Other error
+    OtherError,      ///< Other error
+    MemoryError,     ///< Estimated memory exceeds the limit
+    Interrupted      ///< Step interrupted, e.g. because a parallel trial step converged
 };
 
 // ALTERNATIVE IMPLEMENTATION USING FUNCTORS
@@ -48,6 +52,27 @@ enum struct gsStatus
 
 // };
 
+/**
+ * @brief      Type in which the solvers accumulate reductions (norms, dot products, energies) of vectors with coefficient type T
+ *
+ * Single precision is accumulated in double precision, such that the
+ * relative tolerances of the solvers can be reached for large numbers of
+ * degrees of freedom.
+ *
+ * @tparam     T     coefficient type
+ */
+template<class T>
+struct gsStructuralAnalysisAccumulator
+{
+    typedef T type;
+};
+
+template<>
+struct gsStructuralAnalysisAccumulator<float>
+{
+    typedef double type;
+};
+
 /**
  * @brief      Operators for the gsStructuralAnalysis module
  *
@@ -88,6 +113,13 @@ struct gsStructuralAnalysisOps
     typedef std::function < bool ( gsVector<T> const &, const T,                gsSparseMatrix<T> & ) > TJacobian_t;
     /// Jacobian with solution update as argument
     typedef std::function < bool ( gsVector<T> const &, gsVector<T> const &,    gsSparseMatrix<T> & ) > dJacobian_t;
+
+    /// Residual and Jacobian, computed together
+    typedef std::function < bool ( gsVector<T> const &,           gsVector<T> &, gsSparseMatrix<T> & ) > ResidualJacobian_t;
+    /// Arc-Length Residual and Jacobian, computed together
+    typedef std::function < bool ( gsVector<T> const &, const T,  gsVector<T> &, gsSparseMatrix<T> & ) > ALResidualJacobian_t;
+    /// Time-dependent Residual and Jacobian, computed together
+    typedef std::function < bool ( gsVector<T> const &, const T,  gsVector<T> &, gsSparseMatrix<T> & ) > TResidualJacobian_t;
 };
 
 }
@@ -0,0 +1,96 @@
+ /** @file gsSymmetricStorage.h
+
+    @brief Storage of symmetric sparse matrices by one triangle
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): H.M. Verhelst (2019-..., TU Delft)
+*/
+
+#include <gsCore/gsLinearAlgebra.h>
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Operations on symmetric sparse matrices of which only one triangle is stored
+
+    The tangent stiffness, mass and damping matrices of the shell and solid
+    assemblers are symmetric. In symmetric storage, only the triangle \ref
+    UpLo (including the diagonal) is stored, which halves the memory of the
+    matrices and the bandwidth of copying them.
+
+    The stored triangle is the lower triangle of the column-major matrix,
+    i.e. the upper triangle of its row-compressed form. This is the triangle
+    that is read by the SimplicialLDLT and SimplicialLLT solvers, by the
+    shift-invert solvers of Spectra and by the dense self-adjoint eigensolver;
+    these consume the stored triangle directly (see \ref readsTriangle).
+    Other solvers need the full matrix, see \ref full.
+
+    Sums and scalar multiples of stored triangles are stored triangles as
+    well, hence e.g. M + dt*C + dt*dt*K can be formed directly.
+
+    \tparam T coefficient type
+
+    \ingroup gsStructuralAnalysis
+*/
+template<class T>
+class gsSymmetricStorage
+{
+public:
+
+    /// The stored triangle
+    enum { UpLo = gsEigen::Lower };
+
+    /// Stores the triangle \ref UpLo of the symmetric matrix \a matrix in \a result
+    static void triangle(const gsSparseMatrix<T> & matrix, gsSparseMatrix<T> & result)
+    {
+        result = matrix.template triangularView<UpLo>();
+    }
+
+    /// Makes the full symmetric matrix \a result from the stored triangle \a matrix
+    static void full(const gsSparseMatrix<T> & matrix, gsSparseMatrix<T> & result)
+    {
+        result = matrix.template selfadjointView<UpLo>();
+    }
+
+    /// Returns the product of the symmetric matrix, given by its stored triangle \a matrix, with \a x
+    template<class Derived>
+    static gsMatrix<T> multiply(const gsSparseMatrix<T> & matrix, const gsEigen::MatrixBase<Derived> & x)
+    {
+        gsMatrix<T> result = matrix.template selfadjointView<UpLo>() * x;
+        return result;
+    }
+
+    /// Returns true if \a solver reads the stored triangle only, such that it can factorize a stored triangle directly
+    static bool readsTriangle(const gsSparseSolver<T> & solver)
+    {
+        return dynamic_cast<const typename gsSparseSolver<T>::SimplicialLDLT*>(&solver)!=nullptr ||
+               dynamic_cast<const typename gsSparseSolver<T>::SimplicialLLT*>(&solver)!=nullptr;
+    }
+
+    /**
+     * @brief      Returns the matrix that should be factorized by \a solver
+     *
+     * @param      solver  The solver
+     * @param[in]  matrix  The stored triangle
+     * @param      buffer  Storage for the full matrix, used if \a solver does not read the triangle only
+     *
+     * @return     \a matrix, or the full matrix in \a buffer
+     */
+    static const gsSparseMatrix<T> & forSolver(const gsSparseSolver<T> & solver, const gsSparseMatrix<T> & matrix, gsSparseMatrix<T> & buffer)
+    {
+        if (readsTriangle(solver))
+            return matrix;
+        full(matrix,buffer);
+        return buffer;
+    }
+};
+
+} // namespace gismo
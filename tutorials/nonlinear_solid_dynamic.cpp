@@ -124,6 +124,15 @@ for (index_t c=0; c!=3; c++)
         v = assembler.rhs();
         return true;
     };
+
+    // Function for the Residual and the Jacobian, with one assembly
+    gsStructuralAnalysisOps<real_t>::ResidualJacobian_t ResidualJacobian = [&fixedDofs,&assembler](gsVector<real_t> const &x, gsVector<real_t> & v, gsSparseMatrix<real_t> & m)
+    {
+        assembler.assemble(x,fixedDofs);
+        v = assembler.rhs();
+        m = assembler.matrix();
+        return true;
+    };
     //! [Define nonlinear residual functions]
 
     //! [Define damping and mass matrices]
@@ -135,6 +144,8 @@ for (index_t c=0; c!=3; c++)
     //! [Set dynamic solver]
     gsInfo<<"Solving system with "<<assembler.numDofs()<<" DoFs\n";
     gsDynamicNewmark<real_t,true> solver(Mass,Damping,Jacobian,Residual);
+    // Residual and Jacobian are assembled together when both are needed
+    solver.setResidualJacobian(ResidualJacobian);
     solver.options().setSwitch("Verbose",true);
     //! [Set dynamic solver]
 
@@ -112,6 +112,15 @@ int main(int argc, char *argv[])
         v = assembler.rhs();
         return true;
     };
+
+    // Function for the Residual and the Jacobian, with one assembly
+    gsStructuralAnalysisOps<real_t>::ResidualJacobian_t ResidualJacobian = [&fixedDofs,&assembler](gsVector<real_t> const &x, gsVector<real_t> & v, gsSparseMatrix<real_t> & m)
+    {
+        assembler.assemble(x,fixedDofs);
+        v = assembler.rhs();
+        m = assembler.matrix();
+        return true;
+    };
     //! [Define nonlinear residual functions]
 
     //! [Assemble linear part]
@@ -121,7 +130,9 @@ int main(int argc, char *argv[])
     //! [Assemble linear part]
 
     //! [Set static solver]
-    gsStaticNewton<real_t> solver(K,F,Jacobian,Residual);
+    // The Jacobian and Residual functions can be used as well, i.e. solver(K,F,Jacobian,Residual),
+    // but that assembles the system twice per iteration
+    gsStaticNewton<real_t> solver(K,F,ResidualJacobian);
     solver.options().setInt("verbose",1);
     solver.initialize();
     //! [Set static solver]
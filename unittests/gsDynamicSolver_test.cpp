@@ -0,0 +1,121 @@
+/** @file gsDynamicSolver_test.cpp
+
+    @brief Provides unittests for the single-precision instances of the explicit dynamic solvers
+
+    * Explicit: unit-test based on a damped chain of springs and masses, integrated with the
+                Explicit Euler and RK4 methods in single and double precision.
+                This test checks that the single-precision results follow the double-precision results
+
+
+    == BASIC REFERENCE ==
+         - TEST(NAME_OF_TEST) { body_of_test }
+         - TEST_FIXTURE(NAME_OF_FIXTURE,NAME_OF_TEST){ body_of_test }
+
+    == CHECK MACRO REFERENCE ==
+         - CHECK(EXPR);
+         - CHECK_EQUAL(EXPECTED,ACTUAL);
+         - CHECK_CLOSE(EXPECTED,ACTUAL,EPSILON);
+         - CHECK_ARRAY_EQUAL(EXPECTED,ACTUAL,LENGTH);
+         - CHECK_ARRAY_CLOSE(EXPECTED,ACTUAL,LENGTH,EPSILON);
+         - CHECK_ARRAY2D_EQUAL(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT);
+         - CHECK_ARRAY2D_CLOSE(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT,EPSILON);
+         - CHECK_THROW(EXPR,EXCEPTION_TYPE_EXPECTED);
+
+    == TIME CONSTRAINTS ==
+         - UNITTEST_TIME_CONSTRAINT(TIME_IN_MILLISECONDS);
+         - UNITTEST_TIME_CONSTRAINT_EXEMPT();
+
+    == MORE INFO ==
+         See: https://unittest-cpp.github.io/
+
+    Author(s): H.M.Verhelst (2019 - ..., TU Delft)
+ **/
+
+#include "gismo_unittest.h"       // Brings in G+Smo and the UnitTest++ framework
+
+#include <gsStructuralAnalysis/src/gsDynamicSolvers/gsDynamicExplicitEuler.h>
+#include <gsStructuralAnalysis/src/gsDynamicSolvers/gsDynamicRK4.h>
+
+SUITE(gsDynamicSolver_test)                 // The suite should have the same name as the file
+{
+    // solver: 0: Explicit Euler, 1: RK4
+    template<class T> gsVector<T> Chain_dynamic(const index_t solver, const index_t N=30, const index_t steps=100);
+    template<class T> gsSparseMatrix<T> Chain_stiffness(const index_t N);
+    void Chain_CHECK(const index_t solver);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    TEST(DynamicSolver_Chain_ExplicitEuler)
+    {
+        Chain_CHECK(0);
+    }
+
+    TEST(DynamicSolver_Chain_RK4)
+    {
+        Chain_CHECK(1);
+    }
+
+    template<class T>
+    gsSparseMatrix<T> Chain_stiffness(const index_t N)
+    {
+        // Chain of unit springs, clamped at the first node
+        gsSparseMatrix<T> K(N,N);
+        K.reserve(gsVector<index_t>::Constant(N,3));
+        for (index_t i = 0; i!=N; i++)
+        {
+            K.insert(i,i) = (i==N-1) ? 1 : 2;
+            if (i > 0)   K.insert(i,i-1) = -1;
+            if (i < N-1) K.insert(i,i+1) = -1;
+        }
+        K.makeCompressed();
+        return K;
+    }
+
+    template<class T>
+    gsVector<T> Chain_dynamic(const index_t solver, const index_t N, const index_t steps)
+    {
+        gsSparseMatrix<T> K = Chain_stiffness<T>(N);
+        gsSparseMatrix<T> M(N,N);
+        M.setIdentity();
+        gsSparseMatrix<T> C = T(0.1)*K;
+        gsVector<T> F(N);
+        F.setOnes();
+
+        typename gsStructuralAnalysisOps<T>::Mass_t      Mass      = [&M](gsSparseMatrix<T> & result) { result = M; return true; };
+        typename gsStructuralAnalysisOps<T>::Damping_t   Damping   = [&C](const gsVector<T> &, gsSparseMatrix<T> & result) { result = C; return true; };
+        typename gsStructuralAnalysisOps<T>::Stiffness_t Stiffness = [&K](gsSparseMatrix<T> & result) { result = K; return true; };
+        typename gsStructuralAnalysisOps<T>::Force_t     Force     = [&F](gsVector<T> & result) { result = F; return true; };
+
+        gsDynamicBase<T> * timeIntegrator;
+        if (solver==0)
+            timeIntegrator = new gsDynamicExplicitEuler<T,false>(Mass,Damping,Stiffness,Force);
+        else if (solver==1)
+            timeIntegrator = new gsDynamicRK4<T,false>(Mass,Damping,Stiffness,Force);
+        else
+            GISMO_ERROR("Solver not treated");
+
+        timeIntegrator->options().setReal("DT",1e-2);
+        timeIntegrator->options().setSwitch("Verbose",false);
+
+        gsVector<T> zeros = gsVector<T>::Zero(N);
+        timeIntegrator->setU(zeros);
+        timeIntegrator->setV(zeros);
+        timeIntegrator->setA(zeros);
+
+        for (index_t k = 0; k!=steps; k++)
+            CHECK(timeIntegrator->step()==gsStatus::Success);
+
+        gsVector<T> result = timeIntegrator->displacements();
+        delete timeIntegrator;
+        return result;
+    }
+
+    void Chain_CHECK(const index_t solver)
+    {
+        gsVector<double> Udouble = Chain_dynamic<double>(solver);
+        gsVector<double> Ufloat  = Chain_dynamic<float>(solver).cast<double>();
+        CHECK(Udouble.norm() > 0);
+        CHECK_CLOSE((Ufloat-Udouble).norm()/Udouble.norm(),0,1e-4);
+    }
+
+}
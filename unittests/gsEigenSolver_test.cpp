@@ -0,0 +1,356 @@
+/** @file gsEigenSolver_test.cpp
+
+    @brief Provides unittests for the eigenvalue solvers
+
+    * Chain:   unit-test based on the modal analysis of a chain of springs and varying masses,
+               clamped at both ends.
+               This test checks the inverse and subspace iterations with and without shift, and
+               the dispatch of compute(number), compared to the dense solver, and that the
+               factorizations of repeated solves are stored per shift, up to the size of the cache
+
+    * LOBPCG:  unit-test based on the same chain.
+               This test checks LOBPCG with every preconditioner, and with mass matrices that are not
+               positive definite, compared to the dense solver. Their definiteness is either tested by
+               the solver or given by the option 'positiveB'
+
+    * Tracking: unit-test based on the same chain, with slightly heavier masses.
+               This test checks the warm start from the modes of the original chain, and that the
+               modes of the heavier chain are reordered and aligned to the initial subspace by the MAC
+
+    * CraigBampton: unit-test based on the same chain, split in three substructures.
+               This test checks that the reduction is exact with all fixed-interface modes, and that
+               the eigenvalues are upper bounds with a few modes, compared to the dense solver
+
+    * Attempts: unit-test based on the same chain, solved with Spectra with a small Krylov subspace
+               and a single restart (only with gsSpectra).
+               This test checks that the failed attempts are repeated with a larger subspace, and that
+               the options are restored afterwards
+
+    * Slicing: unit-test based on the modal analysis of a chain of springs and varying masses,
+               clamped at both ends, solved with spectrum slicing.
+               This test checks that exactly the eigenvalues in the interval are found, compared to
+               the dense solver
+
+
+    == BASIC REFERENCE ==
+         - TEST(NAME_OF_TEST) { body_of_test }
+         - TEST_FIXTURE(NAME_OF_FIXTURE,NAME_OF_TEST){ body_of_test }
+
+    == CHECK MACRO REFERENCE ==
+         - CHECK(EXPR);
+         - CHECK_EQUAL(EXPECTED,ACTUAL);
+         - CHECK_CLOSE(EXPECTED,ACTUAL,EPSILON);
+         - CHECK_ARRAY_EQUAL(EXPECTED,ACTUAL,LENGTH);
+         - CHECK_ARRAY_CLOSE(EXPECTED,ACTUAL,LENGTH,EPSILON);
+         - CHECK_ARRAY2D_EQUAL(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT);
+         - CHECK_ARRAY2D_CLOSE(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT,EPSILON);
+         - CHECK_THROW(EXPR,EXCEPTION_TYPE_EXPECTED);
+
+    == TIME CONSTRAINTS ==
+         - UNITTEST_TIME_CONSTRAINT(TIME_IN_MILLISECONDS);
+         - UNITTEST_TIME_CONSTRAINT_EXEMPT();
+
+    == MORE INFO ==
+         See: https://unittest-cpp.github.io/
+
+    Author(s): H.M.Verhelst (2019 - ..., TU Delft)
+ **/
+
+#include "gismo_unittest.h"       // Brings in G+Smo and the UnitTest++ framework
+
+#include <gsStructuralAnalysis/src/gsEigenSolvers/gsModalSolver.h>
+#include <gsStructuralAnalysis/src/gsEigenSolvers/gsCraigBamptonSolver.h>
+
+SUITE(gsEigenSolver_test)                 // The suite should have the same name as the file
+{
+    gsSparseMatrix<real_t> Chain_stiffness(const index_t N);
+    gsSparseMatrix<real_t> Chain_mass(const index_t N);
+    // Eigenvalues of the chain in [lower,upper] from the dense solver, ascending
+    std::vector<real_t> Chain_eigenvalues(const index_t N, real_t lower, real_t upper);
+
+    // Modal solver of the chain, which exposes the number of stored factorizations
+    class Chain_solver : public gsModalSolver<real_t>
+    {
+    public:
+        Chain_solver(const index_t N) : gsModalSolver<real_t>(Chain_stiffness(N),Chain_mass(N)) { }
+        index_t factorizations() const { return m_factors.size(); }
+    };
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    TEST(EigenSolver_Chain_Subspace)
+    {
+        const index_t N = 30, number = 4;
+        std::vector<real_t> exact = Chain_eigenvalues(N,-1e10,1e10);
+        gsModalSolver<real_t> solver(Chain_stiffness(N),Chain_mass(N));
+
+        // Dense solver, all pairs and the pairs of smallest magnitude
+        CHECK(solver.compute()==gsStatus::Success);
+        CHECK_EQUAL(N,solver.values().rows());
+        CHECK(solver.compute(number)==gsStatus::Success);
+        CHECK_EQUAL(number,solver.values().rows());
+        for (index_t k = 0; k!=number; k++)
+            CHECK_CLOSE(exact[k],solver.value(k),1e-10);
+
+        // Sparse solvers, without the dense dispatch
+        solver.options().setInt("denseThreshold",0);
+        CHECK(solver.compute(number)==gsStatus::Success);
+        CHECK_EQUAL(number,solver.values().rows());
+        for (index_t k = 0; k!=number; k++)
+            CHECK_CLOSE(exact[k],solver.value(k),1e-8);
+
+        // Inverse iteration converges to the eigenvalue closest to the shift
+        const real_t shift = 0.9*exact[5] + 0.1*exact[6];
+        solver.options().setReal("shift",shift);
+        CHECK(solver.computePower()==gsStatus::Success);
+        CHECK_CLOSE(exact[5],solver.value(0),1e-8);
+        gsMatrix<real_t> residual = Chain_stiffness(N)*solver.vector(0) - solver.value(0)*(Chain_mass(N)*solver.vector(0));
+        CHECK_CLOSE(residual.norm(),0,1e-6);
+
+        // Subspace iteration gives the eigenvalues closest to the shift
+        CHECK(solver.computeSubspace(number)==gsStatus::Success);
+        std::vector<real_t> closest(exact), values(number);
+        std::sort(closest.begin(),closest.end(),[shift](real_t a, real_t b) { return math::abs(a-shift) < math::abs(b-shift); });
+        for (index_t k = 0; k!=number; k++)
+            values[k] = solver.value(k);
+        std::sort(closest.begin(),closest.begin()+number);
+        std::sort(values.begin(),values.end());
+        for (index_t k = 0; k!=number; k++)
+            CHECK_CLOSE(closest[k],values[k],1e-8);
+    }
+
+    TEST(EigenSolver_Chain_Factorizations)
+    {
+        const index_t N = 30, number = 3;
+        Chain_solver solver(N);
+        solver.options().setInt("factorizationCache",2);
+
+        const real_t shifts[] = {0.15, 1.05, 2.05, 0.15};
+        std::vector<gsMatrix<real_t>> values;
+        for (real_t shift : shifts)
+        {
+            solver.options().setReal("shift",shift);
+            CHECK(solver.computeSubspace(number)==gsStatus::Success);
+            values.push_back(solver.values());
+            CHECK(solver.factorizations() <= 2);
+        }
+        // The factorization of the first shift was removed and computed again
+        CHECK_CLOSE((values[0]-values[3]).norm(),0,1e-10);
+
+        // A stored factorization is reused, and gives the same pairs
+        solver.options().setInt("maxIt",1000);
+        CHECK(solver.computePower()==gsStatus::Success);
+        CHECK_EQUAL(2,solver.factorizations());
+        CHECK_CLOSE(values[3](0,0),solver.value(0),1e-8);
+    }
+
+    TEST(EigenSolver_Chain_LOBPCG)
+    {
+        const index_t N = 30, number = 4;
+        std::vector<real_t> exact = Chain_eigenvalues(N,-1e10,1e10);
+        const std::string preconditioners[] = {"None", "Jacobi", "IncompleteCholesky", "SimplicialLDLT"};
+        for (const std::string & preconditioner : preconditioners)
+        {
+            gsModalSolver<real_t> solver(Chain_stiffness(N),Chain_mass(N));
+            solver.options().setInt("maxIt",1000);
+            solver.options().setReal("tolerance",1e-8);
+            solver.options().setString("preconditioner",preconditioner);
+            CHECK(solver.computeLOBPCG(number)==gsStatus::Success);
+            for (index_t k = 0; k!=number; k++)
+                CHECK_CLOSE(exact[k],solver.value(k),1e-6);
+        }
+
+        // Mass matrices with alternating signs, or with one negative mass, have positive and negative
+        // eigenvalues. LOBPCG gives the smallest positive ones, as for buckling
+        typedef gsMatrix<real_t>::Base DenseMatrix;
+        for (index_t negative = 0; negative!=2; negative++)
+        {
+            gsSparseMatrix<real_t> K = Chain_stiffness(N), M = Chain_mass(N);
+            if (negative==0)
+                for (index_t i = 1; i < N; i += 2)
+                    M.coeffRef(i,i) *= -1;
+            else
+                M.coeffRef(N/2,N/2) *= -1;
+            DenseMatrix Kdense = K, Mdense = M;
+            gsEigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix> eigenSolver(Mdense,Kdense);
+            std::vector<real_t> positive;
+            for (index_t k = 0; k!=N; k++)
+                if (eigenSolver.eigenvalues()[k] > 0)
+                    positive.push_back(1/eigenSolver.eigenvalues()[k]);
+            std::sort(positive.begin(),positive.end());
+
+            for (index_t positiveB = -1; positiveB!=1; positiveB++)
+            {
+                gsModalSolver<real_t> solver(K,M);
+                solver.options().setInt("maxIt",1000);
+                solver.options().setReal("tolerance",1e-8);
+                solver.options().setInt("positiveB",positiveB);
+                CHECK(solver.computeLOBPCG(number)==gsStatus::Success);
+                for (index_t k = 0; k!=number; k++)
+                    CHECK_CLOSE(positive[k],solver.value(k),1e-6*positive[k]);
+            }
+        }
+    }
+
+    TEST(EigenSolver_Chain_Tracking)
+    {
+        const index_t N = 30, number = 4;
+        gsModalSolver<real_t> original(Chain_stiffness(N),Chain_mass(N));
+        CHECK(original.computeSubspace(number)==gsStatus::Success);
+        const gsMatrix<real_t> modes = original.vectors();
+        gsMatrix<real_t> mac = original.MAC(modes);
+        for (index_t k = 0; k!=number; k++)
+            CHECK_CLOSE(1,mac(k,k),1e-12);
+
+        // Started from their converged modes, the methods converge immediately
+        original.setInitialSubspace(modes);
+        original.options().setInt("maxIt",2);
+        CHECK(original.computeSubspace(number)==gsStatus::Success);
+        original.options().setInt("maxIt",1000);
+        original.options().setReal("tolerance",1e-8);
+        CHECK(original.computeLOBPCG(number)==gsStatus::Success);
+        original.setInitialSubspace(original.vectors());
+        original.options().setInt("maxIt",1);
+        CHECK(original.computeLOBPCG(number)==gsStatus::Success);
+
+        // The modes of the heavier chain are given in the order of the reversed initial subspace
+        gsSparseMatrix<real_t> M = Chain_mass(N);
+        M.coeffRef(N/3,N/3) *= 1.05;
+        gsModalSolver<real_t> heavier(Chain_stiffness(N),M);
+        heavier.options().setSwitch("trackModes",true);
+        const gsMatrix<real_t> reversed = modes.rowwise().reverse();
+        heavier.setInitialSubspace(reversed);
+        CHECK(heavier.computeSubspace(number)==gsStatus::Success);
+        CHECK_EQUAL(number,heavier.trackedMAC().rows());
+        for (index_t k = 0; k!=number; k++)
+        {
+            CHECK(heavier.trackedMAC()[k] > 0.99);
+            CHECK(heavier.vectors().col(k).dot(reversed.col(k)) > 0);
+            if (k > 0)
+                CHECK(heavier.value(k) < heavier.value(k-1));
+        }
+    }
+
+    TEST(EigenSolver_Chain_CraigBampton)
+    {
+        const index_t N = 30, number = 5;
+        std::vector<real_t> exact = Chain_eigenvalues(N,-1e10,1e10);
+        gsSparseMatrix<real_t> K = Chain_stiffness(N), M = Chain_mass(N);
+
+        std::vector<index_t> owner(N);
+        for (index_t i = 0; i!=N; i++)
+            owner[i] = 3*i/N;
+        std::vector<index_t> partition = gsCraigBamptonSolver<real_t>::partition(K,owner);
+        CHECK_EQUAL(2,(index_t)(std::count(partition.begin(),partition.end(),-1)));
+
+        // With all fixed-interface modes, the reduction is exact
+        gsCraigBamptonSolver<real_t> full(K,M,partition);
+        full.options().setInt("InteriorModes",N);
+        CHECK(full.compute(number)==gsStatus::Success);
+        CHECK_EQUAL(N,full.reducedStiffness().rows());
+        for (index_t k = 0; k!=number; k++)
+        {
+            CHECK_CLOSE(exact[k],full.value(k),1e-10);
+            gsMatrix<real_t> residual = K*full.vector(k) - full.value(k)*(M*full.vector(k));
+            CHECK_CLOSE(residual.norm()/full.vector(k).norm(),0,1e-8);
+        }
+
+        // With a few modes, the eigenvalues are upper bounds
+        gsCraigBamptonSolver<real_t> reduced(K,M,partition);
+        reduced.options().setInt("InteriorModes",4);
+        reduced.options().setSwitch("Recover",false);
+        CHECK(reduced.compute(number)==gsStatus::Success);
+        CHECK_EQUAL(3*4+2,reduced.vectors().rows());
+        for (index_t k = 0; k!=number; k++)
+        {
+            CHECK(reduced.value(k) >= exact[k]*(1-1e-12));
+            CHECK_CLOSE(exact[k],reduced.value(k),0.05*exact[k]);
+        }
+    }
+
+#ifdef gsSpectra_ENABLED
+    TEST(EigenSolver_Chain_Attempts)
+    {
+        const index_t N = 40, number = 4;
+        std::vector<real_t> exact = Chain_eigenvalues(N,-1e10,1e10);
+        gsModalSolver<real_t> solver(Chain_stiffness(N),Chain_mass(N));
+        solver.options().setInt("ncvFac",2);
+        solver.options().setInt("spectraMaxIt",1);
+        // The Krylov subspace of the last attempt spans the whole space
+        solver.options().setInt("maxAttempts",4);
+        CHECK(solver.computeSparse(number)==gsStatus::Success);
+        CHECK(solver.attempts() > 1);
+        CHECK_EQUAL(solver.attempts(),(index_t)(solver.attemptTimes().size()));
+
+        std::vector<real_t> values(number);
+        for (index_t k = 0; k!=number; k++)
+            values[k] = solver.value(k);
+        std::sort(values.begin(),values.end());
+        for (index_t k = 0; k!=number; k++)
+            CHECK_CLOSE(exact[k],values[k],1e-8);
+
+        CHECK_EQUAL(0,solver.options().getInt("solver"));
+        CHECK_EQUAL(2,solver.options().getInt("ncvFac"));
+        CHECK_EQUAL(4,solver.options().getInt("selectionRule"));
+        CHECK_EQUAL(0,solver.options().getReal("shift"));
+    }
+#endif
+
+    TEST(EigenSolver_Chain_Slicing)
+    {
+        // The slices contain different numbers of eigenvalues; the guard vectors of a slice
+        // may have Ritz values within the slice that did not converge
+        const real_t lower = 0.05, upper = 3.0;
+        for (index_t N = 25; N <= 40; N += 5)
+        {
+            gsModalSolver<real_t> solver(Chain_stiffness(N),Chain_mass(N));
+            std::vector<real_t> exact = Chain_eigenvalues(N,lower,upper);
+            for (index_t slices = 2; slices <= 6; slices++)
+            {
+                CHECK(solver.computeSlicing(lower,upper,slices)==gsStatus::Success);
+                gsMatrix<real_t> values = solver.values();
+                CHECK_EQUAL((index_t)(exact.size()),values.rows());
+                for (index_t k = 0; k!=std::min((index_t)(exact.size()),(index_t)(values.rows())); k++)
+                    CHECK_CLOSE(exact[k],values(k,0),1e-6);
+            }
+        }
+    }
+
+    gsSparseMatrix<real_t> Chain_stiffness(const index_t N)
+    {
+        // Chain of unit springs, clamped at both ends
+        gsSparseMatrix<real_t> K(N,N);
+        K.reserve(gsVector<index_t>::Constant(N,3));
+        for (index_t i = 0; i!=N; i++)
+        {
+            K.insert(i,i) = 2;
+            if (i > 0)   K.insert(i,i-1) = -1;
+            if (i < N-1) K.insert(i,i+1) = -1;
+        }
+        K.makeCompressed();
+        return K;
+    }
+
+    gsSparseMatrix<real_t> Chain_mass(const index_t N)
+    {
+        gsSparseMatrix<real_t> M(N,N);
+        M.reserve(gsVector<index_t>::Constant(N,1));
+        for (index_t i = 0; i!=N; i++)
+            M.insert(i,i) = 1 + 0.5*math::sin(real_t(i));
+        M.makeCompressed();
+        return M;
+    }
+
+    std::vector<real_t> Chain_eigenvalues(const index_t N, real_t lower, real_t upper)
+    {
+        typedef gsMatrix<real_t>::Base DenseMatrix;
+        DenseMatrix K = Chain_stiffness(N), M = Chain_mass(N);
+        gsEigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix> eigenSolver(K,M);
+        std::vector<real_t> values;
+        for (index_t k = 0; k!=N; k++)
+            if (eigenSolver.eigenvalues()[k] >= lower && eigenSolver.eigenvalues()[k] <= upper)
+                values.push_back(eigenSolver.eigenvalues()[k]);
+        return values;
+    }
+
+}
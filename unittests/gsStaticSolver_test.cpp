@@ -11,6 +11,25 @@
     * Modal:   unit-test based on a modal analysis
                This test allows to test the mass matrix and the compressible material model
 
+    * Cubic:   unit-test based on a chain of springs with a cubic hardening term at every node.
+               This test allows to test the Newton solver with a fused residual and Jacobian operator,
+               and the reuse of the symbolic factorization when the sparsity pattern is stable
+
+    * Softening: unit-test based on uncoupled springs with a negative linear stiffness and a cubic hardening term,
+                 with three equilibria per spring.
+                 This test allows to test that the deflated Newton solver finds distinct equilibria,
+                 independently of the number of threads, and never the deflated ones
+
+    * Limit:   unit-test based on a single spring with a softening internal force, which has a limit point.
+               This test allows to test that the bisection method for singular points is not affected by
+               speculative steps, i.e. that the workers are not used and that the singular point is the same as without them
+
+    * Chain:   unit-test based on a chain of unit springs, clamped at the first node, solved with Dynamic Relaxation.
+               This test checks the single-precision solver, including the accumulation of the
+               residual norm and kinetic energy in double precision.
+               It also checks that a residual bound at compile time (template parameter ResidualOp)
+               gives the same solution as the default std::function residual
+
 
     == BASIC REFERENCE ==
          - TEST(NAME_OF_TEST) { body_of_test }
@@ -46,9 +65,13 @@
 #endif
 
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticDR.h>
+// Only the default residual type of gsStaticDR is instantiated in the library
+#include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticDR.hpp>
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticNewton.h>
+#include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticDeflatedNewton.h>
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticOpt.h>
 #include <gsStructuralAnalysis/src/gsStaticSolvers/gsStaticComposite.h>
+#include <gsStructuralAnalysis/src/gsALMSolvers/gsALMCrisfield.h>
 
 SUITE(gsStaticSolver_test)                 // The suite should have the same name as the file
 {
@@ -59,9 +82,248 @@ SUITE(gsStaticSolver_test)                 // The suite should have the same nam
     std::pair<real_t,real_t> UAT_numerical(const std::vector<index_t> solver, const index_t material=1, const index_t impl=1, const bool Compressibility=false);
     void UAT_CHECK(const std::vector<index_t> solver, const index_t material=1, const index_t impl=1, const bool Compressibility=false);
 #endif
+    gsSparseMatrix<real_t> Cubic_stiffness(const index_t N);
+    // Residual F - K x - x^3 and its Jacobian K + 3 x^2
+    void Cubic_residual(const gsSparseMatrix<real_t> & K, const gsVector<real_t> & F, const gsVector<real_t> & x, gsVector<real_t> & R);
+    void Cubic_jacobian(const gsSparseMatrix<real_t> & K, const gsVector<real_t> & x, gsSparseMatrix<real_t> & m);
+    template<class T> gsSparseMatrix<T> Chain_stiffness(const index_t N);
+    template<class T> gsVector<T> Chain_DR(const index_t N=12);
+    template<class T, class ResidualOp> gsVector<T> Chain_DR(const gsVector<T> & F, const ResidualOp & Residual);
+    // Computes the limit point of the spring with internal force u - 3/2 u^2 + 1/2 u^3 with the bisection method
+    // and returns the number of calls of the operators of the workers during the bisection method
+    gsStatus Limit_singularPoint(const bool speculative, gsVector<real_t> & U, real_t & L, real_t & length, index_t & workerCalls);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    TEST(StaticSolver_Cubic_Fused)
+    {
+        const index_t N = 10;
+        gsSparseMatrix<real_t> K = Cubic_stiffness(N);
+        gsVector<real_t> F(N);
+        F.setOnes();
+
+        index_t jacobians = 0, residuals = 0, fused = 0;
+        gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian = [&](gsVector<real_t> const & x, gsSparseMatrix<real_t> & m)
+        {
+            jacobians++;
+            Cubic_jacobian(K,x,m);
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Residual_t Residual = [&](gsVector<real_t> const & x, gsVector<real_t> & R)
+        {
+            residuals++;
+            Cubic_residual(K,F,x,R);
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::ResidualJacobian_t ResidualJacobian = [&](gsVector<real_t> const & x, gsVector<real_t> & R, gsSparseMatrix<real_t> & m)
+        {
+            fused++;
+            Cubic_residual(K,F,x,R);
+            Cubic_jacobian(K,x,m);
+            return true;
+        };
+
+        gsStaticNewton<real_t> separate(K,F,Jacobian,Residual);
+        separate.options().setInt("verbose",0);
+        separate.initialize();
+        CHECK(separate.solve()==gsStatus::Success);
+
+        gsStaticNewton<real_t> combined(K,F,ResidualJacobian);
+        combined.options().setInt("verbose",0);
+        combined.initialize();
+        CHECK(combined.solve()==gsStatus::Success);
+
+        // The fused operator is called once for every residual, and never for the Jacobian only
+        CHECK(jacobians > 0);
+        CHECK_EQUAL(residuals,fused);
+        CHECK_EQUAL(separate.iterations(),combined.iterations());
+        CHECK_CLOSE((separate.solution()-combined.solution()).norm(),0,1e-12);
+    }
+
+    TEST(StaticSolver_Cubic_PatternStable)
+    {
+        const index_t N = 10;
+        gsSparseMatrix<real_t> K = Cubic_stiffness(N);
+        gsVector<real_t> F(N);
+        F.setOnes();
+
+        index_t jacobians = 0, inPlace = 0;
+        const real_t * values = nullptr;
+        gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian = [&](gsVector<real_t> const & x, gsSparseMatrix<real_t> & m)
+        {
+            jacobians++;
+            if (m.nonZeros()!=0 && m.valuePtr()==values)
+                inPlace++;
+            gsSparseMatrix<real_t> J;
+            Cubic_jacobian(K,x,J);
+            gsSparsityPattern<real_t>::overwriteValues(J,m);
+            values = m.valuePtr();
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Residual_t Residual = [&](gsVector<real_t> const & x, gsVector<real_t> & R)
+        {
+            Cubic_residual(K,F,x,R);
+            return true;
+        };
+
+        gsStaticNewton<real_t> plain(K,F,Jacobian,Residual);
+        plain.options().setInt("verbose",0);
+        plain.options().setString("Solver","SimplicialLDLT");
+        plain.initialize();
+        CHECK(plain.solve()==gsStatus::Success);
+        // Without PatternStable, the matrix is cleared before every Jacobian
+        CHECK_EQUAL(0,inPlace);
+        CHECK_EQUAL(0,plain.pattern().symbolicFactorizations()+plain.pattern().numericFactorizations());
+
+        jacobians = 0;
+        values = nullptr;
+        gsStaticNewton<real_t> stable(K,F,Jacobian,Residual);
+        stable.options().setInt("verbose",0);
+        stable.options().setString("Solver","SimplicialLDLT");
+        stable.options().setSwitch("PatternStable",true);
+        stable.initialize();
+        CHECK(stable.solve()==gsStatus::Success);
+
+        // The first Jacobian is analyzed, the next ones are assembled in its memory and only factorized numerically
+        CHECK(jacobians > 1);
+        CHECK_EQUAL(jacobians-1,inPlace);
+        CHECK_EQUAL(1,stable.pattern().symbolicFactorizations());
+        CHECK_EQUAL(jacobians-1,stable.pattern().numericFactorizations());
+        CHECK_EQUAL(plain.iterations(),stable.iterations());
+        CHECK_CLOSE((plain.solution()-stable.solution()).norm(),0,1e-12);
+    }
+
+    TEST(StaticSolver_Softening_Deflated)
+    {
+        // x^3 - 3 x = 0.5 has three roots for every spring, hence 9 equilibria
+        const index_t N = 2;
+        gsSparseMatrix<real_t> K(N,N);
+        K.setIdentity();
+        K *= -3;
+        gsVector<real_t> F = gsVector<real_t>::Constant(N,0.5);
+
+        gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian = [&](gsVector<real_t> const & x, gsSparseMatrix<real_t> & m)
+        {
+            Cubic_jacobian(K,x,m);
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Residual_t Residual = [&](gsVector<real_t> const & x, gsVector<real_t> & R)
+        {
+            Cubic_residual(K,F,x,R);
+            return true;
+        };
+
+        std::vector<std::vector<gsVector<real_t>>> solutions;
+        for (index_t threads = 1; threads <= 4; threads += 3)
+        {
+            gsStaticDeflatedNewton<real_t> solver(K,F,Jacobian,Residual);
+            solver.options().setInt("verbose",0);
+            solver.options().setInt("Searches",8);
+            solver.options().setInt("Rounds",4);
+            solver.options().setInt("Threads",threads);
+            solver.options().setSwitch("ThreadSafe",true);
+            CHECK(solver.solve()==gsStatus::Success);
+            solutions.push_back(solver.solutions());
+        }
+
+        // The perturbations and the merge do not depend on the number of threads
+        CHECK(solutions[0].size() > 2);
+        CHECK_EQUAL(solutions[0].size(),solutions[1].size());
+        for (size_t k = 0; k!=std::min(solutions[0].size(),solutions[1].size()); k++)
+            CHECK(solutions[0][k]==solutions[1][k]);
+
+        gsVector<real_t> R;
+        for (size_t k = 0; k!=solutions[0].size(); k++)
+        {
+            Cubic_residual(K,F,solutions[0][k],R);
+            CHECK_CLOSE(R.norm(),0,1e-8);
+            for (size_t l = 0; l!=k; l++)
+                CHECK((solutions[0][k]-solutions[0][l]).norm() > 1e-3);
+        }
+
+        // The known equilibria are deflated from the start
+        const size_t known = 3;
+        gsStaticDeflatedNewton<real_t> solver(K,F,Jacobian,Residual);
+        solver.options().setInt("verbose",0);
+        for (size_t k = 0; k!=known; k++)
+            solver.addKnownSolution(solutions[0][k]);
+        CHECK(solver.solve()==gsStatus::Success);
+        CHECK(solver.numSolutions() > 0);
+        for (index_t k = 0; k!=solver.numSolutions(); k++)
+            for (size_t l = 0; l!=known; l++)
+                CHECK((solver.solutions()[k]-solutions[0][l]).norm() > 1e-3);
+
+        // Without load, the trivial root is an equilibrium, on which the update is not relative to the solution
+        F.setZero();
+        gsStaticDeflatedNewton<real_t> unloaded(K,F,Jacobian,Residual);
+        unloaded.options().setInt("verbose",0);
+        CHECK(unloaded.solve()==gsStatus::Success);
+        bool trivial = false;
+        for (index_t k = 0; k!=unloaded.numSolutions(); k++)
+            trivial = trivial || unloaded.solutions()[k].norm() < 1e-8;
+        CHECK(trivial);
+    }
+
+    TEST(StaticSolver_Limit_Speculative)
+    {
+        // The limit point is at u = 1 - 1/sqrt(3)
+        const real_t Ucrit = 1 - 1/math::sqrt((real_t)(3));
+        const real_t Lcrit = Ucrit - 1.5*Ucrit*Ucrit + 0.5*Ucrit*Ucrit*Ucrit;
+
+        gsVector<real_t> Userial, Uspeculative;
+        real_t Lserial, Lspeculative, lengthSerial, lengthSpeculative;
+        index_t callsSerial, callsSpeculative;
+        CHECK(Limit_singularPoint(false,Userial,Lserial,lengthSerial,callsSerial)==gsStatus::Success);
+        CHECK(Limit_singularPoint(true,Uspeculative,Lspeculative,lengthSpeculative,callsSpeculative)==gsStatus::Success);
+
+        CHECK_CLOSE(Ucrit,Userial[0],1e-6);
+        CHECK_CLOSE(Lcrit,Lserial,1e-8);
+        // The bisection steps are not taken speculatively, hence the results are equal and the arc-length is restored
+        CHECK_EQUAL(0,callsSerial);
+        CHECK_EQUAL(0,callsSpeculative);
+        CHECK_EQUAL(Userial[0],Uspeculative[0]);
+        CHECK_EQUAL(Lserial,Lspeculative);
+        CHECK_EQUAL(lengthSerial,lengthSpeculative);
+    }
+
+    TEST(StaticSolver_Chain_DR)
+    {
+        const index_t N = 12;
+        gsVector<double> Udouble = Chain_DR<double>(N);
+        gsVector<double> Ufloat  = Chain_DR<float>(N).cast<double>();
+
+        // Exact solution
+        gsSparseMatrix<double> K = Chain_stiffness<double>(N);
+        gsVector<double> F(N);
+        F.setOnes();
+        gsSparseSolver<double>::LU solver(K);
+        gsVector<double> Uexact = solver.solve(F);
+
+        CHECK_CLOSE((Udouble-Uexact).norm()/Uexact.norm(),0,1e-3);
+        CHECK_CLOSE((Ufloat-Udouble).norm()/Udouble.norm(),0,1e-3);
+    }
+
+    TEST(StaticSolver_Chain_DR_ResidualOp)
+    {
+        const index_t N = 12;
+        gsSparseMatrix<real_t> K = Chain_stiffness<real_t>(N);
+        gsVector<real_t> F(N);
+        F.setOnes();
+
+        auto residual = [&K,&F](gsVector<real_t> const & x, gsVector<real_t> & result)
+        {
+            result = F - K*x;
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Residual_t Residual = residual;
+
+        // The same operations are performed, hence the solutions are equal
+        gsVector<real_t> Uinlined = Chain_DR<real_t>(F,residual);
+        gsVector<real_t> Udefault = Chain_DR<real_t>(F,Residual);
+        CHECK(Udefault.norm() > 0);
+        CHECK_EQUAL(0,(Uinlined-Udefault).norm());
+    }
+
 #ifdef gsKLShell_ENABLED
     TEST(StaticSolver_UAT_NR)
     {
@@ -416,4 +678,155 @@ SUITE(gsStaticSolver_test)                 // The suite should have the same nam
     }
 #endif
 
+    gsSparseMatrix<real_t> Cubic_stiffness(const index_t N)
+    {
+        // Chain of unit springs, clamped at both ends
+        gsSparseMatrix<real_t> K(N,N);
+        K.reserve(gsVector<index_t>::Constant(N,3));
+        for (index_t i = 0; i!=N; i++)
+        {
+            K.insert(i,i) = 2;
+            if (i > 0)   K.insert(i,i-1) = -1;
+            if (i < N-1) K.insert(i,i+1) = -1;
+        }
+        K.makeCompressed();
+        return K;
+    }
+
+    void Cubic_residual(const gsSparseMatrix<real_t> & K, const gsVector<real_t> & F, const gsVector<real_t> & x, gsVector<real_t> & R)
+    {
+        R = F - K*x - x.cwiseProduct(x).cwiseProduct(x);
+    }
+
+    void Cubic_jacobian(const gsSparseMatrix<real_t> & K, const gsVector<real_t> & x, gsSparseMatrix<real_t> & m)
+    {
+        m = K;
+        for (index_t i = 0; i!=x.rows(); i++)
+            m.coeffRef(i,i) += 3*x[i]*x[i];
+    }
+
+    template<class T>
+    gsSparseMatrix<T> Chain_stiffness(const index_t N)
+    {
+        // Chain of unit springs, clamped at the first node
+        gsSparseMatrix<T> K(N,N);
+        K.reserve(gsVector<index_t>::Constant(N,3));
+        for (index_t i = 0; i!=N; i++)
+        {
+            K.insert(i,i) = (i==N-1) ? 1 : 2;
+            if (i > 0)   K.insert(i,i-1) = -1;
+            if (i < N-1) K.insert(i,i+1) = -1;
+        }
+        K.makeCompressed();
+        return K;
+    }
+
+    template<class T>
+    gsVector<T> Chain_DR(const index_t N)
+    {
+        gsSparseMatrix<T> K = Chain_stiffness<T>(N);
+        gsVector<T> F(N);
+        F.setOnes();
+
+        // Residual Fext - Fint
+        typename gsStructuralAnalysisOps<T>::Residual_t Residual = [&K,&F](gsVector<T> const & x, gsVector<T> & result)
+        {
+            result = F - K*x;
+            return true;
+        };
+        return Chain_DR<T>(F,Residual);
+    }
+
+    template<class T, class ResidualOp>
+    gsVector<T> Chain_DR(const gsVector<T> & F, const ResidualOp & Residual)
+    {
+        gsVector<T> M(F.rows());
+        M.setOnes();
+
+        gsStaticDR<T,ResidualOp> DRM(M,F,Residual);
+        gsOptionList DROptions = DRM.options();
+        DROptions.setReal("damping",0.5);
+        DROptions.setReal("alpha",2.0);
+        DROptions.setInt("maxIt",100000);
+        DROptions.setReal("tolF",1e-4);
+        DROptions.setReal("tolU",1e-4);
+        DROptions.setReal("tolE",1e-6);
+        DROptions.setInt("verbose",0);
+        DRM.setOptions(DROptions);
+        DRM.initialize();
+        DRM.solve();
+        CHECK(DRM.status() == gsStatus::Success);
+
+        return DRM.solution();
+    }
+
+    gsStatus Limit_singularPoint(const bool speculative, gsVector<real_t> & U, real_t & L, real_t & length, index_t & workerCalls)
+    {
+        gsVector<real_t> F(1);
+        F.setOnes();
+
+        // Every solver gets its own operators, which count their calls
+        index_t calls[3] = {0,0,0};
+        std::vector<gsStructuralAnalysisOps<real_t>::Jacobian_t> Jacobian(3);
+        std::vector<gsStructuralAnalysisOps<real_t>::ALResidual_t> ALResidual(3);
+        for (index_t k = 0; k!=3; k++)
+        {
+            Jacobian[k] = [&calls,k](gsVector<real_t> const & x, gsSparseMatrix<real_t> & m)
+            {
+                calls[k]++;
+                m.resize(1,1);
+                m.insert(0,0) = 1 - 3*x[0] + 1.5*x[0]*x[0];
+                m.makeCompressed();
+                return true;
+            };
+            ALResidual[k] = [&calls,&F,k](gsVector<real_t> const & x, real_t lambda, gsVector<real_t> & result)
+            {
+                calls[k]++;
+                // Internal force minus external force
+                result = -lambda*F;
+                result[0] += x[0] - 1.5*x[0]*x[0] + 0.5*x[0]*x[0]*x[0];
+                return true;
+            };
+        }
+
+        gsALMCrisfield<real_t> arcLength(Jacobian[0],ALResidual[0],F);
+        gsALMCrisfield<real_t> worker1(Jacobian[1],ALResidual[1],F), worker2(Jacobian[2],ALResidual[2],F);
+        std::vector<gsALMBase<real_t> *> workers = {&worker1,&worker2};
+        arcLength.setWorkers(workers);
+
+        arcLength.options().setString("Solver","SimplicialLDLT");
+        arcLength.options().setInt("BifurcationMethod",0); // 0: determinant, 1: eigenvalue
+        arcLength.options().setReal("Length",0.05);
+        arcLength.options().setReal("SingularPointComputeTolB",1e-3);
+        arcLength.options().setReal("SingularPointComputeTolE",1e-10);
+        arcLength.options().setSwitch("Speculative",speculative);
+        arcLength.options().setSwitch("Verbose",false);
+        arcLength.applyOptions();
+        arcLength.initialize();
+
+        gsVector<real_t> Uold = gsVector<real_t>::Zero(1);
+        real_t Lold = 0;
+        for (index_t k = 0; k!=20; k++)
+        {
+            gsStatus status = arcLength.step();
+            if (status!=gsStatus::Success)
+                return status;
+            arcLength.computeStability(false);
+            if (arcLength.stabilityChange())
+            {
+                // The point is a limit point, hence the singular point test is skipped
+                workerCalls = calls[1] + calls[2];
+                status = arcLength.computeSingularPoint(Uold,Lold,false,false,false);
+                workerCalls = calls[1] + calls[2] - workerCalls;
+                U = arcLength.solutionU();
+                L = arcLength.solutionL();
+                length = arcLength.getLength();
+                return status;
+            }
+            Uold = arcLength.solutionU();
+            Lold = arcLength.solutionL();
+        }
+        return gsStatus::NotConverged;
+    }
+
 }
@@ -0,0 +1,341 @@
+/** @file gsStructuralAnalysisTools_test.cpp
+
+    @brief Provides unittests for the linear algebra tools of the structural analysis solvers
+
+    * RecyclingCG: unit-test based on a chain of springs on an elastic foundation, solved twice
+                   with the recycling CG solver with 1 and 4 kernel threads.
+                   This test checks that the solutions are bitwise identical for any number of threads,
+                   and that nonsymmetric matrices are rejected
+
+    * Kernels:     unit-test based on vectors of several chunks of the parallel kernels.
+                   This test checks that the norms and dot products are bitwise identical for any number
+                   of threads, i.e. for the serial and the parallel reductions
+
+    * BlockSparse: unit-test based on the same chain, where two nodes miss a component.
+                   This test checks the products in the block format with the node and
+                   component maps, and that the size is checked for the block layouts
+
+    * Cache:       unit-test based on the same chain, with the operators wrapped by a cache of two states.
+                   This test checks the hits, the misses on another state or load factor, and the
+                   eviction of the oldest state
+
+    * Recorder:    unit-test based on the same chain, with the operators recorded to a log and served back.
+                   This test checks the residuals and Jacobians of the replay in both modes, the
+                   Jacobians on the solution update, the shared patterns, and that a truncated log is rejected
+
+
+    == BASIC REFERENCE ==
+         - TEST(NAME_OF_TEST) { body_of_test }
+         - TEST_FIXTURE(NAME_OF_FIXTURE,NAME_OF_TEST){ body_of_test }
+
+    == CHECK MACRO REFERENCE ==
+         - CHECK(EXPR);
+         - CHECK_EQUAL(EXPECTED,ACTUAL);
+         - CHECK_CLOSE(EXPECTED,ACTUAL,EPSILON);
+         - CHECK_ARRAY_EQUAL(EXPECTED,ACTUAL,LENGTH);
+         - CHECK_ARRAY_CLOSE(EXPECTED,ACTUAL,LENGTH,EPSILON);
+         - CHECK_ARRAY2D_EQUAL(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT);
+         - CHECK_ARRAY2D_CLOSE(EXPECTED,ACTUAL,ROWCOUNT,COLCOUNT,EPSILON);
+         - CHECK_THROW(EXPR,EXCEPTION_TYPE_EXPECTED);
+
+    == TIME CONSTRAINTS ==
+         - UNITTEST_TIME_CONSTRAINT(TIME_IN_MILLISECONDS);
+         - UNITTEST_TIME_CONSTRAINT_EXEMPT();
+
+    == MORE INFO ==
+         See: https://unittest-cpp.github.io/
+
+    Author(s): H.M.Verhelst (2019 - ..., TU Delft)
+ **/
+
+#include "gismo_unittest.h"       // Brings in G+Smo and the UnitTest++ framework
+
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsBlockSparseMatrix.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsRecyclingCG.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisCache.h>
+#include <gsStructuralAnalysis/src/gsStructuralAnalysisTools/gsStructuralAnalysisRecorder.h>
+
+SUITE(gsStructuralAnalysisTools_test)                 // The suite should have the same name as the file
+{
+    // The size spans several chunks of the kernels, the last one incomplete
+    const index_t Foundation_size = 3*gsParallelKernels<real_t>::ChunkSize + 7;
+
+    gsSparseMatrix<real_t> Foundation_stiffness(const index_t N);
+    gsVector<real_t> Foundation_force(const index_t N);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    TEST(RecyclingCG_Threads)
+    {
+        gsSparseMatrix<real_t> K = Foundation_stiffness(Foundation_size);
+        gsVector<real_t> F = Foundation_force(Foundation_size);
+
+        std::vector<gsVector<real_t> > solutions;
+        std::vector<index_t> iterations;
+        for (index_t numThreads = 1; numThreads <= 4; numThreads += 3)
+        {
+            gsRecyclingCG<real_t> solver(3);
+            solver.setTolerance(1e-10);
+            solver.setNumThreads(numThreads);
+            solver.compute(K);
+            CHECK(solver.info()==gsEigen::ComputationInfo::Success);
+            // The second solve starts from the recycled subspace of the first one
+            for (index_t k = 0; k!=2; k++)
+            {
+                solutions.push_back(solver.solve(real_t(k+1)*F));
+                iterations.push_back(solver.iterations());
+                CHECK(solver.info()==gsEigen::ComputationInfo::Success);
+            }
+        }
+
+        for (index_t k = 0; k!=2; k++)
+        {
+            CHECK(solutions[k]==solutions[2+k]);
+            CHECK_EQUAL(iterations[k],iterations[2+k]);
+            CHECK_CLOSE((K*solutions[k] - real_t(k+1)*F).norm()/(real_t(k+1)*F).norm(),0,1e-8);
+        }
+    }
+
+    TEST(RecyclingCG_Nonsymmetric)
+    {
+        gsSparseMatrix<real_t> K = Foundation_stiffness(Foundation_size);
+        K.coeffRef(0,1) += 1;
+
+        gsRecyclingCG<real_t> solver;
+        solver.setNumThreads(4);
+        solver.compute(K);
+        CHECK(solver.info()==gsEigen::ComputationInfo::InvalidInput);
+    }
+
+    TEST(ParallelKernels_Threads)
+    {
+        // Up to 13 chunks, such that the tree of the reduction is not balanced
+        const index_t sizes[] = {0, 7, gsParallelKernels<real_t>::ChunkSize, Foundation_size, 13*gsParallelKernels<real_t>::ChunkSize + 3};
+        for (index_t n : sizes)
+        {
+            gsVector<real_t> x = Foundation_force(n);
+            gsVector<real_t> y = x.array().cos();
+            gsParallelKernels<real_t> serial(1);
+            for (index_t numThreads = 2; numThreads <= 4; numThreads++)
+            {
+                gsParallelKernels<real_t> parallel(numThreads);
+                CHECK(serial.norm(x)==parallel.norm(x));
+                CHECK(serial.squaredNorm(x)==parallel.squaredNorm(x));
+                CHECK(serial.dot(x,y)==parallel.dot(x,y));
+            }
+            CHECK_CLOSE(serial.norm(x),x.norm(),1e-10);
+            CHECK_CLOSE(serial.dot(x,y),x.dot(y),1e-10);
+        }
+    }
+
+    TEST(BlockSparseMatrix_Map)
+    {
+        // 3 components on 20 nodes, where node 3 has no second and node 7 no third component
+        const index_t nodes = 20;
+        gsVector<index_t> node(3*nodes-2), comp(3*nodes-2);
+        index_t i = 0;
+        for (index_t I = 0; I!=nodes; I++)
+            for (index_t d = 0; d!=3; d++)
+                if (!(I==3 && d==1) && !(I==7 && d==2))
+                {
+                    node[i] = I;
+                    comp[i] = d;
+                    i++;
+                }
+
+        gsSparseMatrix<real_t> K = Foundation_stiffness(i);
+        gsVector<real_t> F = Foundation_force(i);
+
+        gsBlockSparseMatrix<real_t> block;
+        CHECK(!block.assign(K,false));
+        CHECK(block.assign(K,node,comp));
+        CHECK_EQUAL(block.nodes(),nodes);
+        CHECK_CLOSE((block*F - K*F).norm(),0,1e-12);
+        CHECK_CLOSE((block.toSparse() - K).norm(),0,1e-12);
+    }
+
+    TEST(StructuralAnalysisCache_Capacity)
+    {
+        const index_t N = 10;
+        gsSparseMatrix<real_t> K = Foundation_stiffness(N);
+        gsVector<real_t> F = Foundation_force(N);
+
+        index_t residuals = 0, jacobians = 0;
+        gsStructuralAnalysisOps<real_t>::ALResidual_t ALResidual = [&](gsVector<real_t> const & x, const real_t L, gsVector<real_t> & R)
+        {
+            residuals++;
+            R = L*F - K*x;
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian = [&](gsVector<real_t> const &, gsSparseMatrix<real_t> & m)
+        {
+            jacobians++;
+            m = K;
+            return true;
+        };
+
+        gsStructuralAnalysisCache<real_t> cache(2);
+        gsStructuralAnalysisOps<real_t>::ALResidual_t cachedResidual = cache.ALResidual(ALResidual);
+        gsStructuralAnalysisOps<real_t>::Jacobian_t cachedJacobian = cache.jacobian(Jacobian);
+
+        std::vector<gsVector<real_t> > x(3);
+        for (index_t k = 0; k!=3; k++)
+            x[k] = real_t(k+1)*F;
+
+        // Hit on the same state and load factor
+        gsVector<real_t> R, Rref;
+        gsSparseMatrix<real_t> m;
+        CHECK(cachedResidual(x[0],1,R));
+        CHECK(cachedResidual(x[0],1,Rref));
+        CHECK(R==Rref);
+        CHECK(cachedJacobian(x[0],m));
+        CHECK(cachedJacobian(x[0],m));
+        CHECK_CLOSE((m-K).norm(),0,1e-12);
+        CHECK_EQUAL(1,residuals);
+        CHECK_EQUAL(1,jacobians);
+        CHECK_EQUAL(2,cache.hits());
+        CHECK_EQUAL(2,cache.misses());
+
+        // Miss on another load factor
+        CHECK(cachedResidual(x[0],2,R));
+        CHECK_EQUAL(2,residuals);
+
+        // The third state evicts the first one, the second one stays
+        CHECK(cachedResidual(x[1],1,R));
+        CHECK(cachedResidual(x[2],1,R));
+        CHECK_EQUAL(4,residuals);
+        CHECK(cachedResidual(x[1],1,R));
+        CHECK_EQUAL(4,residuals);
+        CHECK(cachedResidual(x[0],2,R));
+        CHECK_EQUAL(5,residuals);
+        CHECK_CLOSE((R - (2*F - K*x[0])).norm(),0,1e-12);
+    }
+
+    TEST(StructuralAnalysisRecorder_RoundTrip)
+    {
+        const index_t N = 10;
+        const std::string filename = "gsStructuralAnalysisRecorder_test.log";
+        gsSparseMatrix<real_t> K = Foundation_stiffness(N);
+        gsVector<real_t> F = Foundation_force(N);
+
+        // The Jacobian on the update has the pattern of K, the last Jacobian has another pattern
+        gsSparseMatrix<real_t> Kextra = K;
+        Kextra.coeffRef(0,N-1) = 1;
+        Kextra.makeCompressed();
+        gsStructuralAnalysisOps<real_t>::ALResidual_t ALResidual = [&](gsVector<real_t> const & x, const real_t L, gsVector<real_t> & R)
+        {
+            R = L*F - K*x;
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::Jacobian_t Jacobian = [&](gsVector<real_t> const & x, gsSparseMatrix<real_t> & m)
+        {
+            m = x[0] > 1 ? Kextra : K;
+            return true;
+        };
+        gsStructuralAnalysisOps<real_t>::dJacobian_t dJacobian = [&](gsVector<real_t> const &, gsVector<real_t> const & dx, gsSparseMatrix<real_t> & m)
+        {
+            m = K;
+            for (index_t i = 0; i!=N; i++)
+                m.coeffRef(i,i) += dx[i];
+            return true;
+        };
+
+        gsVector<real_t> x0 = gsVector<real_t>::Zero(N), x1 = F, x2 = 2*gsVector<real_t>::Ones(N);
+        gsVector<real_t> dx0 = F, dx1 = 2*F;
+        gsVector<real_t> R;
+        gsSparseMatrix<real_t> m;
+        {
+            gsStructuralAnalysisRecorder<real_t> recorder(filename);
+            gsStructuralAnalysisOps<real_t>::ALResidual_t recordedResidual = recorder.ALResidual(ALResidual);
+            gsStructuralAnalysisOps<real_t>::Jacobian_t recordedJacobian = recorder.jacobian(Jacobian);
+            gsStructuralAnalysisOps<real_t>::dJacobian_t recordedDJacobian = recorder.dJacobian(dJacobian);
+            CHECK(recordedResidual(x0,1,R));
+            CHECK(recordedJacobian(x0,m));
+            CHECK(recordedResidual(x1,2,R));
+            CHECK(recordedDJacobian(x1,dx0,m));
+            CHECK(recordedDJacobian(x1,dx1,m));
+            CHECK(recordedJacobian(x1,m));
+            CHECK(recordedJacobian(x2,m));
+            CHECK_EQUAL(7,recorder.records());
+        }
+
+        gsStructuralAnalysisReplay<real_t> replay(filename,gsStructuralAnalysisReplay<real_t>::ByState);
+        CHECK_EQUAL(7,replay.records());
+        CHECK_EQUAL(2,replay.patterns());
+        CHECK(replay.state(2)==x1);
+        gsVector<real_t> Rref;
+        CHECK(ALResidual(x1,2,Rref));
+        CHECK(replay.residual(2)==Rref);
+        CHECK_EQUAL(0,replay.jacobian(0).nonZeros());
+        CHECK(replay.jacobian(6).isApprox(Kextra));
+
+        gsStructuralAnalysisOps<real_t>::ALResidual_t replayedResidual = replay.ALResidual();
+        gsStructuralAnalysisOps<real_t>::Jacobian_t replayedJacobian = replay.jacobian();
+        gsStructuralAnalysisOps<real_t>::dJacobian_t replayedDJacobian = replay.dJacobian();
+        gsSparseMatrix<real_t> mref;
+
+        // By state, the Jacobians on the update are keyed on the state and the update.
+        // Another update falls back to the Jacobian without update
+        CHECK(replayedResidual(x1,2,R));
+        CHECK(R==Rref);
+        CHECK(!replayedResidual(x1,1,R));
+        CHECK(replayedDJacobian(x1,dx0,m));
+        CHECK(dJacobian(x1,dx0,mref));
+        CHECK((m-mref).norm()==0);
+        CHECK(replayedDJacobian(x1,dx1,m));
+        CHECK(dJacobian(x1,dx1,mref));
+        CHECK((m-mref).norm()==0);
+        CHECK(replayedDJacobian(x1,3*F,m));
+        CHECK((m-K).norm()==0);
+        CHECK(replayedJacobian(x1,m));
+        CHECK((m-K).norm()==0);
+        CHECK(replayedJacobian(x2,m));
+        CHECK((m-Kextra).norm()==0);
+
+        // In sequence, the Jacobians are served in their order, whatever the arguments
+        replay.setMode(gsStructuralAnalysisReplay<real_t>::Sequential);
+        replay.rewind();
+        CHECK(replayedJacobian(x2,m));
+        CHECK((m-K).norm()==0);
+        CHECK(replayedJacobian(x2,m));
+        CHECK(dJacobian(x1,dx0,mref));
+        CHECK((m-mref).norm()==0);
+        CHECK(replayedResidual(x2,1,R));
+        CHECK(ALResidual(x0,1,Rref));
+        CHECK(R==Rref);
+
+        // A truncated log is rejected
+        std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+        std::string log((std::istreambuf_iterator<char>(in)),std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(log.data(),log.size()-5);
+        out.close();
+        CHECK_THROW(gsStructuralAnalysisReplay<real_t> truncated(filename),std::exception);
+        std::remove(filename.c_str());
+    }
+
+    gsSparseMatrix<real_t> Foundation_stiffness(const index_t N)
+    {
+        // Chain of unit springs, with a unit spring to the ground at every node
+        gsSparseMatrix<real_t> K(N,N);
+        K.reserve(gsVector<index_t>::Constant(N,3));
+        for (index_t i = 0; i!=N; i++)
+        {
+            K.insert(i,i) = (i==0 || i==N-1) ? 2 : 3;
+            if (i > 0)   K.insert(i,i-1) = -1;
+            if (i < N-1) K.insert(i,i+1) = -1;
+        }
+        K.makeCompressed();
+        return K;
+    }
+
+    gsVector<real_t> Foundation_force(const index_t N)
+    {
+        gsVector<real_t> F(N);
+        for (index_t i = 0; i!=N; i++)
+            F[i] = math::sin(real_t(i));
+        return F;
+    }
+
+}